@@ -0,0 +1,127 @@
+/// @file lex_dfa.h
+/// @brief ALEX DFA and keyword tables generated by lexgen from libopal.h, do not edit
+
+#define LEX_REJECT 0          ///< DFA state without transitions
+#define LEX_START 1           ///< DFA start state
+#define LEX_STATES 28         ///< Number of DFA states
+#define LEX_CLASSES 22        ///< Number of character classes
+#define LEX_CC_SPACE 1        ///< Class of whitespace
+
+/// Character class of every byte
+const unsigned char lex_char_class[256] =
+  {
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  1,  1,  1,  1,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     1, 11,  4,  0,  0, 10, 14,  0, 16, 17,  8,  6, 21,  7,  0,  9,
+     2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  0, 20, 12,  5, 13,  0,
+     0,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+     3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  0,  0,  0,  0,  3,
+     0,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+     3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3, 18, 15, 19,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  };
+
+/// DFA transition table indexed by state and character class
+const unsigned char lex_dfa[LEX_STATES][LEX_CLASSES] =
+  {
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 14, 15, 18, 20, 22, 23, 24, 25, 26, 27 },
+    { 0, 0, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 16, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 17, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 19, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 21, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+  };
+
+/// Lexeme accepted when the DFA stops in a state
+const lexeme_type_e lex_accept[LEX_STATES] =
+  {
+    0, /* No_operation */
+    0, /* No_operation */
+    3, /* Integer */
+    2, /* Identifier */
+    4, /* String */
+    5, /* Op_Assign */
+    6, /* Op_Add */
+    7, /* Op_Subtract */
+    9, /* Op_Multiply */
+    10, /* Op_Divide */
+    11, /* Op_Mod */
+    12, /* Op_Equal */
+    20, /* Op_Not */
+    13, /* Op_NotEqual */
+    14, /* Op_Less */
+    15, /* Op_Greater */
+    16, /* Op_LessEqual */
+    17, /* Op_GreaterEqual */
+    1, /* End_of_file */
+    18, /* Op_And */
+    1, /* End_of_file */
+    19, /* Op_Or */
+    24, /* LeftParen */
+    25, /* RightParen */
+    26, /* LeftBrace */
+    27, /* RightBrace */
+    28, /* Semicolon */
+    29, /* Comma */
+  };
+
+#define LEX_KW_SIZE 8        ///< Keyword hash table size
+/// Perfect hash of a keyword from its first and last character
+#define LEX_KW_HASH(s, n) \
+  (((unsigned char) (s)[0] * 1 + (unsigned char) (s)[(n) - 1] * 0 + (n)) \
+   & (LEX_KW_SIZE - 1))
+
+/// Keyword strings by hash, NULL for empty slots
+const char *const lex_kw_str[LEX_KW_SIZE] =
+  {
+    NULL,
+    "else",
+    NULL,
+    "if",
+    "while",
+    "print",
+    "input",
+    NULL,
+  };
+
+/// Keyword lexeme types by hash
+const lexeme_type_e lex_kw_type[LEX_KW_SIZE] =
+  {
+    0, /* No_operation */
+    22, /* Keyword_Else */
+    0, /* No_operation */
+    21, /* Keyword_If */
+    23, /* Keyword_While */
+    30, /* Keyword_print */
+    31, /* Keyword_input */
+    0, /* No_operation */
+  };
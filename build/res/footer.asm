@@ -0,0 +1,13 @@
+  ;=== User code end ===;
+
+SECTION .bss
+  olen RESQ 1            ; Number of bytes in output buffer
+  obuf RESB OUT_SIZE     ; Output buffer
+  ipos RESQ 1            ; Next character of input buffer to parse
+  ilen RESQ 1            ; Number of characters in input buffer
+  ibuf RESB IN_SIZE      ; Input buffer
+
+SECTION .data
+  fpe_act DQ o_flush, SA_RESTORER | SA_RESETHAND, o_restore, 0 ; SIGFPE action
+
+  ;=== User variables ===;
@@ -0,0 +1,727 @@
+; github.com/torvalds/linux/blob/master/arch/x86/entry/syscalls/syscall_64.tbl
+%define SYS_READ  0
+%define SYS_WRITE 1
+%define SYS_OPEN  2
+%define SYS_RT_SIGACTION  13
+%define SYS_RT_SIGRETURN  15
+%define SYS_EXIT 60
+
+; pubs.opengroup.org/onlinepubs/9699919799/basedefs/unistd.h.html
+%define STDIN     0
+%define STDOUT    1
+%define STDERR    2
+
+; pubs.opengroup.org/onlinepubs/9699919799/basedefs/stdlib.h.html
+%define EXIT_SUCCESS 0
+%define EXIT_FAILURE 1
+
+; man7.org/linux/man-pages/man2/sigaction.2.html
+%define SIGFPE       8
+%define SA_RESTORER  0x04000000
+%define SA_RESETHAND 0x80000000
+
+; Constants for better code readability
+%define NULL    0
+%define isTrue  1
+%define isFalse 0
+%define OUT_SIZE 65536   ; Bytes of output buffered before a write
+%define IN_SIZE  65536   ; Bytes of input read at a time
+
+; =============================================================================
+; Arithematic instructions
+; =============================================================================
+
+; -----------------------------------------------------------------------------
+; Macro - O_ADD
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Sum of integers on top of stack
+; Desc  - Push (stack[-1] + stack[-2]) on stack
+; -----------------------------------------------------------------------------
+%macro O_ADD 0
+  POP  RAX                  ; Get 'a' from stack
+  POP  RBX                  ; Get 'b' from stack
+  ADD  RAX, RBX             ; Sum a + b
+  PUSH RAX                  ; Push sum onto stack
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_SUB
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Different of integers on top of stack
+; Desc  - Push (stack[-2] - stack[-1]) on stack
+; -----------------------------------------------------------------------------
+%macro O_SUB 0
+  POP  RBX                  ; Get 'a' from stack
+  POP  RAX                  ; Get 'b' from stack
+  SUB  RAX, RBX             ; Subtract a - b
+  PUSH RAX                  ; Push difference onto stack
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_NEGATE
+; Args  - None
+; Pre   - Operand integer on top of stack
+; Post  - Negative of integer on stack
+; Desc  - Push negative of stack[-1] on stack
+; -----------------------------------------------------------------------------
+%macro O_NEGATE 0
+  POP   RAX                 ; Get 'a' from stack
+  NEG   RAX                 ; Negate a
+  PUSH  RAX                 ; Push -(a) onto stack
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_MUL
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Product of integers on top of stack
+; Desc  - Push (stack[-1] * stack[-2]) on stack
+; -----------------------------------------------------------------------------
+%macro O_MUL 0
+  POP  RAX                  ; Get 'a' from stack
+  POP  RBX                  ; Get 'b' from stack
+  IMUL RBX                  ; Multiply a * b
+  PUSH RAX                  ; Push product onto stack
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_DIV
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Quotient of integer division on stack
+; Desc  - Push (stack[-2] / stack[-1]) on stack
+; -----------------------------------------------------------------------------
+%macro O_DIV 0
+  POP  RBX                  ; Get 'b' from stack
+  POP  RAX                  ; Get 'a' from stack
+  XOR  RDX, RDX             ; Clear for division
+  IDIV RBX                  ; Divide a / b
+  PUSH RAX                  ; Push dividend onto stack
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_MOD
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Remainder of integer division on stack
+; Desc  - Push (stack[-2] % stack[-1]) on stack
+; -----------------------------------------------------------------------------
+%macro O_MOD 0
+  POP  RBX                  ; Get 'b' from stack
+  POP  RAX                  ; Get 'a' from stack
+  XOR  RDX, RDX             ; Clear for division
+  IDIV RBX                  ; Divide a / b
+  PUSH RDX                  ; Push remainder onto stack
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_EQ
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Integer comparison result on stack
+; Desc  - If stack[-1] == stack[-2], push isTrue on stack, else isFalse
+; -----------------------------------------------------------------------------
+%macro O_EQ 0
+  POP  RBX                  ; Get 'b' from stack
+  POP  RAX                  ; Get 'a' from stack
+  CMP  RAX, RBX             ; a ?? b
+  JNE  %%a_neq_b
+  PUSH isTrue               ; a == b
+  JMP  %%end
+%%a_neq_b:
+  PUSH isFalse              ; a != b
+%%end:
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_NEQ
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Integer comparison result on stack
+; Desc  - If stack[-1] != stack[-2], push isTrue on stack, else isFalse
+; -----------------------------------------------------------------------------
+%macro O_NEQ 0
+  POP  RBX                  ; Get 'b' from stack
+  POP  RAX                  ; Get 'a' from stack
+  CMP  RAX, RBX             ; a ?? b
+  JE   %%a_eq_b
+  PUSH isTrue               ; a != b
+  JMP  %%end
+%%a_eq_b:
+  PUSH isFalse              ; a == b
+%%end:
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_LSS
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Integer comparison result on stack
+; Desc  - If stack[-2] < stack[-1], push isTrue on stack, else isFalse
+; -----------------------------------------------------------------------------
+%macro O_LSS 0
+  POP  RBX                  ; Get 'b' from stack
+  POP  RAX                  ; Get 'a' from stack
+  CMP  RAX, RBX             ; a ?? b
+  JNL  %%a_geq_b
+  PUSH isTrue               ; a < b
+  JMP  %%end
+%%a_geq_b:
+  PUSH isFalse              ; a >= b
+%%end:
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_GTR
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Integer comparison result on stack
+; Desc  - If stack[-2] > stack[-1], push isTrue on stack, else isFalse
+; -----------------------------------------------------------------------------
+%macro O_GTR 0
+  POP  RBX                  ; Get 'b' from stack
+  POP  RAX                  ; Get 'a' from stack
+  CMP  RAX, RBX             ; a ?? b
+  JNG  %%a_leq_b
+  PUSH isTrue               ; a > b
+  JMP  %%end
+%%a_leq_b:
+  PUSH isFalse              ; a <= b
+%%end:
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_LEQ
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Integer comparison result on stack
+; Desc  - If stack[-2] <= stack[-1], push isTrue on stack, else isFalse
+; -----------------------------------------------------------------------------
+%macro O_LEQ 0
+  POP  RBX                  ; Get 'b' from stack
+  POP  RAX                  ; Get 'a' from stack
+  CMP  RAX, RBX             ; a ?? b
+  JG   %%a_gtr_b
+  PUSH isTrue               ; a <= b
+  JMP  %%end
+%%a_gtr_b:
+  PUSH isFalse              ; a > b
+%%end:
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_GEQ
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Integer comparison result on stack
+; Desc  - If stack[-2] >= stack[-1], push isTrue on stack, else isFalse
+; -----------------------------------------------------------------------------
+%macro O_GEQ 0
+  POP  RBX                  ; Get 'b' from stack
+  POP  RAX                  ; Get 'a' from stack
+  CMP  RAX, RBX             ; a ?? b
+  JL  %%a_less_b
+  PUSH isTrue               ; a >= b
+  JMP  %%end
+%%a_less_b:
+  PUSH isFalse              ; a < b
+%%end:
+%endmacro
+
+; =============================================================================
+; Logical instructions
+; =============================================================================
+
+; -----------------------------------------------------------------------------
+; Macro - O_AND
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Logical AND result of integers on stack
+; Desc  - If stack[-1] && stack[-2], push isTrue on stack, else isFalse
+; -----------------------------------------------------------------------------
+%macro O_AND 0
+  POP  RAX               ; Get 'a' from stack
+  POP  RBX               ; Get 'b' from stack
+  AND  RAX, RBX          ; a && b
+  JNZ  %%a_and_b
+  PUSH isFalse           ; If (a && b) is zero, push isFalse ..
+  JMP  %%end
+%%a_and_b:
+  PUSH isTrue            ; .. else, push isTrue
+%%end:
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_OR
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Logical OR result of integers on stack
+; Desc  - If stack[-1] || stack[-2], push isTrue on stack, else isFalse
+; -----------------------------------------------------------------------------
+%macro O_OR 0
+  POP  RAX               ; Get 'a' from stack
+  POP  RBX               ; Get 'b' from stack
+  OR   RAX, RBX          ; a || b
+  JNZ  %%a_or_b
+  PUSH isFalse           ; If (a || b) is zero, push isFalse ..
+  JMP  %%end
+%%a_or_b:
+  PUSH isTrue            ; .. else, push isTrue
+%%end:
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_NOT
+; Args  - None
+; Pre   - Operand integers on top of stack
+; Post  - Logical NOT result of integer on top of stack
+; Desc  - If stack[-1] is non-zero, push isFalse, if value is 0, push isTrue
+; -----------------------------------------------------------------------------
+%macro O_NOT 0
+  POP  RAX               ; Get integer from stack
+  CMP  RAX, 0            ; Compare value with 0
+  JNE  %%nz
+  PUSH isTrue            ; If value is zero, push isTrue on stack ..
+  JMP  %%end
+%%nz:
+  PUSH isFalse           ; .. else, push isFalse on stack
+%%end:
+%endmacro
+
+; =============================================================================
+; Data operation instructions
+; =============================================================================
+
+; -----------------------------------------------------------------------------
+; Macro - _INPUT_
+; Args  - None
+; Pre   - Prompt string index on top of stack
+; Post  - User input integer on top of stack
+; Desc  - Reads integer from user and pushes on top of stack
+; -----------------------------------------------------------------------------
+%macro _INPUT_ 0
+  O_PRTS                 ; Print prompt string with macro
+  CALL o_input           ; Read integer from the next line of input
+  PUSH RAX               ; Push result integer value to top of stack
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - _FETCH_
+; Args  - Array index
+; Pre   - None
+; Post  - Push value at data[index] on top of stack
+; Desc  - Gets integer from array 'data[index]' and pushes it on top of stack
+; -----------------------------------------------------------------------------
+%macro _FETCH_ 1
+  MOV  RAX,[data+(8*%1)] ; Get from [source] + (size) * index
+  PUSH RAX               ; Push integer on top of stack
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - _STORE_
+; Args  - Array index
+; Pre   - Integer to store on top of stack
+; Post  - data[index] = integer at top of stack
+; Desc  - Stores integer from top of stack into array 'data' at given index
+; -----------------------------------------------------------------------------
+%macro _STORE_ 1
+  POP  RAX               ; Get integer to store
+  MOV  [data+(8*%1)],RAX ; Store in [destination] + (size) * index
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - _STORE_KEEP_
+; Args  - Array index
+; Pre   - Integer to store on top of stack
+; Post  - data[index] = integer at top of stack, integer stays on stack
+; Desc  - Stores integer from top of stack into array 'data' at given index
+;         without popping it, as _STORE_ followed by _FETCH_ would
+; -----------------------------------------------------------------------------
+%macro _STORE_KEEP_ 1
+  MOV  RAX,[RSP]         ; Get integer to store
+  MOV  [data+(8*%1)],RAX ; Store in [destination] + (size) * index
+%endmacro
+
+; =============================================================================
+; Logical instructions
+; =============================================================================
+
+; -----------------------------------------------------------------------------
+; Macro - O_JZ
+; Args  - Label to jump to
+; Pre   - Value to compare with 0 on top of stack
+; Post  - None
+; Desc  - If top of stack is 0, jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JZ 1
+  POP  RAX               ; Get value from top of stack ..
+  CMP  RAX, 0            ; .. and compare with zero
+  JE   %1                ; If value is zero, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JNZ
+; Args  - Label to jump to
+; Pre   - Value to compare with 0 on top of stack
+; Post  - None
+; Desc  - If top of stack is non-zero, jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JNZ 1
+  POP  RAX               ; Get value from top of stack ..
+  CMP  RAX, 0            ; .. and compare with zero
+  JNE  %1                ; If value is non-zero, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JEQ
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] == stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JEQ 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JE   %1                ; If a == b, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JNEQ
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] != stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JNEQ 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JNE  %1                ; If a != b, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JLSS
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] < stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JLSS 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JL   %1                ; If a < b, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JGTR
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] > stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JGTR 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JG   %1                ; If a > b, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JLEQ
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] <= stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JLEQ 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JLE  %1                ; If a <= b, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JGEQ
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] >= stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JGEQ 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JGE  %1                ; If a >= b, jump to given label
+%endmacro
+
+; =============================================================================
+; Print instructions
+; =============================================================================
+
+; -----------------------------------------------------------------------------
+; Macro - O_PRTS
+; Args  - None
+; Pre   - strs[index] to print on top of stack
+; Post  - None
+; Desc  - Prints string at 'strs[index]' to output buffer
+; -----------------------------------------------------------------------------
+%macro O_PRTS 0
+  POP  RAX               ; Get index of string to print from stack
+
+  MOV  RBX, 8d           ; Add (index*8) to array address ..
+  IMUL RBX               ; .. to get string address
+
+  MOV  RSI, [strs+RAX]   ; Get address of string to print
+  MOV  RDX, [lens+RAX]   ; Get length of string to print
+  CALL o_write           ; Append string to output buffer
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_PRTS
+; Args  - Char to print
+; Pre   - None
+; Post  - None
+; Desc  - Print given character to output buffer
+; -----------------------------------------------------------------------------
+%macro O_PRTS 1
+  PUSH %1                ; Push char on stack
+  MOV  RSI, RSP          ; Print char on stack
+  MOV  RDX, 1            ; Length
+  CALL o_write           ; Append char to output buffer
+  ADD  RSP, 8            ; Remove char from stack
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_PRTI
+; Args  - None
+; Pre   - Integer to print on top of stack
+; Post  - None
+; Desc  - Prints integer on top of stack to output buffer
+; -----------------------------------------------------------------------------
+%macro O_PRTI 0
+  POP  RAX               ; Get integer from stack
+  MOV  R8, RAX           ; Keep integer to check its sign at the end
+  SUB  RSP, 32           ; Reserve stack for the sign and up to 20 digits
+  LEA  RSI, [RSP+32]     ; Digits are stored backwards from the end
+
+  CMP  RAX, 0            ; Check if number is negative
+  JGE  %%loop            ; If number is positive, convert number
+  NEG  RAX               ; If number is negative, get positive value
+%%loop:
+  XOR  RDX, RDX          ; Zero out remainder register
+  MOV  RBX, 10d          ; Keep dividing number by 10
+  DIV  RBX               ; to get remainder (digit) in RDX
+  ADD  DL, 48d           ; Add 48 to convert decimal to ASCII
+  DEC  RSI               ; Store digit before the previous one
+  MOV  [RSI], DL
+  CMP  RAX, 0            ; If quotient is not zero ..
+  JNZ  %%loop            ; .. get next digit
+
+  CMP  R8, 0             ; If number is negative ..
+  JGE  %%print
+  DEC  RSI               ; .. store '-' sign before the digits
+  MOV  BYTE [RSI], '-'
+%%print:
+  LEA  RDX, [RSP+32]     ; Length is from first char to end of digits
+  SUB  RDX, RSI
+  CALL o_write           ; Append sign and digits to output buffer
+  ADD  RSP, 32           ; Remove digits from stack
+%endmacro
+
+; =============================================================================
+; Execution instructions
+; =============================================================================
+
+; -----------------------------------------------------------------------------
+; Macro - HALT
+; Args  - None
+; Pre   - None
+; Post  - None
+; Desc  - Writes buffered output and runs SYS_EXIT system call with code - 0
+; -----------------------------------------------------------------------------
+%macro HALT 0
+  CALL o_flush           ; Write buffered output
+  MOV  RAX, SYS_EXIT     ; Use SYS_EXIT system call to exit ..
+  MOV  RDI, 0            ; .. with exit code 0
+  SYSCALL
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - HALT
+; Args  - Exit code
+; Pre   - None
+; Post  - None
+; Desc  - Runs SYS_EXIT system call with given code
+; -----------------------------------------------------------------------------
+%macro HALT 1
+  MOV  RDI, %1           ; Set given argument as exit code, before RAX is ..
+  MOV  RAX, SYS_EXIT     ; .. set to use SYS_EXIT system call to exit
+  SYSCALL
+%endmacro
+
+; =============================================================================
+; Program instructions
+; =============================================================================
+
+SECTION .text
+
+; -----------------------------------------------------------------------------
+; Routine - o_flush
+; Args  - None
+; Pre   - None
+; Post  - Output buffer is empty
+; Desc  - Writes buffered output to STDOUT with one system call. Also the
+;         SIGFPE handler, so output printed before a division fault is not
+;         lost: the handler is reset when the division is retried.
+; -----------------------------------------------------------------------------
+o_flush:
+  MOV  RDX, [olen]       ; Get number of bytes buffered
+  CMP  RDX, 0            ; If buffer is empty ..
+  JE   .end              ; .. there is nothing to write
+  MOV  RAX, SYS_WRITE    ; Use sys_write system call
+  MOV  RDI, STDOUT       ; Output to stdout
+  MOV  RSI, obuf         ; Write buffered output
+  SYSCALL                ; Call kernel
+  CMP  RDX, RAX          ; If sys_write wrote expected number of bytes ..
+  JE   .empty            ; .. empty buffer
+  HALT RAX               ; .. else, exit with difference as code ..
+.empty:
+  MOV  QWORD [olen], 0   ; No bytes buffered
+.end:
+  RET
+
+; -----------------------------------------------------------------------------
+; Routine - o_write
+; Args  - RSI address and RDX length of bytes to print
+; Pre   - None
+; Post  - Bytes are buffered or written
+; Desc  - Appends bytes to output buffer, writes buffered output first if
+;         they do not fit. Bytes longer than the buffer are written directly.
+; -----------------------------------------------------------------------------
+o_write:
+  MOV  RAX, [olen]       ; If bytes fit after those buffered ..
+  ADD  RAX, RDX
+  CMP  RAX, OUT_SIZE
+  JBE  .copy             ; .. append them
+  PUSH RSI               ; .. else, write buffered output
+  PUSH RDX
+  CALL o_flush
+  POP  RDX
+  POP  RSI
+  CMP  RDX, OUT_SIZE     ; If bytes fit in the empty buffer ..
+  JBE  .copy             ; .. append them
+  MOV  RAX, SYS_WRITE    ; .. else, use sys_write system call
+  MOV  RDI, STDOUT       ; Output to stdout
+  SYSCALL                ; Call kernel
+  CMP  RDX, RAX          ; If sys_write wrote expected number of bytes ..
+  JE   .end              ; .. return
+  HALT RAX               ; .. else, exit with difference as code ..
+.copy:
+  MOV  RDI, obuf         ; Copy after bytes buffered ..
+  ADD  RDI, [olen]
+  ADD  [olen], RDX       ; .. and count bytes appended
+  MOV  RCX, RDX
+  REP  MOVSB
+.end:
+  RET
+
+; -----------------------------------------------------------------------------
+; Routine - o_getc
+; Args  - None
+; Pre   - None
+; Post  - Next input character in RAX
+; Desc  - Gets next character from the input buffer. Once the characters read
+;         are used up, writes buffered output and reads the next chunk from
+;         STDIN. A newline is returned at the end of input.
+; -----------------------------------------------------------------------------
+o_getc:
+  MOV  RSI, [ipos]       ; If characters read are left ..
+  CMP  RSI, [ilen]
+  JAE  .read
+  MOVZX EAX, BYTE [ibuf+RSI] ; .. return the next one
+  INC  RSI
+  MOV  [ipos], RSI
+  RET
+.read:
+  CALL o_flush           ; Write prompt and output so far before reading
+  MOV  RAX, SYS_READ     ; Use sys_read system call ..
+  MOV  RDI, STDIN        ; .. to read from STDIN ..
+  MOV  RSI, ibuf         ; .. into input buffer ..
+  MOV  RDX, IN_SIZE      ; .. as many characters as fit
+  SYSCALL                ; Call kernel
+  CMP  RAX, 0            ; If nothing was read, input has ended ..
+  JLE  .end
+  MOV  [ilen], RAX       ; .. else, parse characters read from the start
+  MOV  QWORD [ipos], 0
+  JMP  o_getc
+.end:
+  MOV  RAX, 0ah          ; End of input ends the line
+  RET
+
+; -----------------------------------------------------------------------------
+; Routine - o_input
+; Args  - None
+; Pre   - None
+; Post  - Integer read in RAX
+; Desc  - Converts the next line of input to integer: an optional '-' sign,
+;         then the digits up to the first other character. The rest of the
+;         line is skipped.
+; -----------------------------------------------------------------------------
+o_input:
+  XOR  RBX, RBX          ; RBX will hold converted integer, starts off as 0
+  XOR  R8, R8            ; R8 will be the flag for negative value
+  CALL o_getc            ; Read in the first character
+  CMP  RAX, 45           ; If char is not -ve sign ..
+  JNE  .digit            ; .. convert it
+  MOV  R8, 1d            ; .. else set negative integer flag
+.next:
+  CALL o_getc            ; Read in next character
+.digit:
+  SUB  EAX, 48           ; Get decimal value from ASCII
+  CMP  EAX, 9            ; If it is not a digit (unsigned) ..
+  JA   .skip             ; .. conversion ends
+  LEA  RBX, [RBX+RBX*4]  ; integer = integer * 10 + digit
+  LEA  RBX, [RAX+RBX*2]
+  JMP  .next
+.skip:
+  ADD  EAX, 48           ; Skip rest of the line
+.line:
+  CMP  EAX, 0ah
+  JE   .sign
+  CALL o_getc
+  JMP  .line
+.sign:
+  MOV  RAX, RBX          ; Return integer ..
+  CMP  R8, 1d            ; .. negated if negative integer flag is set
+  JNE  .end
+  NEG  RAX
+.end:
+  RET
+
+; -----------------------------------------------------------------------------
+; Routine - o_restore
+; Args  - None
+; Pre   - Signal handler returned
+; Post  - Registers of the interrupted code are restored
+; Desc  - Runs SYS_RT_SIGRETURN system call, restorer of the SIGFPE handler
+; -----------------------------------------------------------------------------
+o_restore:
+  MOV  RAX, SYS_RT_SIGRETURN
+  SYSCALL
+
+global _start
+  _start:
+
+  MOV  RAX, SYS_RT_SIGACTION ; Use rt_sigaction system call ..
+  MOV  RDI, SIGFPE       ; .. to write buffered output on division fault
+  MOV  RSI, fpe_act
+  XOR  RDX, RDX          ; Old action is not needed
+  MOV  R10, 8            ; Size of signal mask
+  SYSCALL
+
+  NOP
+  ;=== User code start ===;
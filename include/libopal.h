@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <stdbool.h>            /* boolean datatypes */
 #include <stddef.h>
+#include <stdint.h>             /* uint64_t */
 
 /// __VERSION_NUM for program
 #ifndef __VERSION_NUM
@@ -42,7 +43,6 @@ char *golden_fn = NULL;         ///< Golden syntax tree printout file name
 
 char *css_fn = "res/styles.css";        ///< HTML CSS file name
 
-FILE *source_fp = NULL;         ///< Source file pointer
 FILE *dest_fp = NULL;           ///< Destination file pointer
 FILE *log_fp = NULL;            ///< Log file pointer
 FILE *report_fp = NULL;         ///< Report file pointer
@@ -50,10 +50,6 @@ FILE *golden_fp = NULL;         ///< Golden syntax tree printout file pointer
 
 short retVal = 0;               ///< Function return value
 
-int next_char = ' ';            ///< Next character in source file
-int char_col = 0;               ///< Column number of character in source file
-int char_line = 0;              ///< Line number of character in source file
-
 /// Log level name enum for opal_log function
 typedef enum log_level
 {
@@ -66,6 +62,55 @@ short LOG_LEVEL = ERROR;        ///< Current log level
 /// Message string for perror()
 char perror_msg[perror_msg_len] = { 0 };
 
+/// Struct for growable in-memory character buffer
+typedef struct char_buf
+{
+  char *data;       ///< buffer contents, always NUL terminated
+  size_t len;       ///< number of characters used
+  size_t cap;       ///< number of characters allocated
+} char_buf_s;
+
+char_buf_s source_buf = { 0 };  ///< Contents of the source file
+
+/// Size of memory chunks allocated by arenas
+#define ARENA_CHUNK_SIZE (64 * 1024)
+/// Alignment of arena allocations, enough for all data held in arenas
+#define ARENA_ALIGN 8
+
+/// Struct for chunk of memory handed out by an arena, data follows it
+typedef struct arena_chunk
+{
+  struct arena_chunk *next;   ///< chunk allocated before this one
+  size_t used;                ///< number of bytes handed out
+  size_t size;                ///< number of bytes in the chunk
+} arena_chunk_s;
+
+/// Struct for arena allocator releasing all its allocations at once
+typedef struct arena
+{
+  arena_chunk_s *head;        ///< chunk allocations are bumped off
+} arena_s;
+
+/// Struct for table of interned strings, each stored once under a fixed id
+typedef struct str_table
+{
+  arena_s arena;          ///< memory holding the interned strings
+  const char **str;       ///< NUL terminated interned string by id
+  unsigned int *hash;     ///< open addressing hash slots holding id + 1
+  unsigned int count;     ///< number of strings interned
+  unsigned int cap;       ///< number of ids allocated
+  unsigned int slots;     ///< number of hash slots, a power of two
+} str_table_s;
+str_table_s str_table = { 0 };  ///< Interned identifiers, strings and labels
+
+/*
+ * ==================================
+ * MARC data structures and variables used
+ * ==================================
+ */
+
+char_buf_s marc_buf = { 0 };    ///< Pre-processed source handed to ALEX
+
 /*
  * ==================================
  * ALEX data structures and variables used
@@ -135,28 +180,43 @@ const char op_name[][16] =
       "LeftBrace", "RightBrace", "Semicolon", "Comma", "Keyword_print",
       "Keyword_input" };
 
-/// Struct for lexeme in the symbol table linked list
+/// Struct for lexeme found by the lexer
 typedef struct lexeme
 {
   lexeme_type_e type;    ///< type of lexeme
-  int line;              ///< line number in source file
-  int column;            ///< column number in source file
+  int offset;            ///< offset in source buffer, -1 if none
+  int length;            ///< number of characters in source buffer
   int int_val;           ///< holds value for integer lexemes
-  char *char_val;        ///< holds value for string an identifier lexemes
-  struct lexeme *next;   ///< pointer for next lexeme in list
+  unsigned int str_id;   ///< interned value of string and identifier lexemes
 } lexeme_s;
 
+/// Struct of parallel arrays holding the lexemes of the symbol table
+typedef struct symbol_table
+{
+  int *offset;           ///< offset in source buffer, -1 if none
+  int *length;           ///< number of characters in source buffer
+  int *value;            ///< integer value, or interned string id
+  unsigned char *type;   ///< lexeme_type_e of each lexeme
+  int count;             ///< number of lexemes in the table
+  int cap;               ///< number of lexemes allocated
+  arena_s arena;         ///< memory holding the arrays
+} symbol_table_s;
+
 /// Struct to hold next lexeme
 lexeme_s next_lexeme = { 0 };
 
+const char *lex_buf = NULL;     ///< Start of source buffer scanned by ALEX
+const char *lex_ptr = NULL;     ///< Cursor to next character to be scanned
+const char *lex_end = NULL;     ///< End of source buffer, holds NUL sentinel
+int lex_pos_offset = 0;         ///< Offset of last line/column lookup
+int lex_pos_line = 0;           ///< Line number at last line/column lookup
+int lex_pos_nl = -1;            ///< Offset of last newline before lookup
+
 /// A buffer to hold string value of lexeme
 #define lexeme_str_len 1024
 /// Holds stringified contents of lexeme for printing
 char lexeme_str[lexeme_str_len] = { 0 };
 
-/// Extended regular expression pattern for integers
-char *int_regex_pattern = "^[-+]?[0-9]+$";
-
 
 /*
  * ==================================
@@ -206,16 +266,82 @@ const char node_name[][16] =
       "Keyword_If", "Keyword_Else", "Keyword_While", "Print_String",
       "Print_Integer", "Code_sequence", "Keyword_input" };
 
-/// Struct for abstract syntax tree node
+/**
+ * Struct for abstract syntax tree node, children are indices into ast.nodes.
+ * An nd_Sequence node is a block whose statements are the indices
+ * ast.list[first] to ast.list[first + len - 1].
+ */
 typedef struct node
 {
   ast_node_type_e node_type;  ///< type of node in tree
-  struct node *left;          ///< pointer this node's left child
-  struct node *right;         ///< pointer this node's right child
-  char *char_val;             ///< holds value of String and Identifier nodes
-  int int_val;                ///< holds value of Integer nodes
+  union
+  {
+    struct
+    {
+      unsigned int left;      ///< index of this node's left child, 0 if none
+      unsigned int right;     ///< index of this node's right child, 0 if none
+    };
+    struct
+    {
+      unsigned int first;     ///< position of block's first statement in list
+      unsigned int len;       ///< number of statements in block
+    };
+  };
+  union
+  {
+    unsigned int str_id;      ///< interned value of String and Identifier nodes
+    int int_val;              ///< holds value of Integer nodes
+  };
 } node_s;
 
+/// make_expression_node() step waiting for its operand, kept on ast.expr
+typedef struct expr_frame
+{
+  int precedence;             ///< lowest precedence of binary operator taken
+  ast_node_type_e op;         ///< node made from the operand, nd_NOP if none
+  unsigned int left;          ///< left child of binary operator node, else 0
+  short paren;                ///< TRUE if operand is closed by ')'
+} expr_frame_s;
+
+/// Operator replaced by its value by fold_constants()
+typedef struct fold
+{
+  ast_node_type_e op;         ///< type of folded operator node
+  int left;                   ///< value of left operand
+  int right;                  ///< value of right operand, 0 if unary operator
+  int result;                 ///< value of Integer node replacing the operator
+} fold_s;
+
+/// Abstract syntax tree stored as one contiguous node array
+typedef struct ast
+{
+  node_s *nodes;              ///< node array, node 0 stands for none
+  unsigned int count;         ///< number of nodes in use, including node 0
+  unsigned int cap;           ///< number of nodes allocated
+  unsigned int *list;         ///< statements of all blocks, block by block
+  unsigned int list_len;      ///< number of statements in list
+  unsigned int list_cap;      ///< number of statements allocated in list
+  unsigned int *open;         ///< statements of blocks still being parsed
+  unsigned int open_len;      ///< number of statements in open
+  unsigned int open_cap;      ///< number of statements allocated in open
+  expr_frame_s *expr;         ///< stack of expression parser steps
+  unsigned int expr_len;      ///< number of steps on the stack
+  unsigned int expr_cap;      ///< number of steps allocated
+  fold_s *folds;              ///< constants folded by fold_constants()
+  unsigned int folds_len;     ///< number of folds made
+  unsigned int folds_cap;     ///< number of folds allocated
+} ast_s;
+
+ast_s ast = { 0 };            ///< Syntax tree built by build_syntax_tree()
+
+/// Explicit stack for pre-order syntax tree traversal
+typedef struct ast_walk
+{
+  unsigned int *stack;        ///< indices of nodes still to visit
+  unsigned int len;           ///< number of indices on the stack
+  unsigned int cap;           ///< number of indices allocated
+} ast_walk_s;
+
 /// Language grammar
 typedef struct attributes
 {
@@ -266,10 +392,15 @@ const attributes_s grammar[] =
     { ";", "Semicolon", lx_Semi, FALSE, FALSE, FALSE, -1, -1 },
     { ",", "Comma", lx_Comma, FALSE, FALSE, FALSE, -1, -1 },
     { "print", "Keyword_print", lx_Print, FALSE, FALSE, FALSE, -1, -1 },
+    { "input", "Keyword_input", lx_Input, FALSE, FALSE, FALSE, -1, nd_Input },
   };
 
-/// Lexeme currently being processed by build_syntax_tree()
-lexeme_s *ast_curr_lexeme = NULL;
+/// Symbol table being parsed by build_syntax_tree()
+const symbol_table_s *ast_symbols = NULL;
+/// Index of lexeme currently being processed by build_syntax_tree()
+int ast_curr = 0;
+/// Type of lexeme currently being processed by build_syntax_tree()
+#define ast_curr_type ((lexeme_type_e) ast_symbols->type[ast_curr])
 
 /*
  * ==================================
@@ -312,6 +443,13 @@ typedef enum asm_code
   asm_HALT,
   asm_Label,
   asm_Input,
+  asm_Jeq,          ///< Fused compare and jump, in the order of asm_Eq ..
+  asm_Jneq,
+  asm_Jlss,
+  asm_Jgtr,
+  asm_Jleq,
+  asm_Jgeq,         ///< .. asm_Geq
+  asm_StoreKeep,
 } asm_code_e;
 
 /// Struct for assembly code list
@@ -319,38 +457,485 @@ typedef struct asm_cmd
 {
   asm_code_e cmd;   ///< asm command macro type
   int intval;       ///< value for integer types
-  char *label;      ///< string for keyword types
+  unsigned int label; ///< interned label name for label and jump types
 }asm_cmd_e;
 
+/// Code generation task types
+typedef enum
+{
+  task_Code,        ///< Generate code of node
+  task_Jump,        ///< Generate jump to label on truth of node condition
+  task_Add,         ///< Append command
+  task_Var,         ///< Append command on the variable slot of ident node
+} asm_task_e;
+
+/// Pending step of code generation on the asm_tasks stack
+typedef struct asm_task
+{
+  asm_task_e type;      ///< what the task does
+  unsigned int node;    ///< syntax tree node index
+  asm_code_e cmd;       ///< command appended
+  int value;            ///< integer value appended, or truth jumped on
+  unsigned int label;   ///< interned label name, 0 if none
+} asm_task_s;
+
+/// Peephole rules, in the order they are tried on the assembly code list
+typedef enum
+{
+  peep_StoreFetch,
+  peep_PushNegate,
+  peep_NotNot,
+  peep_NotJz,
+  peep_NotJnz,
+  peep_JmpNext,
+  peep_DeadLabel,
+} peephole_rule_e;
+
+/// Peephole rule and its hit count
+typedef struct peephole_rule
+{
+  peephole_rule_e rule;     ///< rule applied by peephole_rewrite()
+  const char *pattern;      ///< commands matched, as shown in report
+  const char *rewrite;      ///< commands emitted instead
+  unsigned int hits;        ///< number of rewrites made
+} peephole_rule_s;
+
 /// 0-address assembly commands
 const char asm_cmds[][16] =
   { "NOP", "_EOF_", "_IDENT_", "_INT_", "_STR_", "_ASSIGN_", "O_ADD", "O_SUB",
       "O_NEGATE", "O_MUL", "O_DIV", "O_MOD", "O_EQ", "O_NEQ", "O_LSS", "O_GTR",
       "O_LEQ", "O_GEQ", "O_AND", "O_OR", "O_NOT", "_FETCH_", "_STORE_", "PUSH",
-      "JMP", "O_JZ", "O_JNZ", "O_PRTS", "O_PRTI", "HALT", "_LABEL_", "_INPUT_"
+      "JMP", "O_JZ", "O_JNZ", "O_PRTS", "O_PRTI", "HALT", "_LABEL_", "_INPUT_",
+      "O_JEQ", "O_JNEQ", "O_JLSS", "O_JGTR", "O_JLEQ", "O_JGEQ",
+      "_STORE_KEEP_"
 };
 
-/// Maximum ASM commands
-#define MAX_ASM_CMD 4096
-
-/// Maximum strings in program
-#define MAX_STR 4096
-
-/// Maximum variables
-#define MAX_VAR 4096
-
-asm_cmd_e asm_cmd_list[MAX_ASM_CMD] = { {0} }; ///< Assembly commands list
+asm_cmd_e *asm_cmd_list = NULL;     ///< Assembly commands list
 unsigned int asm_cmd_list_len = 0;  ///< Assembly commands list length
+unsigned int asm_cmd_list_cap = 0;  ///< Assembly commands allocated
+
+asm_task_s *asm_tasks = NULL;    ///< Code generation steps left to run
+unsigned int asm_tasks_len = 0;  ///< Steps left to run
+unsigned int asm_tasks_cap = 0;  ///< Steps allocated
 
-char *strs[MAX_STR] = { 0 };   ///< Strings used in program
+unsigned int *strs = NULL;  ///< Interned strings used in program
 unsigned int strs_len = 0;  ///< Strings used count
+unsigned int strs_cap = 0;  ///< Strings allocated
+unsigned int *str_slot = NULL;  ///< strs index + 1 by interned id, 0 if unused
+unsigned int str_slot_len = 0;  ///< Number of ids covered by str_slot
 
-char *vars[MAX_VAR] = { 0 };   ///< Vars used in program
+unsigned int *vars = NULL;  ///< Interned vars used in program
 unsigned int vars_len = 0;  ///< Vars used count
+unsigned int vars_cap = 0;  ///< Vars allocated
+unsigned int *var_slot = NULL;  ///< vars index + 1 by interned id, 0 if unused
+unsigned int var_slot_len = 0;  ///< Number of ids covered by var_slot
+
+arena_s asm_arena = { 0 };      ///< Memory holding the slot lookup arrays
+
+unsigned int *label_refs = NULL;  ///< Jumps to each label by interned id
+unsigned int label_refs_len = 0;  ///< Number of ids covered by label_refs
+
+/// Peephole rules tried on the tail of the assembly code list
+peephole_rule_s peephole_rules[] =
+  {
+    { peep_StoreFetch, "_STORE_ n; _FETCH_ n", "_STORE_KEEP_ n", 0 },
+    { peep_PushNegate, "PUSH k; O_NEGATE", "PUSH -k", 0 },
+    { peep_NotNot, "O_NOT; O_NOT; O_NOT", "O_NOT", 0 },
+    { peep_NotJz, "O_NOT; O_JZ L", "O_JNZ L", 0 },
+    { peep_NotJnz, "O_NOT; O_JNZ L", "O_JZ L", 0 },
+    { peep_JmpNext, "JMP L; L:", "L:", 0 },
+    { peep_DeadLabel, "L: with no jump to L", "", 0 },
+  };
+
+/// Code generator backends
+typedef enum
+{
+  backend_Stack,    ///< Stack macros of res/header.asm
+  backend_Regs,     ///< Register code caching the top of the operand stack
+  backend_C,        ///< C source with the runtime of res/header.c
+} asm_backend_e;
+
+/// Backend names accepted by --backend, by asm_backend_e
+const char asm_backends[][8] = { "stack", "regs", "c" };
+
+asm_backend_e asm_backend = backend_Stack;  ///< Backend used by print_asm_code
+
+/// C function or operator of binary nodes in the C backend, by node type
+const char *const c_ops[] =
+  {
+    [nd_Add] = "o_add", [nd_Sub] = "o_sub", [nd_Mul] = "o_mul",
+    [nd_Div] = "o_div", [nd_Mod] = "o_mod", [nd_Eq] = "==", [nd_Neq] = "!=",
+    [nd_Lss] = "<", [nd_Gtr] = ">", [nd_Leq] = "<=", [nd_Geq] = ">=",
+  };
+
+#define REG_CACHE_SIZE 8        ///< Operand stack entries kept in registers
+
+/// Kinds of operand stack entries in the register backend
+typedef enum
+{
+  opnd_Reg,         ///< Value in the register of the entry's stack position
+  opnd_Imm,         ///< Constant not loaded yet
+  opnd_Mem,         ///< Variable not loaded yet
+} opnd_kind_e;
+
+/// Operand stack entry cached by the register backend
+typedef struct opnd
+{
+  opnd_kind_e kind; ///< where the value is
+  int val;          ///< constant, or data index of the variable
+} opnd_s;
+
+/// Operand stack as tracked by the register backend at compile time
+typedef struct reg_cache
+{
+  opnd_s entry[REG_CACHE_SIZE]; ///< cached entries by stack position
+  int depth;                    ///< stack depth, relative to the last label
+  int cached;                   ///< number of top entries cached
+} reg_cache_s;
+
+/// Registers holding the operand stack, by stack position. RAX and RDX are
+/// left as scratch for division and SETcc, R12 - R15 are not used.
+const char reg_names[REG_CACHE_SIZE][4] =
+  { "RBX", "RCX", "RSI", "RDI", "R8", "R9", "R10", "R11" };
+
+reg_cache_s reg_cache = { 0 };  ///< Operand stack of the register backend
+
+#define PIN_REG_COUNT 5         ///< Registers for variables pinned by --pin-vars
+
+/// Registers holding the most used variables. The print and input macros
+/// and the register backend leave them alone, so they are never spilled.
+const char pin_names[PIN_REG_COUNT][4] = { "R12", "R13", "R14", "R15", "RBP" };
+
+short pin_vars = FALSE;         ///< Keep the most used variables in registers
+int *var_pin = NULL;            ///< pin_names index by vars index, -1 if none
 
 unsigned int int_count = 0; ///< Integers used
 unsigned int usr_vars = 0;  ///< User input varss used count
 
+/*
+ * ==================================
+ * ORCHESTRATOR data structures and variables used
+ * ==================================
+ */
+
+#define X86_CODE_ADDR 0x400000      ///< Load address of the executable's code
+#define X86_DATA_ADDR 0x10000000    ///< Load address of strings and variables
+#define X86_PAGE_SIZE 4096          ///< Alignment of the ELF segments
+#define X86_OUTPUT_SIZE 65536       ///< Output buffer, after the count of bytes in it
+#define X86_INPUT_SIZE 65536        ///< Input buffer, after position and count
+#define X86_RT_DATA_SIZE (8 + X86_OUTPUT_SIZE + 16 + X86_INPUT_SIZE) ///< Runtime data
+
+/// Jump or call whose rel32 is patched once its label is placed
+typedef struct x86_fixup
+{
+  unsigned int offset;        ///< code offset of the rel32
+  unsigned int label;         ///< interned label jumped to
+} x86_fixup_s;
+
+/// Machine code and data encoded from the assembly command list
+typedef struct x86_image
+{
+  unsigned char *code;        ///< runtime followed by the user code
+  unsigned int code_len;      ///< number of code bytes
+  unsigned int code_cap;      ///< number of code bytes allocated
+  unsigned char *data;        ///< strs and lens tables followed by the strings
+  unsigned int data_len;      ///< number of data bytes
+  unsigned int bss_len;       ///< zeroed bytes after data, variables and input
+  uint64_t data_addr;         ///< address data is loaded at
+  uint64_t vars_addr;         ///< address of the variables
+  unsigned int *label_at;     ///< code offset + 1 by interned label, 0 if none
+  unsigned int label_at_len;  ///< number of label_at entries
+  x86_fixup_s *fixups;        ///< jumps to patch
+  unsigned int fixups_len;    ///< number of fixups
+  unsigned int fixups_cap;    ///< number of fixups allocated
+} x86_image_s;
+
+/// Register numbers of pin_names for instruction encoding
+const unsigned char pin_regs[PIN_REG_COUNT] = { 12, 13, 14, 15, 5 };
+
+#define X86_RT_FLUSH 0x00           ///< x86_runtime offset of rt_flush
+#define X86_RT_WRITE 0x3a           ///< x86_runtime offset of rt_write
+#define X86_RT_PRTI 0x8e            ///< x86_runtime offset of rt_prti
+#define X86_RT_HALT 0xd6            ///< x86_runtime offset of rt_halt
+#define X86_RT_INIT 0xe4            ///< x86_runtime offset of rt_init
+#define X86_RT_INPUT 0x190          ///< x86_runtime offset of rt_input
+
+/// Offsets of the absolute addresses in x86_runtime, relative to the
+/// runtime data, that x86_encode() adds the address of the data to
+const unsigned short x86_runtime_relocs[] =
+  { 0x04, 0x0e, 0x27, 0x3e, 0x75, 0x7d, 0x84, 0x139, 0x141, 0x14a, 0x155,
+      0x164, 0x178, 0x180 };
+
+/// Runtime of executables written by gen_elf(), the equivalent of the print
+/// and input macros of res/header.asm called by the encoded user code. The
+/// runtime data of X86_RT_DATA_SIZE bytes holds the output buffer OUT, the
+/// count of bytes buffered followed by X86_OUTPUT_SIZE bytes, and then the
+/// input buffer, the position IPOS and count ILEN of the bytes read followed
+/// by the X86_INPUT_SIZE bytes at IBUF.
+const unsigned char x86_runtime[] =
+  {
+    /* rt_flush: write the buffered output, exit on a short write */
+    0x48, 0x8b, 0x14, 0x25, 0x00, 0x00, 0x00, 0x00, /* mov rdx, [OUT]  */
+    0x48, 0x85, 0xd2,                           /* test rdx, rdx         */
+    0x74, 0x22,                                 /* jz .empty             */
+    0xbe, 0x08, 0x00, 0x00, 0x00,               /* mov esi, OUT+8        */
+    0xbf, 0x01, 0x00, 0x00, 0x00,               /* mov edi, STDOUT       */
+    0xb8, 0x01, 0x00, 0x00, 0x00,               /* mov eax, SYS_WRITE    */
+    0x0f, 0x05,                                 /* syscall               */
+    0x48, 0x39, 0xc2,                           /* cmp rdx, rax          */
+    0x75, 0x0d,                                 /* jne rt_fail           */
+    0x48, 0xc7, 0x04, 0x25, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,                     /* mov qword [OUT], 0    */
+    0xc3,                                       /* .empty: ret           */
+    /* rt_fail: exit with the result of write as code */
+    0x48, 0x89, 0xc7,                           /* mov rdi, rax          */
+    0xb8, 0x3c, 0x00, 0x00, 0x00,               /* mov eax, SYS_EXIT     */
+    0x0f, 0x05,                                 /* syscall               */
+    /* rt_write: append RDX bytes at RSI to the output buffer */
+    0x48, 0x8b, 0x04, 0x25, 0x00, 0x00, 0x00, 0x00, /* mov rax, [OUT]  */
+    0x48, 0x01, 0xd0,                           /* add rax, rdx          */
+    0x48, 0x3d, 0x00, 0x00, 0x01, 0x00,         /* cmp rax, X86_OUTPUT_SIZE */
+    0x76, 0x24,                                 /* jbe .copy             */
+    0x56,                                       /* push rsi              */
+    0x52,                                       /* push rdx              */
+    0xe8, 0xac, 0xff, 0xff, 0xff,               /* call rt_flush         */
+    0x5a,                                       /* pop rdx               */
+    0x5e,                                       /* pop rsi               */
+    0x48, 0x81, 0xfa, 0x00, 0x00, 0x01, 0x00,   /* cmp rdx, X86_OUTPUT_SIZE */
+    0x76, 0x12,                                 /* jbe .copy             */
+    0xbf, 0x01, 0x00, 0x00, 0x00,               /* mov edi, STDOUT       */
+    0xb8, 0x01, 0x00, 0x00, 0x00,               /* mov eax, SYS_WRITE    */
+    0x0f, 0x05,                                 /* syscall               */
+    0x48, 0x39, 0xc2,                           /* cmp rdx, rax          */
+    0x75, 0xc0,                                 /* jne rt_fail           */
+    0xc3,                                       /* ret                   */
+    0x48, 0x8b, 0x3c, 0x25, 0x00, 0x00, 0x00, 0x00, /* .copy: mov rdi, [OUT] */
+    0x48, 0x01, 0x14, 0x25, 0x00, 0x00, 0x00, 0x00, /* add [OUT], rdx  */
+    0x48, 0x81, 0xc7, 0x08, 0x00, 0x00, 0x00,   /* add rdi, OUT+8        */
+    0x48, 0x89, 0xd1,                           /* mov rcx, rdx          */
+    0xf3, 0xa4,                                 /* rep movsb             */
+    0xc3,                                       /* ret                   */
+    /* rt_prti: print RAX as signed decimal */
+    0x49, 0x89, 0xc0,                           /* mov r8, rax           */
+    0x48, 0x83, 0xec, 0x20,                     /* sub rsp, 32           */
+    0x48, 0x8d, 0x74, 0x24, 0x20,               /* lea rsi, [rsp+32]     */
+    0x48, 0x85, 0xc0,                           /* test rax, rax         */
+    0x79, 0x03,                                 /* jns .digits           */
+    0x48, 0xf7, 0xd8,                           /* neg rax               */
+    0xbb, 0x0a, 0x00, 0x00, 0x00,               /* .digits: mov ebx, 10  */
+    0x31, 0xd2,                                 /* .next: xor edx, edx   */
+    0x48, 0xf7, 0xf3,                           /* div rbx               */
+    0x80, 0xc2, 0x30,                           /* add dl, '0'           */
+    0x48, 0xff, 0xce,                           /* dec rsi               */
+    0x88, 0x16,                                 /* mov [rsi], dl         */
+    0x48, 0x85, 0xc0,                           /* test rax, rax         */
+    0x75, 0xee,                                 /* jnz .next             */
+    0x4d, 0x85, 0xc0,                           /* test r8, r8           */
+    0x79, 0x06,                                 /* jns .write            */
+    0x48, 0xff, 0xce,                           /* dec rsi               */
+    0xc6, 0x06, 0x2d,                           /* mov byte [rsi], '-'   */
+    0x48, 0x8d, 0x54, 0x24, 0x20,               /* .write: lea rdx, [rsp+32] */
+    0x48, 0x29, 0xf2,                           /* sub rdx, rsi          */
+    0xe8, 0x69, 0xff, 0xff, 0xff,               /* call rt_write         */
+    0x48, 0x83, 0xc4, 0x20,                     /* add rsp, 32           */
+    0xc3,                                       /* ret                   */
+    /* rt_halt: write the buffered output, exit with code 0 */
+    0xe8, 0x25, 0xff, 0xff, 0xff,               /* call rt_flush         */
+    0x31, 0xff,                                 /* xor edi, edi          */
+    0xb8, 0x3c, 0x00, 0x00, 0x00,               /* mov eax, SYS_EXIT     */
+    0x0f, 0x05,                                 /* syscall               */
+    /* rt_init: make rt_flush the handler of SIGFPE, reset once it returns
+       to the faulting division, so output before a fault is written */
+    0x48, 0x83, 0xec, 0x20,                     /* sub rsp, 32           */
+    0x48, 0x8d, 0x05, 0x11, 0xff, 0xff, 0xff,   /* lea rax, [rt_flush]   */
+    0x48, 0x89, 0x04, 0x24,                     /* mov [rsp], rax        */
+    0xb8, 0x00, 0x00, 0x00, 0x84,               /* mov eax, SA_RESTORER | SA_RESETHAND */
+    0x48, 0x89, 0x44, 0x24, 0x08,               /* mov [rsp+8], rax      */
+    0x48, 0x8d, 0x05, 0x2a, 0x00, 0x00, 0x00,   /* lea rax, [rt_restore] */
+    0x48, 0x89, 0x44, 0x24, 0x10,               /* mov [rsp+16], rax     */
+    0x48, 0xc7, 0x44, 0x24, 0x18, 0x00, 0x00,
+    0x00, 0x00,                                 /* mov qword [rsp+24], 0 */
+    0xb8, 0x0d, 0x00, 0x00, 0x00,               /* mov eax, SYS_RT_SIGACTION */
+    0xbf, 0x08, 0x00, 0x00, 0x00,               /* mov edi, SIGFPE       */
+    0x48, 0x89, 0xe6,                           /* mov rsi, rsp          */
+    0x31, 0xd2,                                 /* xor edx, edx          */
+    0x41, 0xba, 0x08, 0x00, 0x00, 0x00,         /* mov r10d, 8           */
+    0x0f, 0x05,                                 /* syscall               */
+    0x48, 0x83, 0xc4, 0x20,                     /* add rsp, 32           */
+    0xc3,                                       /* ret                   */
+    /* rt_restore: return from the signal handler */
+    0xb8, 0x0f, 0x00, 0x00, 0x00,               /* mov eax, SYS_RT_SIGRETURN */
+    0x0f, 0x05,                                 /* syscall               */
+    /* rt_getc: return the next input character in EAX, reading a chunk
+       once the buffer is used up, the end of input ends the line */
+    0x48, 0x8b, 0x34, 0x25, 0x08, 0x00, 0x01, 0x00, /* mov rsi, [IPOS] */
+    0x48, 0x3b, 0x34, 0x25, 0x10, 0x00, 0x01, 0x00, /* cmp rsi, [ILEN] */
+    0x73, 0x13,                                 /* jae .read             */
+    0x0f, 0xb6, 0x86, 0x18, 0x00, 0x01, 0x00,   /* movzx eax, [rsi+IBUF] */
+    0x48, 0xff, 0xc6,                           /* inc rsi               */
+    0x48, 0x89, 0x34, 0x25, 0x08, 0x00, 0x01, 0x00, /* mov [IPOS], rsi */
+    0xc3,                                       /* ret                   */
+    0xe8, 0xa1, 0xfe, 0xff, 0xff,               /* .read: call rt_flush  */
+    0x31, 0xc0,                                 /* xor eax, eax          */
+    0x31, 0xff,                                 /* xor edi, edi          */
+    0xbe, 0x18, 0x00, 0x01, 0x00,               /* mov esi, IBUF         */
+    0xba, 0x00, 0x00, 0x01, 0x00,               /* mov edx, X86_INPUT_SIZE */
+    0x0f, 0x05,                                 /* syscall               */
+    0x48, 0x85, 0xc0,                           /* test rax, rax         */
+    0x7e, 0x16,                                 /* jle .end              */
+    0x48, 0x89, 0x04, 0x25, 0x10, 0x00, 0x01, 0x00, /* mov [ILEN], rax */
+    0x48, 0xc7, 0x04, 0x25, 0x08, 0x00, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00,                     /* mov qword [IPOS], 0   */
+    0xeb, 0xab,                                 /* jmp rt_getc           */
+    0xb8, 0x0a, 0x00, 0x00, 0x00,               /* .end: mov eax, 10     */
+    0xc3,                                       /* ret                   */
+    /* rt_input: read a line, return its integer in RAX */
+    0x31, 0xdb,                                 /* xor ebx, ebx          */
+    0x45, 0x31, 0xc0,                           /* xor r8d, r8d          */
+    0xe8, 0x9b, 0xff, 0xff, 0xff,               /* call rt_getc          */
+    0x83, 0xf8, 0x2d,                           /* cmp eax, '-'          */
+    0x75, 0x08,                                 /* jne .digit            */
+    0x41, 0xff, 0xc0,                           /* inc r8d               */
+    0xe8, 0x8e, 0xff, 0xff, 0xff,               /* .next: call rt_getc   */
+    0x83, 0xe8, 0x30,                           /* .digit: sub eax, '0'  */
+    0x83, 0xf8, 0x09,                           /* cmp eax, 9            */
+    0x77, 0x0a,                                 /* ja .skip              */
+    0x48, 0x8d, 0x1c, 0x9b,                     /* lea rbx, [rbx+rbx*4]  */
+    0x48, 0x8d, 0x1c, 0x58,                     /* lea rbx, [rax+rbx*2]  */
+    0xeb, 0xe9,                                 /* jmp .next             */
+    0x83, 0xc0, 0x30,                           /* .skip: add eax, '0'   */
+    0x83, 0xf8, 0x0a,                           /* .line: cmp eax, 10    */
+    0x74, 0x07,                                 /* je .sign              */
+    0xe8, 0x6f, 0xff, 0xff, 0xff,               /* call rt_getc          */
+    0xeb, 0xf4,                                 /* jmp .line             */
+    0x48, 0x89, 0xd8,                           /* .sign: mov rax, rbx   */
+    0x45, 0x85, 0xc0,                           /* test r8d, r8d         */
+    0x74, 0x03,                                 /* jz .done              */
+    0x48, 0xf7, 0xd8,                           /* neg rax               */
+    0xc3,                                       /* .done: ret            */
+  };
+
+short use_nasm = FALSE;     ///< Assemble and link with NASM and ld
+short run_jit = FALSE;      ///< Run the program in memory with --run
+
+/*
+ * ==================================
+ * INTERPRETER data structures and variables used
+ * ==================================
+ */
+
+/// Bytecode opcodes, one byte each. bc_Push takes a 32 bit constant,
+/// variable commands a 32 bit data index and jumps a 32 bit code offset,
+/// all little endian. Opcodes from bc_OpCount on are the superinstructions
+/// of bc_super.h, followed by the operands of the opcodes they fuse.
+typedef enum bc_op
+{
+  bc_Halt,
+  bc_Push,
+  bc_Fetch,
+  bc_Store,
+  bc_StoreKeep,
+  bc_Add,
+  bc_Sub,
+  bc_Mul,
+  bc_Div,
+  bc_Mod,
+  bc_Negate,
+  bc_Eq,
+  bc_Neq,
+  bc_Lss,
+  bc_Gtr,
+  bc_Leq,
+  bc_Geq,
+  bc_And,
+  bc_Or,
+  bc_Not,
+  bc_Jmp,
+  bc_Jz,
+  bc_Jnz,
+  bc_Jeq,
+  bc_Jneq,
+  bc_Jlss,
+  bc_Jgtr,
+  bc_Jleq,
+  bc_Jgeq,
+  bc_Prts,
+  bc_Prti,
+  bc_Input,
+  bc_OpCount,
+} bc_op_e;
+
+/// Bytecode by assembly code, bc_OpCount if not a command
+const unsigned char bc_ops[] =
+  {
+    [asm_NOP] = bc_OpCount, [asm_EOF] = bc_OpCount, [asm_Ident] = bc_OpCount,
+    [asm_Int] = bc_OpCount, [asm_String] = bc_OpCount,
+    [asm_Assign] = bc_OpCount, [asm_Add] = bc_Add, [asm_Sub] = bc_Sub,
+    [asm_Mul] = bc_Mul, [asm_Div] = bc_Div, [asm_Mod] = bc_Mod,
+    [asm_Eq] = bc_Eq, [asm_Neq] = bc_Neq, [asm_Lss] = bc_Lss,
+    [asm_Gtr] = bc_Gtr, [asm_Leq] = bc_Leq, [asm_Geq] = bc_Geq,
+    [asm_And] = bc_And, [asm_Or] = bc_Or, [asm_Negate] = bc_Negate,
+    [asm_Not] = bc_Not, [asm_Fetch] = bc_Fetch, [asm_Store] = bc_Store,
+    [asm_Push] = bc_Push, [asm_Jmp] = bc_Jmp, [asm_Jz] = bc_Jz,
+    [asm_Jnz] = bc_Jnz, [asm_Label] = bc_OpCount, [asm_Prts] = bc_Prts,
+    [asm_Prti] = bc_Prti, [asm_HALT] = bc_Halt, [asm_Input] = bc_Input,
+    [asm_Jeq] = bc_Jeq, [asm_Jneq] = bc_Jneq, [asm_Jlss] = bc_Jlss,
+    [asm_Jgtr] = bc_Jgtr, [asm_Jleq] = bc_Jleq, [asm_Jgeq] = bc_Jgeq,
+    [asm_StoreKeep] = bc_StoreKeep,
+  };
+
+/// Bytecode program, either built by bc_encode() or mapped from a file
+typedef struct bc_image
+{
+  unsigned char *code;        ///< opcodes followed by their operands
+  uint32_t code_len;          ///< number of code bytes
+  unsigned char *pool;        ///< strings as printed by the program
+  uint32_t pool_len;          ///< number of pool bytes
+  uint32_t *str_at;           ///< pool offset and length of every string
+  uint32_t strs_len;          ///< number of strings
+  uint32_t vars_len;          ///< number of variables
+  uint32_t stack_max;         ///< deepest operand stack of the program
+  void *map;                  ///< file mapping, NULL if built by bc_encode()
+  size_t map_len;             ///< number of bytes mapped
+} bc_image_s;
+
+/// Input read by the program, kept between input() calls like rt_input
+typedef struct bc_input
+{
+  uint64_t pos;               ///< offset of the next byte to parse
+  uint64_t len;               ///< number of bytes read
+  unsigned char buf[X86_INPUT_SIZE];    ///< bytes read
+} bc_input_s;
+
+#define BC_AT_OP 1                  ///< Opcode starts at the code offset
+#define BC_AT_TARGET 2              ///< Jumps go to the code offset
+
+#define OPB_MAGIC "OPB"             ///< First bytes of a bytecode file
+#define OPB_VERSION 2               ///< Bumped with every bytecode change
+
+/// Header of a bytecode file. Offsets are from the start of the file, so the
+/// file runs wherever it is mapped. The string table of pool offset and
+/// length pairs follows the header, then the pool and the code. All values
+/// are little endian.
+typedef struct opb_header
+{
+  char magic[4];              ///< OPB_MAGIC, NUL terminated
+  uint32_t version;           ///< OPB_VERSION of the writer
+  uint32_t str_at_off;        ///< offset of the string table
+  uint32_t strs_len;          ///< number of strings
+  uint32_t pool_off;          ///< offset of the string pool
+  uint32_t pool_len;          ///< number of pool bytes
+  uint32_t code_off;          ///< offset of the code
+  uint32_t code_len;          ///< number of code bytes
+  uint32_t vars_len;          ///< number of variables
+  uint32_t stack_max;         ///< deepest operand stack of the program
+  uint32_t ops_id;            ///< BC_SUPER_ID of the superinstructions used
+} opb_header_s;
+
+short run_bc = FALSE;       ///< Interpret the program with --interpret
+short write_bc = FALSE;     ///< Write a bytecode file with --bytecode
+short bc_super = TRUE;      ///< Fuse superinstructions, off with --no-super
+
 /*
  * ==================================
  * COMMON FUNCTION DECLARATIONS
@@ -362,80 +947,134 @@ void opal_log (log_level_e, const char*, int, const char*, const char*, ...);
 void banner (const char*);
 /// Close open files, flush buffers and exit
 short opal_exit (short);
-/// Read next character from source file
-int read_next_char(void);
 /// Initialize HTML report
 short init_report (FILE*);
 /// Close HTML report
 short close_report(FILE*);
+/// Append characters to in-memory buffer
+void append_char_buf (char_buf_s*, const char*, size_t);
+/// Free in-memory buffer
+void free_char_buf (char_buf_s*);
+/// Read whole file into in-memory buffer
+short read_file (const char*, char_buf_s*);
+/// Allocate zeroed memory from arena
+void *arena_alloc (arena_s*, size_t);
+/// Release all allocations of arena, keeping a chunk for reuse
+void arena_reset (arena_s*);
+/// Free all memory of arena
+void arena_free (arena_s*);
+/// Hash characters with 32-bit FNV-1a
+unsigned int hash_str (const char*, size_t);
+/// Resize hash slots of string table
+void rehash_str_table (unsigned int);
+/// Intern characters in string table and return their id
+unsigned int intern_str (const char*, size_t);
+/// Get interned string for an id
+const char *get_interned_str (unsigned int);
+/// Free memory used by string table
+void free_str_table (void);
 
 /*
  * ==================================
  * MARC FUNCTION DECLARATIONS
  * ==================================
  */
-/// Read source, remove comments, write to destination
-short rem_comments(FILE*, FILE*);
-/// Process include files, write to destination
-short proc_includes(FILE*, FILE*);
+/// Remove comments and expand includes from source buffer into destination
+short marc_preprocess (const char_buf_s*, char_buf_s*);
+/// Remove comments from text, optionally expanding includes, into destination
+short marc_scan (const char*, size_t, char_buf_s*, bool);
+/// Append contents of an include file to destination
+short proc_include (const char*, size_t, char_buf_s*);
 /// Append MARC output to HTML report file
-short print_marc_html(FILE*, FILE*);
+short print_marc_html(const char_buf_s*, FILE*);
 
 /*
  * ==================================
  * ALEX FUNCTION DECLARATIONS
  * ==================================
  */
+/// Point lexer cursor at start of source buffer
+void init_lexer (const char_buf_s*);
+/// Derive line and column number from offset in source buffer
+void get_line_col (int, int*, int*);
 /// Get lexeme for a string literal
-lexeme_s get_string_literal_lexeme(int, int);
-/// Get lexeme for binary or unary operator
-lexeme_type_e binary_unary (char, lexeme_type_e, lexeme_type_e, int, int);
+lexeme_s get_string_literal_lexeme(int);
 /// Get identifier lexeme
-lexeme_s get_identifier_lexeme (int, int);
+lexeme_s get_identifier_lexeme (int, lexeme_type_e);
 /// Get the next lexeme
 lexeme_s get_next_lexeme(void);
 /// Stringify lexeme
-short get_lexeme_str(const lexeme_s*, char*, int);
+short get_lexeme_str(const symbol_table_s*, int, char*, int);
+/// Append lexeme to symbol table
+void append_symbol (symbol_table_s*, const lexeme_s*);
+/// Get string or identifier value of lexeme in symbol table
+const char *get_symbol_str (const symbol_table_s*, int);
 /// Populate symbol table with lexemes in source file pointer
-short build_symbol_table (lexeme_s*, int*);
+short build_symbol_table (symbol_table_s*);
 /// Print symbol table to destination file pointer
-short print_symbol_table (lexeme_s*, FILE*);
-/// Determine if regular expression is an integer
-bool match(const char *str, const char *pattern);
+short print_symbol_table (const symbol_table_s*, FILE*);
 /// Print symbol table to HTML report
-short print_symbol_table_html (lexeme_s*, FILE*);
-/// Free symbol table linked list
-void free_symbol_table (lexeme_s*);
+short print_symbol_table_html (const symbol_table_s*, FILE*);
+/// Free symbol table arrays
+void free_symbol_table (symbol_table_s*);
 /// Traverse syntax tree for output file generation
-void traverse_ast (node_s *node, FILE *dest_fp);
+void traverse_ast (unsigned int node, FILE *dest_fp);
 
 /*
  * ==================================
  * ASTRO FUNCTION DECLARATIONS
  * ==================================
  */
+/// Grow array of node indices to hold at least the given number of indices
+void grow_index_array (unsigned int**, unsigned int*, unsigned int);
+/// Append node to syntax tree node array
+unsigned int add_ast_node (ast_node_type_e);
+/// Add statement to the innermost block being parsed
+void add_block_stmt (unsigned int);
+/// Close block of statements added since mark and return its node
+unsigned int make_block_node (unsigned int);
+/// Build and return syntax tree node with given children
+unsigned int make_ast_node (ast_node_type_e, unsigned int, unsigned int);
+/// Start pre-order traversal of syntax tree at node
+void ast_walk_start (ast_walk_s*, unsigned int);
+/// Return next node of pre-order traversal, 0 when done
+unsigned int ast_walk_next (ast_walk_s*);
+/// Free syntax tree traversal stack
+void ast_walk_end (ast_walk_s*);
 /// Build abstract syntax tree from symbol table
-node_s* build_syntax_tree (lexeme_s*);
+unsigned int build_syntax_tree (const symbol_table_s*);
 /// Build and return statement node
-node_s* make_statement_node(void);
+unsigned int make_statement_node(void);
 /// Build and return expression inside parantheses
-node_s *make_parentheses_expression(void);
+unsigned int make_parentheses_expression(void);
+/// Push step of expression parser on ast.expr
+void push_expr_frame (int, ast_node_type_e, unsigned int, short);
 /// Build expression node
-node_s *make_expression_node(int);
+unsigned int make_expression_node(int);
 /// Check if lexeme is expected type, else print error and exit
 void expect_lexeme(lexeme_type_e);
 /// Build and return leaf nodes for identifier/integer/strings
-node_s *make_leaf_node(ast_node_type_e, lexeme_s*);
+unsigned int make_leaf_node(ast_node_type_e, int);
+/// Evaluate operator on constants as the runtime would
+short eval_constant (ast_node_type_e, int, int, int*);
+/// Replace operators on constants with their value
+void fold_constants (void);
+/// Check if statement never completes
+short is_endless (unsigned int);
+/// Remove empty, never run and unreachable statements from syntax tree
+unsigned int prune_syntax_tree (unsigned int);
 /// Optimize the abstract syntax tree
-node_s* optimize_syntax_tree(node_s*);
+unsigned int optimize_syntax_tree(unsigned int);
+/// Print constants folded by optimize_syntax_tree() to HTML report
+short print_folds_html (FILE*);
 /// Print abstract syntax tree to destination file
-short print_ast (node_s*, FILE*);
+short print_ast (unsigned int, FILE*);
 /// Traverse abstract syntax tree pre-order
-void traversePreOrder_grah (node_s*, FILE*, int);
+void traversePreOrder_graph (unsigned int, FILE*);
 /// Print abstract syntax tree to HTML report
-short print_ast_html (node_s*, FILE*);
+short print_ast_html (unsigned int, FILE*);
 /// Free syntax tree
-void free_syntax_tree (node_s*);
+void free_syntax_tree (void);
 
 /*
  * ==================================
@@ -443,17 +1082,67 @@ void free_syntax_tree (node_s*);
  * ==================================
  */
 /// Append ASM code to array
-void add_asm_code (asm_code_e, int, char*);
+void add_asm_code (asm_code_e, int, const char*);
+/// Check whether assembly command jumps to its label
+short is_jump (asm_code_e);
+/// Push code generation task
+void push_asm_task (asm_task_e, unsigned int, asm_code_e, int, const char*);
+/// Run code generation tasks down to given stack length
+void run_asm_tasks (unsigned int);
 /// Build assembly code list from abstract syntax tree
-void gen_asm_code(node_s*);
+void gen_asm_code(unsigned int);
+/// Push steps generating the code of a syntax tree node
+void expand_asm_code (unsigned int);
+/// Push steps of a conditional jump, short-circuiting && and ||
+void expand_asm_jump (unsigned int, short, const char*);
+/// Apply peephole rule to the tail of assembly code list
+short peephole_rewrite (peephole_rule_e, asm_cmd_e[], unsigned int*);
+/// Rewrite redundant patterns in assembly code list
+void optimize_asm_code (void);
+/// Print peephole rule hit counts to HTML report file
+short print_peephole_html (FILE*);
+/// Get cache slot of operand stack position
+int reg_slot (int);
+/// Get register of operand stack position
+const char* reg_name (int);
+/// Format operand stack entry as instruction operand
+const char* format_opnd (char*, const opnd_s*, int);
+/// Spill bottom cached operand stack entry to the hardware stack
+void reg_spill (FILE*);
+/// Spill all cached operand stack entries to the hardware stack
+void reg_flush (FILE*);
+/// Push entry on operand stack
+void reg_push (FILE*, opnd_kind_e, int);
+/// Pop entry from operand stack
+opnd_s reg_pop (FILE*);
+/// Load operand stack entry into the register of its position
+const char* reg_load (FILE*, opnd_s*, int);
+/// Load cached entries of a variable before it is stored to
+void reg_reload_var (FILE*, int);
+/// Choose variables kept in registers and print their initialization
+void pin_hot_vars (FILE*);
+/// Format variable as instruction operand
+const char* format_var (char*, int);
+/// Print assembly code list as register code
+void print_reg_code (FILE*);
 /// Print assembly code list
 short print_asm_code(asm_cmd_e[], FILE*);
 /// Print assembly code list to HTML report file
 short print_asm_code_html(asm_cmd_e[], FILE*);
+/// Print value of expression node as C operand
+void print_c_value (unsigned int, FILE*);
+/// Print C statements computing expression of syntax tree
+void print_c_expr (unsigned int, int, FILE*);
+/// Print statement of syntax tree as C statement
+void print_c_stmt (unsigned int, int, FILE*);
+/// Print syntax tree as C program
+short print_c_code (unsigned int, FILE*);
+/// Grow slot lookup array to cover all interned ids
+void grow_slot_map (unsigned int**, unsigned int*);
 /// Create Identifier array
-int add_var(char*);
+int add_var(unsigned int);
 /// Create String array
-int add_str(char*);
+int add_str(unsigned int);
 /// Free memory used by ASM arrays
 short free_asm_arrays();
 
@@ -466,5 +1155,61 @@ short free_asm_arrays();
 short gen_obj(char*, char*);
 /// Link object using LD
 short gen_bin(char*, char*);
+/// Compile C program using gcc
+short gen_c_bin (char*, char*);
+/// Append bytes to x86 image code
+void x86_emit (x86_image_s*, const char*, unsigned int);
+/// Append 32 bit little endian value to x86 image code
+void x86_emit_u32 (x86_image_s*, uint32_t);
+/// Append jump to label, patched by x86_patch_jumps()
+void x86_emit_jump (x86_image_s*, const char*, unsigned int, unsigned int);
+/// Append call of x86_runtime routine
+void x86_emit_call (x86_image_s*, unsigned int);
+/// Append push, pop or copy of a variable pinned to a register
+void x86_emit_pinned (x86_image_s*, asm_code_e, int);
+/// Patch jump offsets once all labels are placed
+void x86_patch_jumps (x86_image_s*);
+/// Encode string as printed by the program
+unsigned int encode_str (unsigned char*, const char*);
+/// Get size of the data encoded by x86_encode()
+unsigned int x86_data_len (void);
+/// Encode assembly command list as x86-64 machine code and data
+short x86_encode (x86_image_s*, uint64_t);
+/// Write x86 image as static ELF64 executable
+short gen_elf (x86_image_s*, char*);
+/// Free memory used by x86 image
+void free_x86_image (x86_image_s*);
+/// Run assembly command list in memory
+short x86_run (void);
+
+/*
+ * ==================================
+ * INTERPRETER FUNCTION DECLARATIONS
+ * ==================================
+ */
+/// Encode assembly command list as bytecode
+short bc_encode (bc_image_s*);
+/// Select opcode, maybe a superinstruction, for the commands at an index
+unsigned char bc_select (unsigned int, unsigned int*);
+/// Divide like IDIV with RDX cleared
+short bc_idiv (uint64_t, int64_t, int64_t*, int64_t*);
+/// Write bytes to stdout like the print macros
+int64_t bc_write (const void*, uint64_t);
+/// Print integer like O_PRTI
+int64_t bc_prti (int64_t);
+/// Get next input character like rt_getc
+int bc_getc (bc_input_s*);
+/// Read integer like _INPUT_
+int64_t bc_input (bc_input_s*);
+/// Run bytecode program
+int bc_run (const bc_image_s*);
+/// Write bytecode image as bytecode file
+short write_opb (const bc_image_s*, FILE*);
+/// Verify bytecode before it is run
+short bc_verify (const bc_image_s*);
+/// Map bytecode file as bytecode image
+short map_opb (const char*, bc_image_s*);
+/// Free memory used by bytecode image
+void free_bc_image (bc_image_s*);
 
 #endif /* OPAL_H_ */
@@ -1,9 +1,13 @@
   ;=== User code end ===;
 
 SECTION .bss
-  bss0 RESB 255          ; reserve 255 bytes for user input
+  olen RESQ 1            ; Number of bytes in output buffer
+  obuf RESB OUT_SIZE     ; Output buffer
+  ipos RESQ 1            ; Next character of input buffer to parse
+  ilen RESQ 1            ; Number of characters in input buffer
+  ibuf RESB IN_SIZE      ; Input buffer
 
 SECTION .data
-  char  DB 0             ; Used for user input
+  fpe_act DQ o_flush, SA_RESTORER | SA_RESETHAND, o_restore, 0 ; SIGFPE action
 
   ;=== User variables ===;
@@ -0,0 +1,241 @@
+/* Runtime of the C backend, copied ahead of the program by print_c_code().
+ * The functions follow the macros of res/header.asm, so a program compiled
+ * from C prints the same bytes and exits with the same code as the native
+ * one. Output is buffered and written when the buffer is full, before
+ * input is read and when the program halts. Input is read in chunks.
+ */
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Constants for better code readability */
+#define OUT_SIZE 65536              /* Bytes buffered before a write */
+#define IN_SIZE 65536               /* Bytes read at a time */
+
+/* String of the program, bytes as printed and their count */
+typedef struct o_str
+{
+  const unsigned char *str;
+  size_t len;
+} o_str_s;
+
+static unsigned char out_buf[OUT_SIZE];     /* Output waiting for write */
+static size_t out_len = 0;                  /* Bytes in out_buf */
+static unsigned char in_buf[IN_SIZE];       /* Input read */
+static size_t in_pos = 0;                   /* Next byte of in_buf to parse */
+static size_t in_len = 0;                   /* Bytes in in_buf */
+
+/* ============================================================================
+ * Output
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Function - o_write
+ * Desc     - Write bytes to stdout with one system call, exit with the
+ *            result of a short write like the print macros do
+ * ------------------------------------------------------------------------- */
+static void
+o_write (const unsigned char *buf, size_t len)
+{
+  ssize_t written = len ? write (STDOUT_FILENO, buf, len) : 0;
+
+  if (written != (ssize_t) len)
+    _exit (written < 0 ? -errno : written);
+}
+
+/* ----------------------------------------------------------------------------
+ * Function - o_flush
+ * Desc     - Write buffered output
+ * ------------------------------------------------------------------------- */
+static void
+o_flush (void)
+{
+  o_write (out_buf, out_len);
+  out_len = 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Function - o_prts
+ * Desc     - Print string like O_PRTS, NUL terminator included
+ * ------------------------------------------------------------------------- */
+static void
+o_prts (const unsigned char *str, size_t len)
+{
+  if (out_len + len > OUT_SIZE)
+    o_flush ();
+  if (len > OUT_SIZE)
+    o_write (str, len);
+  else
+    {
+      memcpy (out_buf + out_len, str, len);
+      out_len += len;
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Function - o_prti
+ * Desc     - Print integer like O_PRTI, a '-' for negative values, then the
+ *            digits of the magnitude
+ * ------------------------------------------------------------------------- */
+static void
+o_prti (int64_t value)
+{
+  unsigned char digits[24];
+  unsigned char *start = digits + sizeof(digits);
+  uint64_t mag = value;
+
+  if (value < 0)
+    mag = -mag;
+  do
+    {
+      *--start = '0' + mag % 10;
+      mag /= 10;
+    }
+  while (mag);
+  if (value < 0)
+    *--start = '-';
+
+  o_prts (start, digits + sizeof(digits) - start);
+}
+
+/* ============================================================================
+ * Input
+ * ========================================================================= */
+
+/* ----------------------------------------------------------------------------
+ * Function - o_getc
+ * Desc     - Get next input character, reading a chunk once those read are
+ *            used up, after writing the output. The end of input ends the
+ *            line.
+ * ------------------------------------------------------------------------- */
+static inline int
+o_getc (void)
+{
+  if (in_pos == in_len)
+    {
+      ssize_t got = 0;
+
+      o_flush ();
+      if ((got = read (STDIN_FILENO, in_buf, IN_SIZE)) <= 0)
+        return '\n';
+      in_pos = 0;
+      in_len = got;
+    }
+
+  return in_buf[in_pos++];
+}
+
+/* ----------------------------------------------------------------------------
+ * Function - o_input
+ * Desc     - Print prompt and read integer like _INPUT_: an optional '-',
+ *            then the digits up to the first other character of the line,
+ *            wrapping at 64 bits. The rest of the line is skipped.
+ * ------------------------------------------------------------------------- */
+static int64_t
+o_input (const unsigned char *prompt, size_t len)
+{
+  uint64_t value = 0, digit = 0;
+  int c = 0, neg = 0;
+
+  o_prts (prompt, len);
+
+  if ((c = o_getc ()) == '-')
+    {
+      neg = 1;
+      c = o_getc ();
+    }
+  while ((digit = (unsigned) c - '0') <= 9)
+    {
+      value = value * 10 + digit;
+      c = o_getc ();
+    }
+  while (c != '\n')
+    c = o_getc ();
+
+  return neg ? -value : value;
+}
+
+/* ============================================================================
+ * Arithmetic, wrapping at 64 bits like the registers do
+ * ========================================================================= */
+
+static inline int64_t
+o_add (int64_t a, int64_t b)
+{
+  return (uint64_t) a + (uint64_t) b;
+}
+
+static inline int64_t
+o_sub (int64_t a, int64_t b)
+{
+  return (uint64_t) a - (uint64_t) b;
+}
+
+static inline int64_t
+o_mul (int64_t a, int64_t b)
+{
+  return (uint64_t) a * (uint64_t) b;
+}
+
+static inline int64_t
+o_neg (int64_t a)
+{
+  return -(uint64_t) a;
+}
+
+/* ----------------------------------------------------------------------------
+ * Function - o_fault
+ * Desc     - Raise SIGFPE like a faulting IDIV, after the output so far
+ * ------------------------------------------------------------------------- */
+static void
+o_fault (void)
+{
+  o_flush ();
+  signal (SIGFPE, SIG_DFL);
+  raise (SIGFPE);
+  _exit (EXIT_FAILURE);
+}
+
+/* ----------------------------------------------------------------------------
+ * Function - o_idiv
+ * Desc     - Divide like O_DIV and O_MOD, IDIV with RDX cleared: the
+ *            dividend is unsigned and the quotient must fit 64 signed bits
+ * ------------------------------------------------------------------------- */
+static inline uint64_t
+o_idiv (uint64_t a, int64_t b, uint64_t *rem)
+{
+  uint64_t d = b < 0 ? -(uint64_t) b : (uint64_t) b;
+
+  if (d == 0 || (b == 1 && a >> 63) || (b == -1 && a > (uint64_t) 1 << 63))
+    o_fault ();
+
+  *rem = a % d;
+  return b < 0 ? -(a / d) : a / d;
+}
+
+static inline int64_t
+o_div (int64_t a, int64_t b)
+{
+  uint64_t rem = 0;
+  return o_idiv (a, b, &rem);
+}
+
+static inline int64_t
+o_mod (int64_t a, int64_t b)
+{
+  uint64_t rem = 0;
+  o_idiv (a, b, &rem);
+  return rem;
+}
+
+/* ============================================================================
+ * Strings, by their index in o_strs[] that follows
+ * ========================================================================= */
+
+#define O_PRTS(i) o_prts (o_strs[i].str, o_strs[i].len)
+#define O_INPUT(i) o_input (o_strs[i].str, o_strs[i].len)
+
+/* ========================= User program start ========================= */
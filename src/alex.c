@@ -97,7 +97,7 @@ static struct argp argp =
 
 /**
  * @brief       Main function for pre-processor alex
- * @details     Calls the function remove_comments() and proc_includes()
+ * @details     Calls the function marc_preprocess()
  * to process the user input file. Calls the build_symbol_table() to build
  * symbol table and and writes to the destination.
  *
@@ -216,19 +216,10 @@ main (int argc, char **argv)
       dest_fp = stdout;
     }
 
-  /// Open source file in read-only mode
-  sprintf (perror_msg, "source_fp = fopen('%s', 'r')", source_fn);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  source_fp = fopen (source_fn, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
+  /// Read source file into memory
+  retVal = read_file (source_fn, &source_buf);
+  if (retVal != EXIT_SUCCESS)
+    return (opal_exit (retVal));
 
   /// Check if report file exists
   sprintf (perror_msg, "access('%s', F_OK)", report_fn);
@@ -270,286 +261,45 @@ main (int argc, char **argv)
   /// Call MARC functions to pre-process source file
   banner ("MARC start.");
 
-  /// Create and open temp destination file for remove_comments()
-  char *rc_tmp = "tmp/marc_rc.tmp";
-  logger(DEBUG, "rc_tmp: '%s'", rc_tmp);
-
-  /// If temp file can not be written, print error and exit
-  sprintf (perror_msg, "rc_fp = fopen('%s', 'wb')", rc_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  FILE *rc_fp = fopen (rc_tmp, "wb");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Remove comments from source with rem_comments(), write to rc_tmp
-  retVal = rem_comments (source_fp, rc_fp);
+  /// Remove comments and process #include directives with marc_preprocess()
+  retVal = marc_preprocess (&source_buf, &marc_buf);
   if (retVal != EXIT_SUCCESS)
     return (opal_exit (retVal));
 
-  /// Close source file pointer source_fp if not NULL
-  sprintf (perror_msg, "fclose(source_fp)");
-  logger(DEBUG, perror_msg);
-  if (source_fp)
-    {
-      if (fclose (source_fp) == EXIT_SUCCESS)
-        {
-          _PASS;
-          source_fp = NULL;
-        }
-      else
-        {
-          _FAIL;
-          perror (perror_msg);
-          return (errno);
-        }
-    }
-
-  /// Close rem_comments() temp file pointer rc_fp if not NULL
-  sprintf (perror_msg, "fclose(rc_fp)");
-  logger(DEBUG, perror_msg);
-  if (rc_fp)
-    {
-      if (fclose (rc_fp) == EXIT_SUCCESS)
-        {
-          _PASS;
-          rc_fp = NULL;
-        }
-      else
-        {
-          _FAIL;
-          perror (perror_msg);
-          return (errno);
-        }
-    }
-
-  /// Open rem_comments() temp file in read mode, else print error and exit
-  sprintf (perror_msg, "rc_fp = fopen('%s', 'r')", rc_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  rc_fp = fopen (rc_tmp, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Create and open temp destination file for proc_includes()
-  char *pi_tmp = "tmp/marc_pi.tmp";
-  logger(DEBUG, "pi_tmp: '%s'", pi_tmp);
-
-  /// If temp file can not be written, print error and exit
-  sprintf (perror_msg, "pi_fp = fopen('%s', 'wb')", pi_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  FILE *pi_fp = fopen (pi_tmp, "wb");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Process #include directives from source with proc_includes()
-  retVal = proc_includes (rc_fp, pi_fp);
-  if (retVal != EXIT_SUCCESS)
-    {
-      return (opal_exit (retVal));
-    }
-
-  /// Close rem_comments temp file pointer if not NULL
-  if (rc_fp)
-    {
-      sprintf (perror_msg, "fclose(rc_fp)");
-      logger(DEBUG, perror_msg);
-
-      if (fclose (rc_fp) == EXIT_SUCCESS)
-        {
-          _PASS;
-          rc_fp = NULL;
-        }
-      else
-        {
-          _FAIL;
-          perror (perror_msg);
-          return (errno);
-        }
-    }
-
-  /// Close proc_includes() temp file pointer if not NULL
-  if (pi_fp)
-    {
-      sprintf (perror_msg, "fclose(pi_fp)");
-      logger(DEBUG, perror_msg);
-
-      if (fclose (pi_fp) == EXIT_SUCCESS)
-        {
-          _PASS;
-          pi_fp = NULL;
-        }
-      else
-        {
-          _FAIL;
-          perror (perror_msg);
-          return (errno);
-        }
-    }
-
-  /// Open proc_includes() temp file in read mode, else print error and exit
-  sprintf (perror_msg, "pi_fp = fopen('%s', 'r')", pi_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  pi_fp = fopen (pi_tmp, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Open rem_comments() temp file in write mode, else print error and exit
-  sprintf (perror_msg, "rc_fp = fopen('%s', 'wb')", rc_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  rc_fp = fopen (rc_tmp, "wb");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Remove comments from includs files with rem_comments(), write to rc_tmp
-  retVal = rem_comments (pi_fp, rc_fp);
-  if (retVal != EXIT_SUCCESS)
-    {
-      return (opal_exit (retVal));
-    }
-
-  /// Close proc_includes() temp file pointer, else print error and exit
-  sprintf (perror_msg, "fclose(pi_fp)");
-  logger(DEBUG, perror_msg);
-  if (fclose (pi_fp) == EXIT_SUCCESS)
-    {
-      _PASS;
-      pi_fp = NULL;
-    }
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Close rem_comments() temp file pointer, else print error and exit
-  sprintf (perror_msg, "fclose(rc_fp)");
-  logger(DEBUG, perror_msg);
-  if (fclose (rc_fp) == EXIT_SUCCESS)
-    {
-      _PASS;
-      rc_fp = NULL;
-    }
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Open rem_comments() temp file in read mode, else print error and exit
-  sprintf (perror_msg, "rc_fp = fopen('%s', 'r')", rc_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  rc_fp = fopen (rc_tmp, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
   /// Append MARC output to HTML report
-  retVal = print_marc_html(rc_fp, report_fp);
+  retVal = print_marc_html (&marc_buf, report_fp);
   if (retVal != EXIT_SUCCESS)
-    {
-      return (opal_exit (retVal));
-    }
-
-  /// Close rem_comments() temp file pointer, else print error and exit
-  sprintf (perror_msg, "fclose(rc_fp)");
-  logger(DEBUG, perror_msg);
-  if (fclose (rc_fp) == EXIT_SUCCESS)
-    {
-      _PASS;
-      rc_fp = NULL;
-    }
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
+    return (opal_exit (retVal));
 
   /// Start lexical analyzer code
   banner ("ALEX start.");
 
-  /// Open rem_comments() temp file as source_fp, else print error and exit
-  sprintf (perror_msg, "source_fp = fopen('%s', 'r')", rc_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  source_fp = fopen (rc_tmp, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Create symbol table linked list
-  logger(DEBUG, "Create symbol_table linked list node.");
-  lexeme_s *symbol_table = (lexeme_s*) calloc (1, sizeof(lexeme_s));
+  /// Point lexer cursor at the MARC output buffer
+  init_lexer (&marc_buf);
 
-  int symbol_count = 0;                ///< Numbber of lexemes identified
+  /// Create empty symbol table
+  symbol_table_s symbol_table = { 0 };
 
-  /// Build symbol table using rem_comments() temp file as source
-  retVal = build_symbol_table (symbol_table, &symbol_count);
+  /// Build symbol table using MARC output buffer as source
+  retVal = build_symbol_table (&symbol_table);
   if (retVal != EXIT_SUCCESS)
     {
       return (opal_exit (retVal));
     }
 
-  logger(DEBUG, "assert(symbol_ct [%d] > 0)", symbol_count);
-  assert(symbol_count > 0);
+  logger(DEBUG, "assert(symbol_ct [%d] > 0)", symbol_table.count);
+  assert(symbol_table.count > 0);
   _PASS;
 
   /// Print symbol table with print_symbol_table() to destination
-  retVal = print_symbol_table (symbol_table, dest_fp);
+  retVal = print_symbol_table (&symbol_table, dest_fp);
   if (retVal != EXIT_SUCCESS)
     {
       return (opal_exit (retVal));
     }
 
   /// Print symbol table HTML report with print_symbol_table_html()
-  retVal = print_symbol_table_html (symbol_table, report_fp);
+  retVal = print_symbol_table_html (&symbol_table, report_fp);
   if (retVal != EXIT_SUCCESS)
     {
       return (opal_exit (retVal));
@@ -561,10 +311,9 @@ main (int argc, char **argv)
     opal_exit(retVal);
 
   /// Free memory used by symbol_table
-  free_symbol_table (symbol_table);
-  symbol_table = NULL;
+  free_symbol_table (&symbol_table);
 
-  /// source_fp, dest_fp, log_fp & report_fp closed by opal_exit()
+  /// dest_fp, log_fp & report_fp closed by opal_exit()
   return (opal_exit (EXIT_SUCCESS));
 }
 
@@ -0,0 +1,212 @@
+/// @file bc_super.h
+/// @brief Bytecode superinstructions generated by supergen from 1210 commands
+/// of 27 files, do not edit
+
+#define BC_SUPER_COUNT 32        ///< Number of superinstructions
+#define BC_SUPER_MAX 4           ///< Most opcodes fused by one
+#define BC_SUPER_ID 0x7dc58707  ///< Checksum of the opcode table
+
+/// Opcodes fused by each superinstruction, longest first, bc_OpCount ends
+const unsigned char bc_super_ops[BC_SUPER_COUNT + 1][BC_SUPER_MAX + 1] =
+  {
+    { bc_Fetch, bc_Push, bc_Add, bc_Store, bc_OpCount }, /* weight 520 */
+    { bc_Push, bc_Add, bc_Store, bc_Jmp, bc_OpCount }, /* weight 432 */
+    { bc_Store, bc_Fetch, bc_Push, bc_Add, bc_OpCount }, /* weight 217 */
+    { bc_Fetch, bc_Push, bc_Mod, bc_Push, bc_OpCount }, /* weight 208 */
+    { bc_Push, bc_Mod, bc_Push, bc_Jeq, bc_OpCount }, /* weight 192 */
+    { bc_Add, bc_Store, bc_Fetch, bc_Push, bc_OpCount }, /* weight 152 */
+    { bc_Fetch, bc_Push, bc_Add, bc_OpCount }, /* weight 538 */
+    { bc_Push, bc_Add, bc_Store, bc_OpCount }, /* weight 529 */
+    { bc_Add, bc_Store, bc_Jmp, bc_OpCount }, /* weight 432 */
+    { bc_Fetch, bc_Fetch, bc_Jgeq, bc_OpCount }, /* weight 273 */
+    { bc_Fetch, bc_Push, bc_Jlss, bc_OpCount }, /* weight 265 */
+    { bc_Store, bc_Fetch, bc_Push, bc_OpCount }, /* weight 242 */
+    { bc_Add, bc_Store, bc_Fetch, bc_OpCount }, /* weight 218 */
+    { bc_Fetch, bc_Push, bc_Jeq, bc_OpCount }, /* weight 209 */
+    { bc_Push, bc_Mod, bc_Push, bc_OpCount }, /* weight 208 */
+    { bc_Fetch, bc_Push, bc_Mod, bc_OpCount }, /* weight 208 */
+    { bc_Mod, bc_Push, bc_Jeq, bc_OpCount }, /* weight 192 */
+    { bc_Fetch, bc_Push, bc_Jneq, bc_OpCount }, /* weight 188 */
+    { bc_Fetch, bc_Push, bc_Jleq, bc_OpCount }, /* weight 144 */
+    { bc_Fetch, bc_Fetch, bc_Mul, bc_OpCount }, /* weight 138 */
+    { bc_Push, bc_Store, bc_Jmp, bc_OpCount }, /* weight 136 */
+    { bc_StoreKeep, bc_Push, bc_Jgeq, bc_OpCount }, /* weight 129 */
+    { bc_Fetch, bc_Push, bc_OpCount }, /* weight 1611 */
+    { bc_Add, bc_Store, bc_OpCount }, /* weight 670 */
+    { bc_Store, bc_Jmp, bc_OpCount }, /* weight 648 */
+    { bc_Fetch, bc_Fetch, bc_OpCount }, /* weight 640 */
+    { bc_Push, bc_Add, bc_OpCount }, /* weight 547 */
+    { bc_Push, bc_Jeq, bc_OpCount }, /* weight 401 */
+    { bc_Store, bc_Fetch, bc_OpCount }, /* weight 385 */
+    { bc_Fetch, bc_Jgeq, bc_OpCount }, /* weight 273 */
+    { bc_Push, bc_Store, bc_OpCount }, /* weight 272 */
+    { bc_Push, bc_Jlss, bc_OpCount }, /* weight 265 */
+    { bc_OpCount },
+  };
+
+/// Handlers of the superinstructions in bc_run()
+#define BC_SUPER_HANDLERS \
+  do_super_0: \
+    BC_DO_FETCH (0) BC_DO_PUSH (4) BC_DO_ADD (8) BC_DO_STORE (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_1: \
+    BC_DO_PUSH (0) BC_DO_ADD (4) BC_DO_STORE (4) BC_DO_JMP (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_2: \
+    BC_DO_STORE (0) BC_DO_FETCH (4) BC_DO_PUSH (8) BC_DO_ADD (12) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_3: \
+    BC_DO_FETCH (0) BC_DO_PUSH (4) BC_DO_MOD (8) BC_DO_PUSH (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_4: \
+    BC_DO_PUSH (0) BC_DO_MOD (4) BC_DO_PUSH (4) BC_DO_JEQ (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_5: \
+    BC_DO_ADD (0) BC_DO_STORE (0) BC_DO_FETCH (4) BC_DO_PUSH (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_6: \
+    BC_DO_FETCH (0) BC_DO_PUSH (4) BC_DO_ADD (8) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_7: \
+    BC_DO_PUSH (0) BC_DO_ADD (4) BC_DO_STORE (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_8: \
+    BC_DO_ADD (0) BC_DO_STORE (0) BC_DO_JMP (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_9: \
+    BC_DO_FETCH (0) BC_DO_FETCH (4) BC_DO_JGEQ (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_10: \
+    BC_DO_FETCH (0) BC_DO_PUSH (4) BC_DO_JLSS (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_11: \
+    BC_DO_STORE (0) BC_DO_FETCH (4) BC_DO_PUSH (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_12: \
+    BC_DO_ADD (0) BC_DO_STORE (0) BC_DO_FETCH (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_13: \
+    BC_DO_FETCH (0) BC_DO_PUSH (4) BC_DO_JEQ (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_14: \
+    BC_DO_PUSH (0) BC_DO_MOD (4) BC_DO_PUSH (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_15: \
+    BC_DO_FETCH (0) BC_DO_PUSH (4) BC_DO_MOD (8) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_16: \
+    BC_DO_MOD (0) BC_DO_PUSH (0) BC_DO_JEQ (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_17: \
+    BC_DO_FETCH (0) BC_DO_PUSH (4) BC_DO_JNEQ (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_18: \
+    BC_DO_FETCH (0) BC_DO_PUSH (4) BC_DO_JLEQ (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_19: \
+    BC_DO_FETCH (0) BC_DO_FETCH (4) BC_DO_MUL (8) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_20: \
+    BC_DO_PUSH (0) BC_DO_STORE (4) BC_DO_JMP (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_21: \
+    BC_DO_STOREKEEP (0) BC_DO_PUSH (4) BC_DO_JGEQ (8) \
+    pc += 12; \
+    BC_NEXT; \
+  do_super_22: \
+    BC_DO_FETCH (0) BC_DO_PUSH (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_23: \
+    BC_DO_ADD (0) BC_DO_STORE (0) \
+    pc += 4; \
+    BC_NEXT; \
+  do_super_24: \
+    BC_DO_STORE (0) BC_DO_JMP (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_25: \
+    BC_DO_FETCH (0) BC_DO_FETCH (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_26: \
+    BC_DO_PUSH (0) BC_DO_ADD (4) \
+    pc += 4; \
+    BC_NEXT; \
+  do_super_27: \
+    BC_DO_PUSH (0) BC_DO_JEQ (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_28: \
+    BC_DO_STORE (0) BC_DO_FETCH (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_29: \
+    BC_DO_FETCH (0) BC_DO_JGEQ (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_30: \
+    BC_DO_PUSH (0) BC_DO_STORE (4) \
+    pc += 8; \
+    BC_NEXT; \
+  do_super_31: \
+    BC_DO_PUSH (0) BC_DO_JLSS (4) \
+    pc += 8; \
+    BC_NEXT;
+
+/// Dispatch table entries of the superinstructions
+#define BC_SUPER_DISPATCH \
+  [bc_OpCount + 0] = &&do_super_0, \
+  [bc_OpCount + 1] = &&do_super_1, \
+  [bc_OpCount + 2] = &&do_super_2, \
+  [bc_OpCount + 3] = &&do_super_3, \
+  [bc_OpCount + 4] = &&do_super_4, \
+  [bc_OpCount + 5] = &&do_super_5, \
+  [bc_OpCount + 6] = &&do_super_6, \
+  [bc_OpCount + 7] = &&do_super_7, \
+  [bc_OpCount + 8] = &&do_super_8, \
+  [bc_OpCount + 9] = &&do_super_9, \
+  [bc_OpCount + 10] = &&do_super_10, \
+  [bc_OpCount + 11] = &&do_super_11, \
+  [bc_OpCount + 12] = &&do_super_12, \
+  [bc_OpCount + 13] = &&do_super_13, \
+  [bc_OpCount + 14] = &&do_super_14, \
+  [bc_OpCount + 15] = &&do_super_15, \
+  [bc_OpCount + 16] = &&do_super_16, \
+  [bc_OpCount + 17] = &&do_super_17, \
+  [bc_OpCount + 18] = &&do_super_18, \
+  [bc_OpCount + 19] = &&do_super_19, \
+  [bc_OpCount + 20] = &&do_super_20, \
+  [bc_OpCount + 21] = &&do_super_21, \
+  [bc_OpCount + 22] = &&do_super_22, \
+  [bc_OpCount + 23] = &&do_super_23, \
+  [bc_OpCount + 24] = &&do_super_24, \
+  [bc_OpCount + 25] = &&do_super_25, \
+  [bc_OpCount + 26] = &&do_super_26, \
+  [bc_OpCount + 27] = &&do_super_27, \
+  [bc_OpCount + 28] = &&do_super_28, \
+  [bc_OpCount + 29] = &&do_super_29, \
+  [bc_OpCount + 30] = &&do_super_30, \
+  [bc_OpCount + 31] = &&do_super_31,
+
@@ -0,0 +1,290 @@
+/// @file lexgen.c
+/// @brief Generates the ALEX DFA transition tables and keyword hash table
+///
+/// The operators are taken from grammar[] and the keywords from keyword_arr[]
+/// in libopal.h, so the tables follow any change to the lexeme definitions.
+/// Run by the Makefile before libopal is compiled:
+///
+///     build/lexgen build/lex_dfa.h
+///
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libopal.h"
+
+#define MAX_STATES 64           ///< Upper bound of DFA states generated
+#define MAX_CLASSES 64          ///< Upper bound of character classes
+#define MAX_KW_SIZE 256         ///< Upper bound of keyword hash table size
+
+int dfa[MAX_STATES][MAX_CLASSES] = { { 0 } };   ///< DFA transition table
+lexeme_type_e accept[MAX_STATES] = { 0 };       ///< Lexeme accepted by state
+int state_count = 0;            ///< Number of DFA states in use
+
+int char_class[256] = { 0 };    ///< Character class of every byte
+int class_count = 0;            ///< Number of character classes in use
+
+/**
+ * @brief       Add a new DFA state
+ *
+ * @param[in]   type          Lexeme accepted when the DFA stops in the state
+ *
+ * @return      Number of the new state
+ */
+int
+new_state (lexeme_type_e type)
+{
+  if (state_count == MAX_STATES)
+    {
+      fprintf (stderr, "lexgen: too many DFA states\n");
+      exit (EXIT_FAILURE);
+    }
+  accept[state_count] = type;
+  return state_count++;
+}
+
+/**
+ * @brief       Add a new character class holding the given characters
+ *
+ * @param[in]   test          Predicate selecting characters, NULL if none
+ * @param[in]   chars         Additional characters for the class
+ *
+ * @return      Number of the new class
+ */
+int
+new_class (int (*test) (int), const char *chars)
+{
+  if (class_count == MAX_CLASSES)
+    {
+      fprintf (stderr, "lexgen: too many character classes\n");
+      exit (EXIT_FAILURE);
+    }
+
+  int c = 0;
+  for (c = 1; c < 256 && test; c++)
+    if (test (c))
+      char_class[c] = class_count;
+  for (; *chars; chars++)
+    char_class[(unsigned char) *chars] = class_count;
+
+  return class_count++;
+}
+
+/**
+ * @brief       Find a keyword hash table size and multipliers without
+ *              collisions for the keywords in keyword_arr[]
+ *
+ * @param[out]  size          Hash table size, a power of two
+ * @param[out]  mul_first     Multiplier of first keyword character
+ * @param[out]  mul_last      Multiplier of last keyword character
+ *
+ * @return      EXIT_SUCCESS on success, else EXIT_FAILURE
+ */
+short
+find_keyword_hash (int *size, int *mul_first, int *mul_last)
+{
+  int kw_count = sizeof(keyword_arr) / sizeof(keyword_arr[0]);
+  int s = 0, a = 0, b = 0, i = 0;
+
+  for (s = 1; s < kw_count; s <<= 1)
+    ;
+  for (; s <= MAX_KW_SIZE; s <<= 1)
+    for (a = 1; a < 256; a++)
+      for (b = 0; b < 256; b++)
+        {
+          char used[MAX_KW_SIZE] = { 0 };
+          for (i = 0; i < kw_count; i++)
+            {
+              const unsigned char *kw =
+                  (const unsigned char*) keyword_arr[i].str;
+              int len = strlen (keyword_arr[i].str);
+              int h = (kw[0] * a + kw[len - 1] * b + len) & (s - 1);
+              if (used[h])
+                break;
+              used[h] = 1;
+            }
+          if (i == kw_count)
+            {
+              *size = s;
+              *mul_first = a;
+              *mul_last = b;
+              return EXIT_SUCCESS;
+            }
+        }
+
+  return EXIT_FAILURE;
+}
+
+/**
+ * @brief       Generate the lexer tables and write them as a C header
+ *
+ * @param[in]   argc          Argument count
+ * @param[in]   argv          Argument vector, argv[1] is the header file name
+ *
+ * @return      The error return code of the program.
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    On error
+ * @retval      errno           On system call failure
+ */
+int
+main (int argc, char **argv)
+{
+  int grammar_count = sizeof(grammar) / sizeof(grammar[0]);
+  int i = 0, j = 0, c = 0;
+
+  if (argc != 2)
+    {
+      fprintf (stderr, "Usage: lexgen HEADER\n");
+      return EXIT_FAILURE;
+    }
+
+  /// Class 0 holds every character that cannot continue a lexeme,
+  /// including the NUL sentinel at the end of the source buffer
+  new_class (NULL, "");
+  int cc_space = new_class (isspace, "");
+  int cc_digit = new_class (isdigit, "");
+  int cc_alpha = new_class (isalpha, "_");
+  int cc_quote = new_class (NULL, "\"");
+
+  /// Every character used by an operator gets a class of its own
+  for (i = 0; i < grammar_count; i++)
+    if (ispunct ((unsigned char) grammar[i].text[0]))
+      for (j = 0; grammar[i].text[j]; j++)
+        if (char_class[(unsigned char) grammar[i].text[j]] == 0)
+          new_class (NULL, (char[]) { grammar[i].text[j], '\0' });
+
+  /// State 0 rejects, state 1 is the start state
+  new_state (lx_NOP);
+  int start = new_state (lx_NOP);
+
+  /// Integers are runs of digits, identifiers are runs of alphanumeric
+  /// characters or underscores with at least one non-digit
+  int integer = new_state (lx_Integer);
+  int ident = new_state (lx_Ident);
+  dfa[start][cc_digit] = integer;
+  dfa[start][cc_alpha] = ident;
+  dfa[integer][cc_digit] = integer;
+  dfa[integer][cc_alpha] = ident;
+  dfa[ident][cc_digit] = ident;
+  dfa[ident][cc_alpha] = ident;
+
+  /// String literals are scanned by get_string_literal_lexeme()
+  dfa[start][cc_quote] = new_state (lx_String);
+
+  /// Build a trie of operators, the first grammar[] entry for a symbol wins.
+  /// Prefixes that are not an operator themselves end the input, like a
+  /// single '&' or '|' always has.
+  for (i = 0; i < grammar_count; i++)
+    {
+      const char *text = grammar[i].text;
+      if (!ispunct ((unsigned char) text[0]))
+        continue;
+
+      int state = start;
+      for (j = 0; text[j]; j++)
+        {
+          int cc = char_class[(unsigned char) text[j]];
+          if (dfa[state][cc] == 0)
+            dfa[state][cc] = new_state (lx_EOF);
+          state = dfa[state][cc];
+        }
+      if (accept[state] == lx_EOF)
+        accept[state] = grammar[i].lx_type;
+    }
+
+  /// Find a collision free hash for the keywords
+  int kw_size = 0, mul_first = 0, mul_last = 0;
+  if (find_keyword_hash (&kw_size, &mul_first, &mul_last) != EXIT_SUCCESS)
+    {
+      fprintf (stderr, "lexgen: no perfect hash found for keywords\n");
+      return EXIT_FAILURE;
+    }
+
+  const char *kw_str[MAX_KW_SIZE] = { 0 };
+  lexeme_type_e kw_type[MAX_KW_SIZE] = { 0 };
+  for (i = 0; i < sizeof(keyword_arr) / sizeof(keyword_arr[0]); i++)
+    {
+      const unsigned char *kw = (const unsigned char*) keyword_arr[i].str;
+      int len = strlen (keyword_arr[i].str);
+      int h = (kw[0] * mul_first + kw[len - 1] * mul_last + len)
+          & (kw_size - 1);
+      kw_str[h] = keyword_arr[i].str;
+      kw_type[h] = keyword_arr[i].lex_type;
+    }
+
+  /// Write the tables to the header file
+  FILE *fp = fopen (argv[1], "w");
+  if (!fp)
+    {
+      perror (argv[1]);
+      return errno;
+    }
+
+  fprintf (fp, "/// @file lex_dfa.h\n"
+           "/// @brief ALEX DFA and keyword tables generated by lexgen from "
+           "libopal.h, do not edit\n\n"
+           "#define LEX_REJECT 0          ///< DFA state without transitions\n"
+           "#define LEX_START 1           ///< DFA start state\n"
+           "#define LEX_STATES %d         ///< Number of DFA states\n"
+           "#define LEX_CLASSES %d        ///< Number of character classes\n"
+           "#define LEX_CC_SPACE %d        ///< Class of whitespace\n\n",
+           state_count, class_count, cc_space);
+
+  fprintf (fp, "/// Character class of every byte\n"
+           "const unsigned char lex_char_class[256] =\n  {");
+  for (c = 0; c < 256; c++)
+    fprintf (fp, "%s%2d,", c % 16 ? " " : "\n    ", char_class[c]);
+  fprintf (fp, "\n  };\n\n");
+
+  fprintf (fp, "/// DFA transition table indexed by state and character class\n"
+           "const unsigned char lex_dfa[LEX_STATES][LEX_CLASSES] =\n  {\n");
+  for (i = 0; i < state_count; i++)
+    {
+      fprintf (fp, "    {");
+      for (j = 0; j < class_count; j++)
+        fprintf (fp, "%s%d", j ? ", " : " ", dfa[i][j]);
+      fprintf (fp, " },\n");
+    }
+  fprintf (fp, "  };\n\n");
+
+  fprintf (fp, "/// Lexeme accepted when the DFA stops in a state\n"
+           "const lexeme_type_e lex_accept[LEX_STATES] =\n  {\n");
+  for (i = 0; i < state_count; i++)
+    fprintf (fp, "    %d, /* %s */\n", accept[i], op_name[accept[i]]);
+  fprintf (fp, "  };\n\n");
+
+  fprintf (fp, "#define LEX_KW_SIZE %d        ///< Keyword hash table size\n"
+           "/// Perfect hash of a keyword from its first and last character\n"
+           "#define LEX_KW_HASH(s, n) \\\n"
+           "  (((unsigned char) (s)[0] * %d + (unsigned char) (s)[(n) - 1] "
+           "* %d + (n)) \\\n"
+           "   & (LEX_KW_SIZE - 1))\n\n",
+           kw_size, mul_first, mul_last);
+
+  fprintf (fp, "/// Keyword strings by hash, NULL for empty slots\n"
+           "const char *const lex_kw_str[LEX_KW_SIZE] =\n  {\n");
+  for (i = 0; i < kw_size; i++)
+    if (kw_str[i])
+      fprintf (fp, "    \"%s\",\n", kw_str[i]);
+    else
+      fprintf (fp, "    NULL,\n");
+  fprintf (fp, "  };\n\n");
+
+  fprintf (fp, "/// Keyword lexeme types by hash\n"
+           "const lexeme_type_e lex_kw_type[LEX_KW_SIZE] =\n  {\n");
+  for (i = 0; i < kw_size; i++)
+    fprintf (fp, "    %d, /* %s */\n", kw_type[i], op_name[kw_type[i]]);
+  fprintf (fp, "  };\n");
+
+  if (fclose (fp) != EXIT_SUCCESS)
+    {
+      perror (argv[1]);
+      return errno;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -5,15 +5,23 @@
 #include <assert.h>             /* assert() */
 #include <ctype.h>              /* isspace(), isalnum() */
 #include <errno.h>              /* errno macros and codes */
-#include <regex.h> 				/* ReGex functions */
+#include <limits.h>             /* INT_MIN, INT_MAX */
 #include <stdarg.h>             /* variadic functions */
+#include <stdint.h>             /* int64_t, uint64_t */
 #include <stdio.h>
 #include <stdlib.h>             /* fopen, fclose, exit() */
 #include <string.h>             /* memset() */
 #include <strings.h>
 #include <unistd.h>
+#include <fcntl.h>              /* open() */
+#include <sys/stat.h>           /* fstat() */
 #include <libgen.h>             /* basename(), dirname() */
+#include <elf.h>                /* Elf64_Ehdr, Elf64_Phdr */
+#include <sys/mman.h>           /* mmap(), mprotect() */
+#include <signal.h>             /* raise() */
 #include "../include/libopal.h"
+#include "lex_dfa.h"             /* generated by lexgen */
+#include "bc_super.h"            /* generated by supergen */
 
 /*
  * ==================================
@@ -160,24 +168,6 @@ opal_exit (short code)
       return (errno);
     }
 
-  /// Close source file
-  if (source_fp && source_fp != stdin)
-    {
-      sprintf (perror_msg, "fclose(source_fp)");
-      logger(DEBUG, perror_msg);
-      if (fclose (source_fp) == EXIT_SUCCESS)
-        {
-          _PASS;
-          source_fp = NULL;
-        }
-      else
-        {
-          perror (perror_msg);
-          _FAIL;
-          return (errno);
-        }
-    }
-
   if (source_fn)
     {
       logger(DEBUG, "free (source_fn)");
@@ -292,6 +282,13 @@ opal_exit (short code)
       log_fn = NULL;
     }
 
+  /// Free in-memory source and pre-processor buffers
+  free_char_buf (&source_buf);
+  free_char_buf (&marc_buf);
+
+  /// Free interned identifiers, strings and labels
+  free_str_table ();
+
   return (code);
 }
 
@@ -331,43 +328,6 @@ opal_error (short exit_code, char *log_msg, int fmt_option, char *fmt, ...)
     return opal_exit(exit_code);
 }
 
-/**
- * @brief       Function to read next character from the source file pointer
- *
- * @return      Character read
- *
- * @retval      Next character read from FILE *stream source_fp
- * @retval      errno           On system call failure
- *
- */
-int
-read_next_char (void)
-{
-  /// Read character from source file pointer
-  errno = EXIT_SUCCESS;
-  next_char = getc (source_fp);
-
-  /// getc() sets the errno in the event of an error
-  if (errno != EXIT_SUCCESS)
-    {
-      perror (perror_msg);
-      exit (opal_exit (errno));
-    }
-
-  /// Increment the column number of the character
-  ++char_col;
-
-  /// If character is a newline, increment line number and reset column number
-  if (next_char == '\n')
-    {
-      ++char_line;
-      char_col = 0;
-    }
-
-  /// Return the character read
-  return next_char;
-}
-
 /**
  * @brief   Initialize HTML report file
  *
@@ -443,33 +403,15 @@ init_report (FILE *report_fp)
            "<textarea style='resize: none;' readonly rows='25' cols='80'>\n",
            source_fn);
 
-  /// Append source file to HTML report and close textarea tag
-  ch = 0;
+  /// Append source buffer to HTML report and close textarea tag
   logger(DEBUG, "Copying source file to HTML report");
-
-  while ((ch = fgetc (source_fp)) != EOF)
-    fputc (ch, report_fp);
-
+  if (source_buf.len)
+    fwrite (source_buf.data, sizeof(char), source_buf.len, report_fp);
   _DONE;
 
   fprintf (report_fp, "\n</textarea>\n");
   fflush (report_fp);
 
-  /// Rewind source file pointer
-  sprintf (perror_msg, "rewind('%s')", source_fn);
-  logger(DEBUG, perror_msg);
-  rewind (source_fp);
-
-  /// If current value of source file position not 0, print error and exit
-  if (ftell (source_fp) == 0)
-      _DONE;
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      exit (opal_exit(errno));
-    }
-
   logger(DEBUG, "=== END ===");
   return EXIT_SUCCESS;
 }
@@ -504,690 +446,418 @@ close_report (FILE *report_fp)
   return EXIT_SUCCESS;
 }
 
-/*
- * ==================================
- * END COMMON FUNCTION DEFINITIONS
- * ==================================
- */
-
-/*
- * ==================================
- * START MARC FUNCTION DEFINITIONS
- * ==================================
- */
-
 /**
- * @brief       Function to read from source, remove comments, and write to destination
+ * @brief       Append characters to an in-memory character buffer
  *
- * @param[in]   source_fp     Source to be read from
- * @param[in]   dest_fp       Destination to written to
+ * @details     Buffer capacity is doubled as needed so appends run in
+ * amortized constant time. Contents are kept NUL terminated.
  *
- * @return      The error return code of the function.
+ * @param[in,out]   buf     Buffer to append to
+ * @param[in]       str     Characters to append
+ * @param[in]       len     Number of characters to append
  *
- * @retval      EXIT_SUCCESS    On success
- * @retval      EXIT_FAILURE    On error
- * @retval      errno           On system call failure
+ * @return      None
  *
  */
-short
-rem_comments (FILE *source_fp, FILE *dest_fp)
+void
+append_char_buf (char_buf_s *buf, const char *str, size_t len)
 {
-  logger(DEBUG, "=== START ===");
-
-  /// Check if source file pointer is not NULL
-  logger(DEBUG, "assert(source_fp)");
-  assert(source_fp);
-  _PASS;
-
-  /// Check if destination file pointer is not NULL
-  logger(DEBUG, "assert(dest_fp)");
-  assert(dest_fp);
-  _PASS;
-
-  char ch = 0;
-  char charNext = 0;
-  bool isComment = false;
-  int numComments = 0;
+  assert(buf);
 
-  /// Start reading characters from file
-  while ((ch = fgetc (source_fp)) != EOF)
+  /// Grow buffer to fit new characters and NUL terminator
+  if (buf->len + len + 1 > buf->cap)
     {
-      /// If character is not a /, line is not a comment
-      if (ch != '/')
-        {
-          fputc (ch, dest_fp);
-          continue;
-        }
-      /// If character is a /, read next character
-      else
-        charNext = fgetc (source_fp);
+      size_t cap = buf->cap ? buf->cap : 4096;
+      while (buf->len + len + 1 > cap)
+        cap *= 2;
 
-      /// If next character is / or *, line is a comment, set flag
-      if (charNext == '/' || charNext == '*')
-        {
-          isComment = true;
-          logger(DEBUG, "Start of comment");
-        }
-      /// else, not a comment, write both characters to file
-      else
+      char *data = realloc (buf->data, cap);
+      if (!data)
         {
-          fputc (ch, dest_fp);
-          fputc (charNext, dest_fp);
+          perror ("realloc (buf->data)");
+          exit (opal_exit (errno));
         }
+      buf->data = data;
+      buf->cap = cap;
+    }
 
-      /// If comment flag is set, process comment
-      while (isComment)
-        {
-          /// Read next character from file
-          ch = fgetc (source_fp);
-
-          /// If next character is /, process single line comment
-          if (charNext == '/' && (ch == '\n' || ch == EOF))
-            {
-              logger(DEBUG, "End of comment (single line)");
-              isComment = false;
-              numComments++;
-              charNext = 0;
-            }
-
-          /// If next character is *, process multi-line comment
-          if (charNext == '*' && ch == '*')
-            {
-              ch = fgetc (source_fp);
-              if (ch == '\n')
-                numComments++;
-
-              if (ch == '/')
-                {
-                  logger(DEBUG, "End of comment (multi-line)");
-                  isComment = false;
-                  charNext = 0;
-                }
-            }
-
-          /// If end of file in multi-line comment return EXIT_FAILURE
-          if (isComment && ch == EOF)
-            {
-              fprintf (stderr, "Invalid end of file in comment");
-              return EXIT_FAILURE;
-            }
-
-          /// If char is a newline, write to file to preserve line numbers
-          if (ch == '\n')
-              fputc (ch, dest_fp);
+  /// Copy characters and terminate buffer
+  memcpy (buf->data + buf->len, str, len);
+  buf->len += len;
+  buf->data[buf->len] = '\0';
+}
 
-        }
-    }
+/**
+ * @brief       Free memory used by an in-memory character buffer
+ *
+ * @param[in,out]   buf     Buffer to free
+ *
+ * @return      None
+ *
+ */
+void
+free_char_buf (char_buf_s *buf)
+{
+  if (buf->data)
+    free (buf->data);
 
-  logger(DEBUG, "Removed %d comment lines", numComments);
-  logger(DEBUG, "=== END ===");
-  return EXIT_SUCCESS;
+  buf->data = NULL;
+  buf->len = 0;
+  buf->cap = 0;
 }
 
 /**
- * @brief       Read source, process includes, write to destination
+ * @brief       Read whole file into an in-memory character buffer
+ *
+ * @details     File is sized with fstat() and read with as few read() calls
+ * as the kernel allows, replacing per character stdio access.
  *
- * @param[in]   source_fp     Source to be read from
- * @param[in]   dest_fp       Destination to written to
+ * @param[in]       file_name   File to read
+ * @param[in,out]   buf         Buffer to append file contents to
  *
  * @return      The error return code of the function.
  *
  * @retval      EXIT_SUCCESS    On success
- * @retval      EXIT_FAILURE    On error
  * @retval      errno           On system call failure
  *
  */
 short
-proc_includes (FILE *source_fp, FILE *dest_fp)
+read_file (const char *file_name, char_buf_s *buf)
 {
   logger(DEBUG, "=== START ===");
 
-  /// Assert source file pointer is not NULL
-  logger(DEBUG, "assert(source_fp)");
-  assert(source_fp);
-  _PASS;
-
-  /// Assert destination file pointer is not NULL
-  logger(DEBUG, "assert(dest_fp)");
-  assert(dest_fp);
-  _PASS;
+  /// Assert file name and buffer are not NULL
+  assert(file_name);
+  assert(buf);
 
-  /// Move source_fp to beginning of file.
-  sprintf (perror_msg, "fseek (source_fp, 0, SEEK_SET)");
+  /// Open file in read-only mode
+  sprintf (perror_msg, "open('%s', O_RDONLY)", file_name);
   logger(DEBUG, perror_msg);
-  fseek (source_fp, 0, SEEK_SET);
-
-  /// If source file position not 0, print error and exit
-  if (ftell (source_fp) == 0)
-    _DONE;
+  int fd = open (file_name, O_RDONLY);
+  if (fd >= 0)
+    _PASS;
   else
     {
+      int err = errno;
       perror (perror_msg);
       _FAIL;
-      exit (opal_exit(errno));
+      return (err);
     }
 
-  /// Copy each character to the destination file, while checking for include files.
-  logger(DEBUG, "Reading file.");
-  char ch = fgetc (source_fp);
-  while (ch != EOF)
+  /// Size buffer from file size, unknown sizes grow while reading
+  struct stat st = { 0 };
+  size_t chunk = 4096;
+  if (fstat (fd, &st) == EXIT_SUCCESS && st.st_size > 0)
+    chunk = st.st_size + 1;
+
+  ssize_t sz = 0;
+  do
     {
-      switch (ch)
+      /// Make room for next chunk and NUL terminator
+      if (buf->len + chunk + 1 > buf->cap)
         {
-        case EOF:
-          {
-            _DONE;
-            break;
-          }
-        case ('#'):
-          {
-            logger(DEBUG, "Found hashtag symbol.");
-
-            ///Reads in 8 chars to check if they are "include ".
-            char include_buffer[9] = { 0 };
-            ssize_t sz = fread (include_buffer, sizeof(char), sizeof(char) * 8,
-                                source_fp);
-
-            /// Rewinds the file pointer.
-            fseek (source_fp, -sz, SEEK_CUR);
-
-            /// If include is found, process the included file.
-            if (strcasecmp (include_buffer, "include ") == 0)
-              {
-                logger(DEBUG, "Include keyword has been found.");
-
-                /// Move file pointer to the point after "include "
-                fseek (source_fp, sz, SEEK_CUR);
-                char filename_buffer[256] = { 0 };
-                int filename_len = 0;
-
-                /// Get the filename for the include file.
-                ch = fgetc (source_fp);
-                while (ch != '\n' && filename_len < 256)
-                  {
-                    if (ch != '"')
-                      filename_buffer[filename_len++] = ch;
-                    ch = fgetc (source_fp);
-                  }
-                logger(DEBUG, "Finished reading in the filename.");
-
-                char *include_basename = basename (filename_buffer);
-                char include_fn[512] = { 0 };
-                FILE *include_fp = NULL;
-
-                /// If given file name is relative path, prefix source file dir
-                if (strcmp (filename_buffer, include_basename) == 0)
-                  {
-                    /// Get source file directory
-                    char *source_dir = dirname (source_fn);
-                    logger(DEBUG, "source_dir: %s", source_dir);
-                    sprintf (include_fn, "%s/%s", source_dir, include_basename);
-                  }
-                else
-                  sprintf (include_fn, "%s", filename_buffer);
-
-                logger(DEBUG, "include_fn: %s", include_fn);
-
-                /// If include file does not exist, print error and exit
-                sprintf (perror_msg, "access('%s', F_OK)", include_fn);
-                logger(DEBUG, perror_msg);
-                if (access (include_fn, F_OK) == EXIT_SUCCESS)
-                  _PASS;
-                else
-                  {
-                    perror (perror_msg);
-                    _FAIL;
-                    return (errno);
-                  }
-
-                /// If include file can not be read, print error and exit
-                sprintf (perror_msg, "access('%s', R_OK)", include_fn);
-                logger(DEBUG, perror_msg);
-                if (access (include_fn, R_OK) == EXIT_SUCCESS)
-                  _PASS;
-                else
-                  {
-                    perror (perror_msg);
-                    _FAIL;
-                    return (errno);
-                  }
-
-                /// Open include file in read-only mode
-                sprintf (perror_msg, "include_fp = fopen('%s', 'r')",
-                         include_fn);
-                logger(DEBUG, perror_msg);
-
-                errno = EXIT_SUCCESS;
-                include_fp = fopen (include_fn, "r");
-                if (errno == EXIT_SUCCESS)
-                  _PASS;
-                else
-                  {
-                    perror (perror_msg);
-                    _FAIL;
-                    return (errno);
-                  }
-
-                char ch_2 = fgetc (include_fp);
-
-                /// Move contents of include file into destination file
-                logger(DEBUG, "Copy contents of %s into destination file",
-                       include_fn);
-                while (ch_2 != EOF)
-                  {
-                    fputc (ch_2, dest_fp);
-                    ch_2 = fgetc (include_fp);
-                  }
-                _DONE;
-
-                /// Flush destination file contents to disk
-                sprintf (perror_msg, "fflush(dest_fp)");
-                logger(DEBUG, perror_msg);
-                if (fflush (dest_fp) == EXIT_SUCCESS)
-                  _PASS;
-                else
-                  {
-                    perror (perror_msg);
-                    _FAIL;
-                    return (errno);
-                  }
+          char *data = realloc (buf->data, buf->len + chunk + 1);
+          if (!data)
+            {
+              int err = errno;
+              perror ("realloc (buf->data)");
+              close (fd);
+              return (err);
+            }
+          buf->data = data;
+          buf->cap = buf->len + chunk + 1;
+        }
 
-                /// Close include file pointer
-                sprintf (perror_msg, "fclose (include_fp)");
-                logger(DEBUG, perror_msg);
-                if (fclose (include_fp) == EXIT_SUCCESS)
-                  _PASS;
-                else
-                  {
-                    perror (perror_msg);
-                    _FAIL;
-                    return (errno);
-                  }
-              }
-            continue;
-          }
-        default:
-          {
-            fputc (ch, dest_fp);
-          }
+      sz = read (fd, buf->data + buf->len, chunk);
+      if (sz < 0)
+        {
+          int err = errno;
+          sprintf (perror_msg, "read('%s')", file_name);
+          perror (perror_msg);
+          _FAIL;
+          close (fd);
+          return (err);
         }
-      /// Gets the next char for the switch case to evaluate.
-      ch = fgetc (source_fp);
+      buf->len += sz;
+      buf->data[buf->len] = '\0';
     }
+  while (sz > 0);
+
+  logger(DEBUG, "Read %zu characters from '%s'", buf->len, file_name);
+  close (fd);
 
   logger(DEBUG, "=== END ===");
   return EXIT_SUCCESS;
 }
 
 /**
- * @brief       Append MARC output to HTML report file
+ * @brief       Allocate zeroed memory from an arena
  *
- * @param[in]   source_fp     Source to be read from
- * @param[in]   report_fp       Destination to written to
+ * @details     Allocations are bumped off the current chunk of the arena.
+ * A new chunk is started when the current one is full, allocations larger
+ * than a quarter chunk get a chunk of their own. Memory is only released
+ * by arena_reset() or arena_free().
  *
- * @return      The error return code of the function.
- *
- * @retval      EXIT_SUCCESS    On success
- * @retval      EXIT_FAILURE    On error
- * @retval      errno           On system call failure
+ * @param[in,out]   arena   Arena to allocate from
+ * @param[in]       size    Number of bytes to allocate
  *
+ * @return      Pointer to zeroed memory aligned to ARENA_ALIGN
  */
-short
-print_marc_html(FILE *source_fp, FILE *report_fp)
+void*
+arena_alloc (arena_s *arena, size_t size)
 {
-  logger(DEBUG, "=== START ===");
+  assert(arena);
 
-  /// Assert source file pointer is not NULL
-  logger(DEBUG, "assert(source_fp)");
-  assert(source_fp);
-  _PASS;
+  /// Round size up so every allocation stays aligned
+  size = (size + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1);
 
-  /// Assert destination file pointer is not NULL
-  logger(DEBUG, "assert(report_fp)");
-  assert(report_fp);
-  _PASS;
+  arena_chunk_s *chunk = arena->head;
+  if (!chunk || chunk->used + size > chunk->size)
+    {
+      size_t chunk_size = size > ARENA_CHUNK_SIZE / 4 ? size : ARENA_CHUNK_SIZE;
+      chunk = malloc (sizeof(arena_chunk_s) + chunk_size);
+      if (!chunk)
+        {
+          perror ("malloc (arena_chunk)");
+          exit (opal_exit (errno));
+        }
+      chunk->used = 0;
+      chunk->size = chunk_size;
 
-  /// Open textarea tag in report file for MARC output
-  fprintf (report_fp, "<h3>Output by pre-processor <code>MARC</code></h3>\n"
-           "<hr>\n"
-           "<textarea style='resize: none;' readonly rows='25' cols='80'>\n");
+      /// Large allocations are kept behind the current chunk, so what is
+      /// left of the current chunk can still be used
+      if (arena->head && chunk_size == size)
+        {
+          chunk->next = arena->head->next;
+          arena->head->next = chunk;
+        }
+      else
+        {
+          chunk->next = arena->head;
+          arena->head = chunk;
+        }
+    }
 
-  /// Append MARC output file to report file
-  logger (DEBUG, "Copying MARC output to HTML report");
-  char ch = 0;
-  while ((ch = fgetc (source_fp)) != EOF)
-    fputc (ch, report_fp);
-  _DONE;
+  char *ptr = (char*) (chunk + 1) + chunk->used;
+  chunk->used += size;
+  memset (ptr, 0, size);
 
-  fprintf (report_fp, "\n</textarea>\n");
+  return ptr;
+}
 
-  /// Flush contents of report to disk
-  sprintf (perror_msg, "fflush(report_fp)");
-  logger(DEBUG, perror_msg);
-  if (fflush (report_fp) == EXIT_SUCCESS)
-    _PASS;
-  else
+/**
+ * @brief       Release all allocations of an arena, keeping its current
+ *              chunk for reuse
+ *
+ * @param[in,out]   arena   Arena to reset
+ *
+ * @return      None
+ */
+void
+arena_reset (arena_s *arena)
+{
+  assert(arena);
+
+  if (!arena->head)
+    return;
+
+  /// Free every chunk except the current one
+  arena_chunk_s *chunk = arena->head->next;
+  while (chunk)
     {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
+      arena_chunk_s *next = chunk->next;
+      free (chunk);
+      chunk = next;
     }
 
-  return EXIT_SUCCESS;
+  arena->head->next = NULL;
+  arena->head->used = 0;
 }
 
-/*
- * ==================================
- * END MARC FUNCTION DEFINITIONS
- * ==================================
+/**
+ * @brief       Free all memory of an arena
+ *
+ * @param[in,out]   arena   Arena to free
+ *
+ * @return      None
  */
+void
+arena_free (arena_s *arena)
+{
+  assert(arena);
 
-/*
- * ==================================
- * START ALEX FUNCTION DEFINITIONS
- * ==================================
- */
+  arena_reset (arena);
+  free (arena->head);
+  arena->head = NULL;
+}
 
 /**
- * @brief       Get lexeme for a string literal
+ * @brief       Hash characters with 32-bit FNV-1a
  *
- * @param[in]   char_line      line number of char in source file
- * @param[in]   char_col       column number of char in source file
+ * @param[in]   str     Characters to hash
+ * @param[in]   len     Number of characters to hash
  *
- * @return      Next lexeme struct with values populated
- *
- * @retval      struct lexeme *
+ * @return      Hash of the characters
  */
-lexeme_s
-get_string_literal_lexeme (int char_line, int char_col)
+unsigned int
+hash_str (const char *str, size_t len)
 {
-  /// Initialize the string
-  char string[256] = { 0 };
+  unsigned int hash = 2166136261u;
+  size_t i = 0;
 
-  int index = 0;
+  for (i = 0; i < len; i++)
+    {
+      hash ^= (unsigned char) str[i];
+      hash *= 16777619u;
+    }
 
-  /// The next char needs to be checked, so get it.
-  read_next_char ();
-
-  while (next_char != '"')
-    {
-      if (next_char == EOF)
-        {
-          fprintf (stderr, "[%d:%d] Illegal End of file in string.\n", char_line,
-                   char_col);
-          exit (opal_exit (EXIT_FAILURE));
-        }
-      else if (next_char == '\n')
-        {
-          fprintf (stderr, "[%d:%d] Illegal newline character in string.\n",
-                   char_line, char_col);
-          exit (opal_exit (EXIT_FAILURE));
-        }
-      else
-        string[index++] = next_char;
-
-      read_next_char ();
-    }
-
-  read_next_char ();
-
-  lexeme_s retVal =
-    {
-      .type = lx_String,
-      .line = char_line,
-      .column = char_col,
-      .int_val = 0,
-      .char_val = strdup(string)
-    };
-
-  return retVal;
-}
+  return hash;
+}
 
 /**
- * @brief       Get lexeme for binary or unary operator
- *
- * @return      Next lexeme struct with values populated
+ * @brief       Resize hash slots of the string table and re-insert all ids
  *
- * @retval      enum lexeme type
+ * @param[in]   slots   New number of hash slots, a power of two
  *
+ * @return      None
  */
-lexeme_type_e
-binary_unary (char compound_char, lexeme_type_e compound_type,
-              lexeme_type_e simple_type, int char_line, int char_col)
+void
+rehash_str_table (unsigned int slots)
 {
-  /// Initialize return variable.
-  lexeme_type_e retVal = lx_NOP;
-
-  /// The next char needs to be checked, so get it.
-  read_next_char ();
-
-  if (next_char == EOF)
+  unsigned int *hash = calloc (slots, sizeof(unsigned int));
+  if (!hash)
     {
-      /// Illegal character found.
-      logger(ERROR, "[%d:%d] Illegal End of file.", char_line, char_col);
-      opal_exit(EXIT_FAILURE);
+      perror ("calloc (str_table.hash)");
+      exit (opal_exit (errno));
     }
-  else if (next_char == compound_char)
+
+  /// Strings are unique, so each id only needs a free slot
+  unsigned int id = 0;
+  for (id = 0; id < str_table.count; id++)
     {
-      /// Compound type found, so get the next char and return compound_type.
-      read_next_char ();
-      retVal = compound_type;
+      const char *str = str_table.str[id];
+      unsigned int slot = hash_str (str, strlen (str)) & (slots - 1);
+      while (hash[slot])
+        slot = (slot + 1) & (slots - 1);
+      hash[slot] = id + 1;
     }
-  else
-    /// Compound type not found, so return simple_type.
-    retVal = simple_type;
 
-  return retVal;
+  free (str_table.hash);
+  str_table.hash = hash;
+  str_table.slots = slots;
 }
 
 /**
- * @brief       Get lexeme for char / integer identifier
+ * @brief       Intern characters in the string table
  *
- * @return      Lexeme with values populated
+ * @details     Every distinct string is stored once and keeps its id for
+ * the rest of the run. Id 0 is always the empty string.
  *
- * @retval      struct lexeme
+ * @param[in]   str     Characters to intern
+ * @param[in]   len     Number of characters to intern
  *
+ * @return      Id of the interned string
  */
-lexeme_s
-get_identifier_lexeme (int char_line, int char_col)
+unsigned int
+intern_str (const char *str, size_t len)
 {
-  lexeme_s retVal = { 0 };
-  retVal.line = char_line;
-  retVal.column = char_col;
-  char identifier_str[1024] = { 0 };
-  int str_len = 0;
-  bool regex_match = false;
-
-  /// Get string to analyze
-  while (isalnum(next_char) || next_char == '_')
-    {
-      identifier_str[str_len++] = next_char;
-      read_next_char ();
-    }
-
-  /// Terminate string
-  identifier_str[str_len++] = '\0';
-
-  /// Error for unsupported characters
-  if (str_len == 1)
+  /// Reserve id 0 for the empty string
+  if (!str_table.count && len)
+    intern_str ("", 0);
+
+  /// Keep the hash slots at most half full
+  if (2 * (str_table.count + 1) > str_table.slots)
+    rehash_str_table (str_table.slots ? str_table.slots * 2 : 1024);
+
+  /// Probe for the string, an empty slot means it is new
+  unsigned int mask = str_table.slots - 1;
+  unsigned int slot = hash_str (str, len) & mask;
+  while (str_table.hash[slot])
     {
-      fprintf (stderr, "[%d: %d] Invalid identifier: %c.", char_line, char_col,
-               next_char);
-      exit (opal_exit(EXIT_FAILURE));
+      unsigned int id = str_table.hash[slot] - 1;
+      const char *interned = str_table.str[id];
+      if (strncmp (interned, str, len) == 0 && interned[len] == '\0')
+        return id;
+      slot = (slot + 1) & mask;
     }
 
-  /// Determine if string is a reserved keyword
-  int i = 0;
-  for (i = 0; i < (sizeof(keyword_arr) / sizeof(keyword_arr[0])); i++)
+  /// Grow the id to string array as needed
+  if (str_table.count == str_table.cap)
     {
-      if (strcmp (identifier_str, keyword_arr[i].str) == 0)
+      unsigned int cap = str_table.cap ? str_table.cap * 2 : 1024;
+      const char **strs = realloc (str_table.str, cap * sizeof(char*));
+      if (!strs)
         {
-          retVal.type = keyword_arr[i].lex_type;
-          return retVal;
+          perror ("realloc (str_table.str)");
+          exit (opal_exit (errno));
         }
+      str_table.str = strs;
+      str_table.cap = cap;
     }
 
-  /// Determine if the string is an integer via regex
-  regex_match = match (identifier_str, int_regex_pattern);
-  if (regex_match)
-    {
-      logger(DEBUG, "strtol (%s, NULL, 0)", identifier_str);
+  /// Copy the string into the arena, zeroed memory terminates it
+  char *interned = arena_alloc (&str_table.arena, len + 1);
+  memcpy (interned, str, len);
 
-      errno = EXIT_SUCCESS;
-      int intVal = strtol (identifier_str, NULL, 0);
-      if (errno != EXIT_SUCCESS)
-        {
-          perror (identifier_str);
-          _FAIL;
-          exit (opal_exit(EXIT_FAILURE));
-        }
-      else
-        {
-          _PASS;
-          retVal.type = lx_Integer;
-          retVal.int_val = intVal;
-        }
-    }
-  else
-    {
-      /// String must be an identifier
-      retVal.type = lx_Ident;
-      retVal.char_val = strdup(identifier_str);
-    }
+  unsigned int id = str_table.count++;
+  str_table.str[id] = interned;
+  str_table.hash[slot] = id + 1;
 
-  return retVal;
+  return id;
 }
 
 /**
- * @brief       Matches a string against a regular expression pattern.
- *              From pubs.opengroup.org/onlinepubs/007904875/functions/regcomp.html
+ * @brief       Get interned string for an id
  *
- * @param[in]   str             String to match
- * @param[in]   pattern         Extended regular expression
- *
- * @return      The result of the pattern match.
- *
- * @retval      true(1)         On match
- * @retval      false(0)        On error
+ * @param[in]   id      Id returned by intern_str()
  *
+ * @return      NUL terminated interned string
  */
-bool
-match (const char *str, const char *pattern)
+const char*
+get_interned_str (unsigned int id)
 {
-  int status;
-  regex_t regEx;
-
-  ///Ensure regex is set up properly
-  if (regcomp (&regEx, pattern, REG_EXTENDED | REG_NOSUB) != EXIT_SUCCESS)
-    return false;
-
-  ///Process string against regex pattern
-  status = regexec (&regEx, str, (size_t) 0, NULL, 0);
+  if (id >= str_table.count)
+    return "";
 
-  regfree (&regEx);
-
-  if (status != EXIT_SUCCESS)
-    return false;
-
-  return true;
+  return str_table.str[id];
 }
 
 /**
- * @brief       Get the next lexeme based on the next character
- *
- * @return      Next lexeme struct with values populated
- *
- * @retval      struct lexeme
+ * @brief       Free memory used by the string table
  *
+ * @return      None
  */
-lexeme_s
-get_next_lexeme (void)
+void
+free_str_table (void)
 {
+  arena_free (&str_table.arena);
+  free (str_table.str);
+  free (str_table.hash);
+  memset (&str_table, 0, sizeof(str_table));
+}
 
-  /// Create a empty struct to populate and return
-  lexeme_s retVal = { 0 };
-
-  /// Call read_next_char() to get the next character from source
-  while (isspace(next_char))
-    read_next_char ();
-
-  /// Populate lexeme line and column number
-  retVal.line = char_line;
-  retVal.column = char_col;
-
-  /// Get the lexeme type based on the next character
-  switch (next_char)
-    {
-    case '{':
-      retVal.type = lx_Lbrace;
-      break;
-    case '}':
-      retVal.type = lx_Rbrace;
-      break;
-    case '(':
-      retVal.type = lx_Lparen;
-      break;
-    case ')':
-      retVal.type = lx_Rparen;
-      break;
-    case '/':
-      retVal.type = lx_Div;
-      break;
-    case '*':
-      retVal.type = lx_Mul;
-      break;
-    case '%':
-      retVal.type = lx_Mod;
-      break;
-    case ';':
-      retVal.type = lx_Semi;
-      break;
-    case ',':
-      retVal.type = lx_Comma;
-      break;
-    case '+':
-      retVal.type = lx_Add;
-      break;
-    case '-':
-      retVal.type = lx_Sub;
-      break;
-    case '<':
-      retVal.type = binary_unary ('=', lx_Leq, lx_Lss, char_line, char_col);
-      return retVal;
-    case '>':
-      retVal.type = binary_unary ('=', lx_Geq, lx_Gtr, char_line, char_col);
-      return retVal;
-    case '=':
-      retVal.type = binary_unary ('=', lx_Eq, lx_Assign, char_line, char_col);
-      return retVal;
-    case '!':
-      retVal.type = binary_unary ('=', lx_Neq, lx_Not, char_line, char_col);
-      return retVal;
-    case '&':
-      retVal.type = binary_unary ('&', lx_And, lx_EOF, char_line, char_col);
-      return retVal;
-    case '|':
-      retVal.type = binary_unary ('|', lx_Or, lx_EOF, char_line, char_col);
-      return retVal;
-    case '"':
-      return get_string_literal_lexeme (char_line, char_col);
-    case EOF:
-      retVal.type = lx_EOF;
-      break;
-    default:
-      return get_identifier_lexeme (char_line, char_col);
-    }
+/*
+ * ==================================
+ * END COMMON FUNCTION DEFINITIONS
+ * ==================================
+ */
 
-  read_next_char ();
-  return retVal;
-}
+/*
+ * ==================================
+ * START MARC FUNCTION DEFINITIONS
+ * ==================================
+ */
 
 /**
- * @brief       Get lexeme string format
+ * @brief       Remove comments and expand include files in a single pass
  *
- * @param[in]       lexeme    Lexeme to stringify
- * @param[in,out]   buffer      Buffer to store string value of lexeme
- * @param[in]       buffer_len  Length of buffer to use
+ * @details     Source buffer is scanned once. Comments are dropped (keeping
+ * their newlines so line numbers are preserved) and each `#include` directive
+ * is replaced by the comment free contents of the included file. The result
+ * is appended to the destination buffer for ALEX, no temporary files are used.
+ *
+ * @param[in]       source      Source buffer to be read from
+ * @param[in,out]   dest        Destination buffer to append to
  *
  * @return      The error return code of the function.
  *
@@ -1197,30 +867,40 @@ get_next_lexeme (void)
  *
  */
 short
-get_lexeme_str (const lexeme_s *lexeme, char *buffer, const int buffer_len)
+marc_preprocess (const char_buf_s *source, char_buf_s *dest)
 {
+  logger(DEBUG, "=== START ===");
 
-  /// Assert buffer is not NULL
-  assert(buffer);
+  /// Check if source buffer pointer is not NULL
+  logger(DEBUG, "assert(source)");
+  assert(source);
+  _PASS;
 
-  /// Empty out the string buffer
-  memset (buffer, 0, buffer_len * sizeof(char));
+  /// Check if destination buffer pointer is not NULL
+  logger(DEBUG, "assert(dest)");
+  assert(dest);
+  _PASS;
 
-  /// Populate the buffer with values from the struct
-  sprintf (
-      buffer,
-      "line: %3d, column: %3d, type: %16s, int_val: %6d, char_val: '%s'",
-      lexeme->line, lexeme->column, op_name[lexeme->type],
-      lexeme->int_val, lexeme->char_val ? lexeme->char_val : "");
+  /// Make sure destination is a valid string even for empty sources
+  append_char_buf (dest, "", 0);
 
-  return EXIT_SUCCESS;
+  retVal = marc_scan (source->data, source->len, dest, true);
+
+  logger(DEBUG, "=== END ===");
+  return retVal;
 }
 
 /**
- * @brief       Populate symbol table with lexemes in source file pointer
+ * @brief       Copy text to destination removing comments
  *
- * @param[in,out]   *symbol_table    Symbol table linked list to populate
- * @param[in,out]   *symbol_count    Pointer to count of lexemes found
+ * @details     Text between comments is copied in runs instead of one
+ * character at a time. If expand_includes is set, `#include` directives are
+ * handed over to proc_include().
+ *
+ * @param[in]       src                 Text to be read from
+ * @param[in]       src_len             Number of characters in text
+ * @param[in,out]   dest                Destination buffer to append to
+ * @param[in]       expand_includes     Process `#include` directives
  *
  * @return      The error return code of the function.
  *
@@ -1230,65 +910,107 @@ get_lexeme_str (const lexeme_s *lexeme, char *buffer, const int buffer_len)
  *
  */
 short
-build_symbol_table (lexeme_s *symbol_table, int *symbol_count)
+marc_scan (const char *src, size_t src_len, char_buf_s *dest,
+           bool expand_includes)
 {
-  logger(DEBUG, "=== START ===");
+  size_t i = 0;
+  int numComments = 0;
 
-  /// Assert symbol table pointer is not NULL
-  logger(DEBUG, "assert(symbol_table)");
-  assert(symbol_table);
-  _PASS;
+  while (i < src_len)
+    {
+      /// Copy run of characters up to the next '/' or '#' in one go
+      size_t run = i;
+      while (run < src_len && src[run] != '/' && src[run] != '#')
+        run++;
 
-  /// Assert symbol table count pointer is not NULL
-  logger(DEBUG, "assert(symbol_count)");
-  assert(symbol_count);
-  _PASS;
+      if (run > i)
+        {
+          append_char_buf (dest, src + i, run - i);
+          i = run;
+          continue;
+        }
 
-  /// Create symbols at the beginning of the linked list
-  lexeme_s *current = symbol_table;
+      char next = (i + 1 < src_len) ? src[i + 1] : '\0';
 
-  /// Get lexemes in a loop until we get a EOF lexeme
-  do
-    {
-      /// Call get_next_lexeme() to populate next_lexeme
-      next_lexeme = get_next_lexeme ();
+      /// Single line comment, skip to the newline and keep it
+      if (src[i] == '/' && next == '/')
+        {
+          logger(DEBUG, "Start of comment");
+          while (i < src_len && src[i] != '\n')
+            i++;
 
-      /// Append next_lexeme to symbol table
-      lexeme_s *new_symbol = (lexeme_s*) calloc (1, sizeof(lexeme_s));
-      new_symbol->line = next_lexeme.line;
-      new_symbol->column = next_lexeme.column;
-      new_symbol->type = next_lexeme.type;
-      new_symbol->int_val = next_lexeme.int_val;
-
-      new_symbol->char_val =
-          next_lexeme.char_val ? strdup(next_lexeme.char_val) : NULL;
-
-      /// Call get_lexeme_str() to stringify next_lexeme
-      if (get_lexeme_str (new_symbol, lexeme_str,
-                          lexeme_str_len) != EXIT_SUCCESS)
-        return (EXIT_FAILURE);
+          logger(DEBUG, "End of comment (single line)");
+          numComments++;
+        }
+
+      /// Multi-line comment, skip to '*/' keeping newlines
+      else if (src[i] == '/' && next == '*')
+        {
+          logger(DEBUG, "Start of comment");
+          i += 2;
+          while (i < src_len && !(src[i] == '*' && i + 1 < src_len
+                                  && src[i + 1] == '/'))
+            {
+              if (src[i] == '\n')
+                {
+                  append_char_buf (dest, "\n", 1);
+                  numComments++;
+                }
+              i++;
+            }
+
+          /// If end of file in multi-line comment return EXIT_FAILURE
+          if (i >= src_len)
+            {
+              fprintf (stderr, "Invalid end of file in comment");
+              return EXIT_FAILURE;
+            }
+
+          logger(DEBUG, "End of comment (multi-line)");
+          i += 2;
+        }
+
+      /// Include directive, replace line with contents of include file
+      else if (src[i] == '#' && expand_includes && src_len - i > 8
+          && strncasecmp (src + i + 1, "include ", 8) == 0)
+        {
+          logger(DEBUG, "Include keyword has been found.");
+          i += 9;
+
+          /// Directive ends at the end of the line
+          size_t eol = i;
+          while (eol < src_len && src[eol] != '\n')
+            eol++;
 
-      /// Append lexeme to symbol table
-      logger(DEBUG, "Append lexeme {%s}", lexeme_str);
-      current->next = new_symbol;
+          retVal = proc_include (src + i, eol - i, dest);
+          if (retVal != EXIT_SUCCESS)
+            return retVal;
 
-      /// Increment symbol count
-      *symbol_count = *symbol_count + 1;
+          i = eol;
+        }
 
-      /// Move current to last symbol in linked list
-      current = current->next;
+      /// Not a comment or directive, copy character as is
+      else
+        {
+          append_char_buf (dest, src + i, 1);
+          i++;
+        }
     }
-  while (next_lexeme.type != lx_EOF);
 
-  logger(DEBUG, "=== END ===");
+  logger(DEBUG, "Removed %d comment lines", numComments);
   return EXIT_SUCCESS;
 }
 
 /**
- * @brief       Print symbol table to destination file pointer
+ * @brief       Append contents of an include file to destination
  *
- * @param[in,out]   symbol_table    Symbol table to print
- * @param[in,out]   dest_fp         Destination file pointer
+ * @details     The file name may be quoted. Relative names are looked up in
+ * the directory of the source file. Comments in the include file are
+ * removed while it is copied.
+ *
+ * @param[in]       directive       Text following `#include `
+ * @param[in]       directive_len   Number of characters in directive
+ * @param[in,out]   dest            Destination buffer to append to
  *
  * @return      The error return code of the function.
  *
@@ -1298,42 +1020,91 @@ build_symbol_table (lexeme_s *symbol_table, int *symbol_count)
  *
  */
 short
-print_symbol_table (lexeme_s *symbol_table, FILE *dest_fp)
+proc_include (const char *directive, size_t directive_len, char_buf_s *dest)
 {
   logger(DEBUG, "=== START ===");
 
-  /// Assert symbol table pointer is not NULL
-  logger(DEBUG, "assert(symbol_table)");
-  assert(symbol_table);
-  _PASS;
+  char filename_buffer[256] = { 0 };
+  size_t filename_len = 0;
+  size_t i = 0;
 
-  /// Assert destination file pointer is not NULL
-  logger(DEBUG, "assert(dest_fp)");
-  assert(dest_fp);
-  _PASS;
+  /// Skip leading blanks and opening quote
+  while (i < directive_len && isspace(directive[i]))
+    i++;
 
-  /// Write ALEX to destination file
-  logger (DEBUG, "Writing ALEX output to destination file.");
+  bool quoted = (i < directive_len && directive[i] == '"');
+  if (quoted)
+    i++;
 
-  lexeme_s *current = symbol_table;
-  while (current->next)
+  /// Get the filename for the include file
+  while (i < directive_len && filename_len < sizeof(filename_buffer) - 1)
     {
-      /// Call get_lexeme_str() to stringify next_lexeme
-      retVal = get_lexeme_str (current, lexeme_str,
-                               lexeme_str_len);
-      if (retVal != EXIT_SUCCESS)
-        return (EXIT_FAILURE);
+      if (quoted ? directive[i] == '"' : isspace(directive[i]))
+        break;
+      filename_buffer[filename_len++] = directive[i++];
+    }
+  logger(DEBUG, "Finished reading in the filename.");
 
-      /// Append lexeme to symbol table
-      retVal = fprintf (dest_fp, "%s\n", lexeme_str);
-      if (retVal < 0)
-        {
-          perror ("fprintf (dest_fp, next_lexeme_str)");
-          exit (opal_exit (retVal));
-        }
+  char *include_basename = basename (filename_buffer);
+  char include_fn[512] = { 0 };
+
+  /// If given file name is relative path, prefix source file dir
+  if (strcmp (filename_buffer, include_basename) == 0)
+    {
+      /// Get source file directory, dirname() modifies its argument
+      char *source_copy = strdup (source_fn);
+      char *source_dir = dirname (source_copy);
+      logger(DEBUG, "source_dir: %s", source_dir);
+      snprintf (include_fn, sizeof(include_fn), "%s/%s", source_dir,
+                include_basename);
+      free (source_copy);
+    }
+  else
+    snprintf (include_fn, sizeof(include_fn), "%s", filename_buffer);
+
+  logger(DEBUG, "include_fn: %s", include_fn);
+
+  /// If include file does not exist, print error and exit
+  sprintf (perror_msg, "access('%s', F_OK)", include_fn);
+  logger(DEBUG, perror_msg);
+  if (access (include_fn, F_OK) == EXIT_SUCCESS)
+    _PASS;
+  else
+    {
+      int err = errno;
+      perror (perror_msg);
+      _FAIL;
+      return (err);
+    }
+
+  /// If include file can not be read, print error and exit
+  sprintf (perror_msg, "access('%s', R_OK)", include_fn);
+  logger(DEBUG, perror_msg);
+  if (access (include_fn, R_OK) == EXIT_SUCCESS)
+    _PASS;
+  else
+    {
+      int err = errno;
+      perror (perror_msg);
+      _FAIL;
+      return (err);
+    }
 
-      current = current->next;
+  /// Read include file into memory
+  char_buf_s include_buf = { 0 };
+  retVal = read_file (include_fn, &include_buf);
+  if (retVal != EXIT_SUCCESS)
+    {
+      free_char_buf (&include_buf);
+      return retVal;
     }
+
+  /// Move comment free contents of include file into destination
+  logger(DEBUG, "Copy contents of %s into destination", include_fn);
+  retVal = marc_scan (include_buf.data, include_buf.len, dest, false);
+  free_char_buf (&include_buf);
+  if (retVal != EXIT_SUCCESS)
+    return retVal;
   _DONE;
 
   logger(DEBUG, "=== END ===");
@@ -1341,10 +1112,10 @@ print_symbol_table (lexeme_s *symbol_table, FILE *dest_fp)
 }
 
 /**
- * @brief       Print symbol table HTML report to report file pointer
+ * @brief       Append MARC output to HTML report file
  *
- * @param[in,out]   symbol_table    Symbol table to print
- * @param[in,out]   report_fp       Report file pointer
+ * @param[in]   source        MARC output buffer to be read from
+ * @param[in]   report_fp     Destination to written to
  *
  * @return      The error return code of the function.
  *
@@ -1354,13 +1125,13 @@ print_symbol_table (lexeme_s *symbol_table, FILE *dest_fp)
  *
  */
 short
-print_symbol_table_html (lexeme_s *symbol_table, FILE *report_fp)
+print_marc_html(const char_buf_s *source, FILE *report_fp)
 {
   logger(DEBUG, "=== START ===");
 
-  /// Assert symbol table pointer is not NULL
-  logger(DEBUG, "assert(symbol_table)");
-  assert(symbol_table);
+  /// Assert source buffer pointer is not NULL
+  logger(DEBUG, "assert(source)");
+  assert(source);
   _PASS;
 
   /// Assert destination file pointer is not NULL
@@ -1368,719 +1139,528 @@ print_symbol_table_html (lexeme_s *symbol_table, FILE *report_fp)
   assert(report_fp);
   _PASS;
 
-  /// Walk the symbol table & print the HTML report to destination file pointer
-  logger(DEBUG, "Walk symbol table and print lexemes to HTML report");
+  /// Open textarea tag in report file for MARC output
+  fprintf (report_fp, "<h3>Output by pre-processor <code>MARC</code></h3>\n"
+           "<hr>\n"
+           "<textarea style='resize: none;' readonly rows='25' cols='80'>\n");
 
-  fprintf (
-      report_fp,
-      "<h3>Symbol table by Lexical analyzer <code>ALEX</code></h3>\n<hr>\n");
-  fprintf (report_fp,
-           "<div class='scroll'><table>\n" "<tr>\n" "<th>Line No.</th>\n"
-           "<th>Column No.</th>\n" "<th>Type</th>\n" "<th>Value</th>\n"
-           "</tr>");
+  /// Append MARC output buffer to report file
+  logger (DEBUG, "Copying MARC output to HTML report");
+  if (source->len)
+    fwrite (source->data, sizeof(char), source->len, report_fp);
+  _DONE;
 
-  /// Append symbol table to report file
-  logger (DEBUG, "Copying ALEX output to HTML report");
+  fprintf (report_fp, "\n</textarea>\n");
 
-  lexeme_s *current = symbol_table;
-  while (current->next)
-    {
-      fprintf (report_fp, "<tr>");
-      fprintf (report_fp, "<td>%d</td>\n"
-               "<td>%d</td>\n"
-               "<td>%s</td>\n",
-               current->line, current->column,
-               op_name[current->type]);
-
-      if (current->type == lx_Integer)
-        {
-          fprintf (report_fp, "<td>%d</td>\n", current->int_val);
-        }
-      else if (current->type == lx_Ident)
-        {
-          fprintf (report_fp, "<td>%s</td>\n", current->char_val);
-        }
-      else if (current->type == lx_String)
-        {
-          fprintf (report_fp, "<td>\"%s\"</td>\n", current->char_val);
-        }
-      else
-        {
-          fprintf (report_fp, "<td></td>\n");
-        }
-      fprintf (report_fp, "</tr>\n");
-      current = current->next;
-    }
-
-  fprintf (report_fp, "</table></div>\n");
-  fflush (report_fp);
-
-  _DONE;
-
-  /// Flush contents of report to disk
-  sprintf (perror_msg, "fflush(report_fp)");
-  logger(DEBUG, perror_msg);
-  if (fflush (report_fp) == EXIT_SUCCESS)
-    _PASS;
-  else
+  /// Flush contents of report to disk
+  sprintf (perror_msg, "fflush(report_fp)");
+  logger(DEBUG, perror_msg);
+  if (fflush (report_fp) == EXIT_SUCCESS)
+    _PASS;
+  else
     {
       _FAIL;
       perror (perror_msg);
       return (errno);
     }
 
-  _DONE;
-
-  logger(DEBUG, "=== END ===");
   return EXIT_SUCCESS;
 }
 
-/**
- * @brief       Free memory allocated for symbol table linked list
- *
- * @param[in,out]   symbol_table    Symbol table to deallocate
- *
- * @return      NULL
- *
- */
-void
-free_symbol_table (lexeme_s *symbol_table)
-{
-  logger(DEBUG, "=== START ===");
-  /// Walk symbol table and free individual lexemes
-
-  lexeme_s *next_symbol = NULL;
-  while (symbol_table)
-    {
-      next_symbol = symbol_table;
-      symbol_table = symbol_table->next;
-
-      get_lexeme_str (next_symbol, lexeme_str, lexeme_str_len);
-      logger(DEBUG, "Free symbol: %s", lexeme_str);
-
-      if (next_symbol->char_val)
-        {
-          free(next_symbol->char_val);
-          next_symbol->char_val = NULL;
-        }
-
-      free (next_symbol);
-      next_symbol = NULL;
-    }
-
-  logger(DEBUG, "=== END ===");
-}
-
 /*
  * ==================================
- * END ALEX FUNCTION DEFINITIONS
+ * END MARC FUNCTION DEFINITIONS
  * ==================================
  */
 
 /*
  * ==================================
- * START ASTRO FUNCTION DEFINITIONS
+ * START ALEX FUNCTION DEFINITIONS
  * ==================================
  */
 
 /**
- * @brief       Return syntax tree node with given left and right child nodes
- *
- * @param[in]   type            Node type to create
- * @param[in]   left_child      Left child node pointer
- * @param[in]   right_child     Right child node pointer
- *
- * @return      Abstract syntax tree node pointer
- *
- * @retval      node_s*     On success
- */
-node_s*
-make_ast_node(ast_node_type_e type, node_s *left_child, node_s *right_child)
-{
-
-  /// Create node with given children and return
-  node_s *tree = calloc (1, sizeof(node_s));
-  tree->left = left_child;
-  tree->right = right_child;
-  tree->node_type = type;
-
-  /// Create buffer for logging
-  char buffer[1024] = { 0 };
-
-  /// Append left child node type to log buffer
-  strcat (buffer, "left->");
-  if (left_child)
-    strcat (buffer, node_name[left_child->node_type]);
-  else
-    strcat (buffer, "NULL");
-
-  /// Append current node type to log buffer
-  strcat (buffer, "\tnode->");
-  strcat (buffer, node_name[type]);
-
-  /// Append right child node type to log buffer
-  strcat (buffer, "\tright->");
-  if (right_child)
-    strcat (buffer, node_name[right_child->node_type]);
-  else
-    strcat (buffer, "NULL");
-
-  /// Log node message
-  logger (DEBUG, buffer);
-
-  return tree;
-}
-
-/**
- * @brief       Build abstract syntax tree from symbol table
- *
- * @param       symbol_table       Lexeme symbol table
+ * @brief       Point lexer cursor at start of source buffer
  *
- * @return      Abstract syntax tree built from the symbol table
- *
- * @retval      Tree root node pointer      On success
- * @retval      NULL                        On error
+ * @param[in]   source        NUL terminated source buffer to be scanned
  *
  */
-node_s*
-build_syntax_tree (lexeme_s *symbol_table)
+void
+init_lexer (const char_buf_s *source)
 {
   logger(DEBUG, "=== START ===");
 
-  /// Check if symbol table pointer is not NULL
-  logger(DEBUG, "assert(symbol_table)");
-  assert(symbol_table);
+  /// Assert source buffer pointer is not NULL
+  logger(DEBUG, "assert(source)");
+  assert(source);
   _PASS;
 
-  /// Create syntax tree node NULL pointer to return
-  node_s *tree = NULL;
+  /// Scan an empty string if nothing was read into the buffer
+  lex_buf = source->data ? source->data : "";
+  lex_ptr = lex_buf;
+  lex_end = lex_buf + source->len;
 
-  /// Start reading lexemes from the symbol table
-  ast_curr_lexeme = symbol_table;
-
-  /// Call make_ast_node() until lexeme with lx_EOF is seen
-  do {
-      tree = make_ast_node(nd_Sequence, tree, make_statement_node());
-  } while (tree != NULL && ast_curr_lexeme->type != lx_EOF);
+  /// Restart line/column lookups from the top of the buffer
+  lex_pos_offset = 0;
+  lex_pos_line = 0;
+  lex_pos_nl = -1;
 
   logger(DEBUG, "=== END ===");
-  return tree;
 }
 
 /**
- * @brief       Check if lexeme is of expected type, else print error and exit
+ * @brief       Derive line and column number from offset in source buffer
  *
- * @param[in]   expected_type   Expected lexeme type
+ * Lookups resume from the previous one, so walking the lexemes in order
+ * scans the source buffer only once.
+ *
+ * @param[in]   offset        Offset in source buffer, -1 if none
+ * @param[out]  line          Line number of offset, 0 if none
+ * @param[out]  col           Column number of offset, 0 if none
  *
- * @return      NULL
  */
 void
-expect_lexeme (lexeme_type_e expected_type)
+get_line_col (int offset, int *line, int *col)
 {
-  /// If ast_curr_lexeme is of expected type
-  if (ast_curr_lexeme->type == expected_type)
+  /// Lexemes without a position are reported at line 0, column 0
+  if (offset < 0 || !lex_buf)
     {
-      /// ... read next lexeme and return
-      ast_curr_lexeme = ast_curr_lexeme->next;
+      *line = 0;
+      *col = 0;
       return;
     }
 
-  /// ... else print error and exit
-  fprintf(stderr, "%s expected but %s found.", grammar[expected_type].text,
-         grammar[ast_curr_lexeme->type].text);
-  exit (opal_exit (EXIT_FAILURE));
+  /// Start from the top of the buffer when looking backwards
+  if (offset < lex_pos_offset)
+    {
+      lex_pos_offset = 0;
+      lex_pos_line = 0;
+      lex_pos_nl = -1;
+    }
+
+  /// Count newlines between the previous lookup and the offset
+  const char *nl = lex_buf + lex_pos_offset;
+  const char *end = lex_buf + offset;
+  while (nl < end && (nl = memchr (nl, '\n', end - nl)))
+    {
+      ++lex_pos_line;
+      lex_pos_nl = nl - lex_buf;
+      ++nl;
+    }
+  lex_pos_offset = offset;
+
+  *line = lex_pos_line;
+  *col = offset - lex_pos_nl;
 }
 
 /**
- * @brief       Build and return expression inside parantheses
+ * @brief       Get lexeme for a string literal
  *
- * @return      Syntax tree node pointer
+ * @param[in]   offset         offset of opening quote in source buffer
  *
- * @retval      node_s*     On success
- * @retval      NULL        On error
+ * @return      Next lexeme struct with values populated
  *
+ * @retval      struct lexeme *
  */
-node_s*
-make_parentheses_expression(void)
+lexeme_s
+get_string_literal_lexeme (int offset)
 {
-  /// Expect left parantheses before the expression
-  expect_lexeme (lx_Lparen);
+  int line = 0, col = 0;
 
-  ///
-  node_s *tree = NULL;
+  /// Cursor is past the opening quote, find the closing one
+  while (*lex_ptr != '"')
+    {
+      if (*lex_ptr == '\0' && lex_ptr == lex_end)
+        {
+          get_line_col (offset, &line, &col);
+          fprintf (stderr, "[%d:%d] Illegal End of file in string.\n", line,
+                   col);
+          exit (opal_exit (EXIT_FAILURE));
+        }
+      else if (*lex_ptr == '\n')
+        {
+          get_line_col (offset, &line, &col);
+          fprintf (stderr, "[%d:%d] Illegal newline character in string.\n",
+                   line, col);
+          exit (opal_exit (EXIT_FAILURE));
+        }
 
-  /// Create tree for expression inside parantheses
-  tree = make_expression_node (0);
+      ++lex_ptr;
+    }
 
-  /// Expect right parantheses after the expression
-  expect_lexeme (lx_Rparen);
+  /// Skip the closing quote
+  ++lex_ptr;
 
-  /// return tree
-  return tree;
+  /// Lexeme spans both quotes, its value is the text between them
+  lexeme_s retVal =
+    {
+      .type = lx_String,
+      .offset = offset,
+      .length = lex_ptr - lex_buf - offset,
+      .int_val = 0,
+      .str_id = intern_str (lex_buf + offset + 1,
+                            lex_ptr - lex_buf - offset - 2)
+    };
+
+  return retVal;
 }
 
 /**
- * @brief
+ * @brief       Get lexeme for char / integer identifier
  *
- * @param[in]   type            type of node in tree
- * @param[in]   curr_lexeme     lexeme to make leaf with
+ * @param[in]   offset         offset of first character in source buffer
+ * @param[in]   type           lx_Ident or lx_Integer as accepted by the DFA
  *
- * @return      Syntax tree node pointer
+ * @return      Lexeme with values populated
  *
- * @retval      node_s*     On success
- * @retval      NULL        On error
+ * @retval      struct lexeme
  *
  */
-node_s*
-make_leaf_node (ast_node_type_e type, lexeme_s *curr_lexeme)
+lexeme_s
+get_identifier_lexeme (int offset, lexeme_type_e type)
 {
+  lexeme_s retVal = { 0 };
+  retVal.offset = offset;
 
-  logger(DEBUG, "=== START ===");
-
-  /// Create the leaf node to return
-  node_s *node = calloc (1, sizeof(node_s));
-  logger(DEBUG, "assert(node)");
-  assert(node);
-  _PASS;
+  /// Identifier runs from offset up to the lexer cursor
+  const char *start = lex_buf + offset;
+  size_t str_len = lex_ptr - start;
+  retVal.length = str_len;
 
-  /// Assign node type to new node
-  node->node_type = type;
+  if (type == lx_Integer)
+    {
+      /// Digits end before the cursor, so strtol() stops at the cursor
+      sprintf (perror_msg, "strtol (%.*s, NULL, 0)",
+               (int) (str_len < 64 ? str_len : 64), start);
+      logger(DEBUG, perror_msg);
 
-  /// If lexeme type is a string or an identifier
-  if ((type == nd_String) || (type == nd_Ident))
-    node->char_val = strdup (curr_lexeme->char_val);
+      errno = EXIT_SUCCESS;
+      int intVal = strtol (start, NULL, 0);
+      if (errno != EXIT_SUCCESS)
+        {
+          perror (perror_msg);
+          _FAIL;
+          exit (opal_exit(EXIT_FAILURE));
+        }
+      retVal.type = lx_Integer;
+      retVal.int_val = intVal;
+      return retVal;
+    }
 
-  /// Otherwise the lexeme type is an integer
-  else if (type == nd_Integer)
-    node->int_val = curr_lexeme->int_val;
+  /// Determine if string is a reserved keyword via the perfect hash
+  int h = LEX_KW_HASH(start, str_len);
+  if (lex_kw_str[h] && strncmp (start, lex_kw_str[h], str_len) == 0
+      && lex_kw_str[h][str_len] == '\0')
+    {
+      retVal.type = lex_kw_type[h];
+      return retVal;
+    }
 
-  logger(DEBUG, "Returning leaf node with val: '%s'.", node->char_val);
+  /// String must be an identifier, its value is its interned source text
+  retVal.type = lx_Ident;
+  retVal.str_id = intern_str (start, str_len);
 
-  logger(DEBUG, "=== END ===");
-  return node;
+  return retVal;
 }
 
 /**
- * @brief       Build and return expression node
+ * @brief       Get the next lexeme based on the next character
  *
- * @param[in]   precedence    Precedence of mathematical operation
+ * @details     Runs the DFA generated by lexgen from the start state until
+ * no transition is left, so the longest lexeme is matched. The state reached
+ * gives the type of the lexeme.
+ *
+ * @return      Next lexeme struct with values populated
  *
- * @return      Syntax tree node pointer
+ * @retval      struct lexeme
  *
- * @retval      node_s*     On success
- * @retval      NULL        On error
  */
-node_s*
-make_expression_node(int precedence)
+lexeme_s
+get_next_lexeme (void)
 {
-  /// Create the tree node to return
-  node_s* tree = NULL;
-  node_s* node = NULL;
-
-  lexeme_type_e operator = lx_NOP;
-
-  switch(ast_curr_lexeme->type){
-
-    case lx_Not:
-      /// If lexeme type is Not, get next lexeme
-      ast_curr_lexeme = ast_curr_lexeme->next;
-
-      /// ...make Not node with the children next_lexeme and NULL
-      tree = make_ast_node(nd_Not,make_expression_node(grammar[lx_Not].precedence),NULL);
-      break;
-
-    case lx_Add:
-    case lx_Sub:
-      /// If lexeme type is Add or Sub, save type
-      operator = ast_curr_lexeme->type;
-      ast_curr_lexeme = ast_curr_lexeme->next;
 
-      /// Get next lexeme and make new expression node with it
-      node = make_expression_node(grammar[lx_Negate].precedence);
-
-      /// If original node type was Sub
-      if (operator == lx_Sub)
+  /// Create a empty struct to populate and return
+  lexeme_s retVal = { 0 };
+  int line = 0, col = 0;
 
-        /// ...make a Negate node with the children new node and NULL
-        tree = make_ast_node(nd_Negate, node, NULL);
+  /// Move the cursor past any whitespace
+  while (lex_char_class[(unsigned char) *lex_ptr] == LEX_CC_SPACE)
+    ++lex_ptr;
 
-      /// Else only use the new node
-      else
-        tree = node;
-      break;
+  /// Populate lexeme offset, line and column are derived when needed
+  int offset = lex_ptr - lex_buf;
+  retVal.offset = offset;
 
-    case lx_Integer:
-      /// If lexeme type is Integer, make leaf node and get next lexeme
-      tree = make_leaf_node(nd_Integer, ast_curr_lexeme);
-      ast_curr_lexeme = ast_curr_lexeme->next;
-      break;
+  /// Follow DFA transitions while there are any
+  int state = LEX_START;
+  int next_state = LEX_REJECT;
+  while ((next_state =
+      lex_dfa[state][lex_char_class[(unsigned char) *lex_ptr]]) != LEX_REJECT)
+    {
+      state = next_state;
+      ++lex_ptr;
+    }
 
+  /// Get the lexeme type based on the state reached
+  retVal.type = lex_accept[state];
+  switch (retVal.type)
+    {
+    case lx_String:
+      return get_string_literal_lexeme (offset);
     case lx_Ident:
-      /// If lexeme type is Ident, make leaf node and get next lexeme
-      tree = make_leaf_node(nd_Ident, ast_curr_lexeme);
-      ast_curr_lexeme = ast_curr_lexeme->next;
-      break;
-
-    case lx_Input:
-      /// If lexeme type is Input, get next lexeme
-      ast_curr_lexeme = ast_curr_lexeme->next;
-
-      /// ...expect LParen
-      expect_lexeme(lx_Lparen);
-
-      /// ... and make Input node with NULL as one child
-      node_s *input_tree = make_ast_node (nd_Input,make_leaf_node(nd_String, ast_curr_lexeme), NULL);
-
-      /// ... and expect String contents as the other
-      expect_lexeme(lx_String);
-      tree = make_ast_node(nd_Sequence, input_tree, tree);
-
-      /// ... finally expect Rparen to close Input
-      expect_lexeme(lx_Rparen);
-      break;
-
-    case lx_Lparen:
-      /// If lexeme type is Lparen, make tree from contents within
-      tree = make_parentheses_expression ();
+    case lx_Integer:
+      return get_identifier_lexeme (offset, retVal.type);
+    case lx_NOP:
+      /// NUL sentinel marks the end of the buffer, anything else is invalid
+      if (*lex_ptr == '\0' && lex_ptr == lex_end)
+        {
+          retVal.type = lx_EOF;
+          break;
+        }
+      get_line_col (offset, &line, &col);
+      fprintf (stderr, "[%d: %d] Invalid identifier: %c.", line, col,
+               *lex_ptr);
+      exit (opal_exit(EXIT_FAILURE));
+    default:
       break;
+    }
 
-    default:
-      /// Expressions cannot start with any other type of lexeme
-      fprintf (stderr, "[%d:%d] Unexpected lexeme type found: %s\n",
-               ast_curr_lexeme->line, ast_curr_lexeme->column,
-               op_name[ast_curr_lexeme->type]);
-      exit (opal_exit (EXIT_FAILURE));
-  }
+  retVal.length = lex_ptr - lex_buf - offset;
+  return retVal;
+}
 
-    /// While the next lexeme is binary and its precedence is at least as high as the current lexeme
-    while (grammar[ast_curr_lexeme->type].is_binary && grammar[ast_curr_lexeme->type].precedence >= precedence)
-      {
-        /// Save lexeme type and get next lexeme
-        lexeme_type_e orig_op = ast_curr_lexeme->type;
-        ast_curr_lexeme = ast_curr_lexeme->next;
+/**
+ * @brief       Get lexeme string format
+ *
+ * @param[in]       symbol_table    Symbol table holding the lexeme
+ * @param[in]       index           Index of lexeme to stringify
+ * @param[in,out]   buffer          Buffer to store string value of lexeme
+ * @param[in]       buffer_len      Length of buffer to use
+ *
+ * @return      The error return code of the function.
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    On error
+ * @retval      errno           On system call failure
+ *
+ */
+short
+get_lexeme_str (const symbol_table_s *symbol_table, int index, char *buffer,
+                const int buffer_len)
+{
 
-         /// Search for higher precedence in a later lexeme
-         int precedence_ctr = grammar[orig_op].precedence;
+  int line = 0, col = 0;
+  lexeme_type_e type = symbol_table->type[index];
+  const char *str_val = get_symbol_str (symbol_table, index);
 
-         /// and increment counter to work up precedence hierarchy
-         if(!grammar[orig_op].right_associative)
-             precedence_ctr++;
+  /// Assert buffer is not NULL
+  assert(buffer);
 
-         /// Recursively make new expression node with incremented precedence
-         node = make_expression_node(precedence_ctr);
+  /// Derive line and column number from lexeme offset
+  get_line_col (symbol_table->offset[index], &line, &col);
 
-         /// ...and add it to a working tree
-         tree = make_ast_node(grammar[orig_op].node_type, tree, node);
+  /// Empty out the string buffer
+  memset (buffer, 0, buffer_len * sizeof(char));
 
-      }/// ...until all higher precedented lexemes in expression are processed
+  /// Populate the buffer with values from the symbol table
+  snprintf (
+      buffer, buffer_len,
+      "line: %3d, column: %3d, type: %16s, int_val: %6d, char_val: '%s'",
+      line, col, op_name[type],
+      type == lx_Integer ? symbol_table->value[index] : 0,
+      str_val ? str_val : "");
 
-  return tree;
+  return EXIT_SUCCESS;
 }
 
 /**
- * @brief       Build and return syntax tree node for a statement
+ * @brief       Append lexeme to symbol table, growing its arrays as needed
+ *
+ * @details     All arrays of the symbol table live in a single block taken
+ * from the arena of the table. When full, the arrays are moved into a block
+ * twice the size and the old block stays with the arena until it is freed.
  *
- * @return      Syntax tree node pointer
+ * @param[in,out]   symbol_table    Symbol table to append to
+ * @param[in]       lexeme          Lexeme to append
  *
- * @retval      node_s*     On success
- * @retval      NULL        On error
  */
-node_s*
-make_statement_node (void)
+void
+append_symbol (symbol_table_s *symbol_table, const lexeme_s *lexeme)
 {
-  node_s *tree = NULL;                  ///< Syntax tree node to return
-  node_s *value = NULL;                 ///< Leaf node with int/string value
-  node_s *expression = NULL;            ///< Node for expression
-  node_s *condition_statement = NULL;   ///< if/while condition statement node
-  node_s *else_statement = NULL;        ///< else condition statement node
-
-  switch (ast_curr_lexeme->type)
+  /// Double the arrays when full, they are moved into one new allocation
+  if (symbol_table->count == symbol_table->cap)
     {
-    case lx_If:
-      /// If next lexeme is if statement, read next lexeme
-      ast_curr_lexeme = ast_curr_lexeme->next;
-
-      /// ... get expression inside left parentheses
-      expression = make_parentheses_expression ();
-
-      /// ... get condition statement node
-      condition_statement = make_statement_node ();
-
-      /// ... and create else statement node as NULL
-      else_statement = NULL;
-
-      /// If next lexeme is an else
-      if (ast_curr_lexeme->type == lx_Else)
-        {
-          /// ... read next lexeme
-          ast_curr_lexeme = ast_curr_lexeme->next;
-
-          /// ... and make else statement node
-          else_statement = make_statement_node ();
-        }
-
-      /// Build and return the tree with left child as the expression node &
-      /// right child as the code block to execute
-      tree = make_ast_node (
-          nd_If, expression,
-          make_ast_node (nd_If, condition_statement, else_statement));
-      break;
-
-    case lx_Print:             // print '(' expr {',' expr} ')'
-      /// If next lexeme is print, read next lexeme
-      ast_curr_lexeme = ast_curr_lexeme->next;
-
-      /// Loop over lexemes inside the left and right parantheses of print
-      /// statement, incrementing with every comma lexeme found
-      for (expect_lexeme (lx_Lparen);; expect_lexeme (lx_Comma))
-        {
-          /// For string inside print statement ...
-          if (ast_curr_lexeme->type == lx_String)
-            {
-              /// Build tree with left child as op-code to print string &
-              /// right child as the leaf node representing the string
-              expression = make_ast_node (
-                  nd_Prts, make_leaf_node (nd_String, ast_curr_lexeme), NULL);
-
-              /// ... and read next lexeme
-              ast_curr_lexeme = ast_curr_lexeme->next;
-            }
-          /// For integer inside print statement ...
-          else
-            {
-              /// Build tree with left child as op-code to print integer &
-              /// right child as the expression node representing the integer
-              expression = make_ast_node (
-                  nd_Prti, make_expression_node (0), NULL);
-
-              /// make_expression_node() will read next lexeme
-            }
-
-          /// Build tree for statement till this comma
-          tree = make_ast_node (nd_Sequence, tree, expression);
-
-          /// If no more commas in print statement, return tree
-          if (ast_curr_lexeme->type != lx_Comma)
-            break;
-        }
-
-      /// Expect a ')' & a ';' after print, else print error and exit
-      expect_lexeme (lx_Rparen);
-      expect_lexeme (lx_Semi);
-      break;
-
-    case lx_Semi:
-      /// If next lexeme is semicolon, read next lexeme & return tree
-      ast_curr_lexeme = ast_curr_lexeme->next;
-      break;
-
-    case lx_NOP:
-      /// If next lexeme is no operation, read next lexeme & return tree
-      ast_curr_lexeme = ast_curr_lexeme->next;
-      break;
-
-    case lx_Ident:
-      /// If next lexeme is an identifier create leaf node for it
-      value = make_leaf_node (nd_Ident, ast_curr_lexeme);
-
-      /// ... and read next lexeme
-      ast_curr_lexeme = ast_curr_lexeme->next;
-
-      /// Expect an '=' operator after an identifier, else print error and exit
-      expect_lexeme (lx_Assign);
-
-      /// Build expression tree whose result we will assign to the identifier
-      expression = make_expression_node (0);
-
-      /// Build tree with left child as identifier & right child as expression
-      tree = make_ast_node (nd_Assign, value, expression);
-
-      /// Expect a semi colon after expression, else print error and exit
-      expect_lexeme (lx_Semi);
-      break;
-
-    case lx_While:
-      /// If next lexeme is while, read next lexeme
-      ast_curr_lexeme = ast_curr_lexeme->next;
-
-      /// ... build expression node inside parantheses
-      expression = make_parentheses_expression ();
-
-      /// ... build tree node to execute if condition is true
-      condition_statement = make_statement_node ();
+      int cap = symbol_table->cap ? symbol_table->cap * 2 : 1024;
+      char *block = arena_alloc (&symbol_table->arena,
+                                 cap * (3 * sizeof(int) + sizeof(char)));
 
-      /// ... return while tree with left child as expression & right child as
-      /// code block to execute
-      tree = make_ast_node (nd_While, expression, condition_statement);
-      break;
+      int *offset = (int*) block;
+      int *length = offset + cap;
+      int *value = length + cap;
+      unsigned char *type = (unsigned char*) (value + cap);
 
-    case lx_Lbrace:
-      /// If next lexeme is left brace, build tree for code block until
-      /// right brace lexeme is found
-      /*for ( expect (lx_Lbrace); ast_curr_lexeme->type != lx_Rbrace && ast_curr_lexeme->type != lx_EOF; )
-        {
-          tree = make_ast_node (nd_Sequence, tree, make_statement_node ());
-        }
-        */
-      expect_lexeme (lx_Lbrace);
-      while (ast_curr_lexeme->type != lx_Rbrace
-          && ast_curr_lexeme->type != lx_EOF)
+      if (symbol_table->count)
         {
-          tree = make_ast_node (nd_Sequence, tree, make_statement_node ());
+          memcpy (offset, symbol_table->offset,
+                  symbol_table->count * sizeof(int));
+          memcpy (length, symbol_table->length,
+                  symbol_table->count * sizeof(int));
+          memcpy (value, symbol_table->value,
+                  symbol_table->count * sizeof(int));
+          memcpy (type, symbol_table->type, symbol_table->count);
         }
 
-      /// Expect a right brace after code block and return tree, else print
-      /// error and exit
-      expect_lexeme (lx_Rbrace);
-      break;
-
-    case lx_EOF:
-      /// If next lexeme is end of file, break and return tree
-      break;
-
-    default:
-      /// Statements cannot start with any other type of lexeme
-      fprintf(stderr, "[%d:%d] Cannot start statement with '%s': %s\n",
-             ast_curr_lexeme->line, ast_curr_lexeme->column,
-             grammar[ast_curr_lexeme->type].text, ast_curr_lexeme->char_val);
-      exit(opal_exit(EXIT_FAILURE));
+      symbol_table->offset = offset;
+      symbol_table->length = length;
+      symbol_table->value = value;
+      symbol_table->type = type;
+      symbol_table->cap = cap;
     }
 
-  return tree;
+  int index = symbol_table->count++;
+  symbol_table->type[index] = lexeme->type;
+  symbol_table->offset[index] = lexeme->offset;
+  symbol_table->length[index] = lexeme->length;
+
+  /// Strings and identifiers keep the id of their interned text
+  if (lexeme->type == lx_String || lexeme->type == lx_Ident)
+    symbol_table->value[index] = lexeme->str_id;
+  else
+    symbol_table->value[index] = lexeme->int_val;
 }
 
 /**
- * @brief       Optimize the abstract syntax tree
- * @param[in]   tree
+ * @brief       Get string or identifier value of lexeme in symbol table
+ *
+ * @param[in]   symbol_table    Symbol table holding the lexeme
+ * @param[in]   index           Index of lexeme
  *
- * @return      Optimized abstract syntax tree root pointer
+ * @return      Value of lexeme
  *
- * @retval      node_s*     On success
- * @retval      NULL        On error
+ * @retval      char*       For string and identifier lexemes
+ * @retval      NULL        For all other lexemes
  */
-node_s*
-optimize_syntax_tree(node_s *tree)
+const char*
+get_symbol_str (const symbol_table_s *symbol_table, int index)
 {
+  lexeme_type_e type = symbol_table->type[index];
 
-  /// Return NULL if no node
-  if (!tree)
-    return NULL;
-
-  /// If no left or right child nodes
-  if (!tree->left && !tree->right)
-    {
-      if (tree->node_type == nd_Sequence)
-        {
-          /// Empty code block with no child nodes
-          return NULL;
-        }
-      else
-        {
-          /// Leaf node
-          return tree;
-        }
-    }
-
-  /// If no left node, return address of right
-  if (!tree->left
-      && (tree->node_type == nd_Sequence || tree->node_type == nd_If))
-    return optimize_syntax_tree (tree->right);
-
-  /// If no right node, return address of left
-  else if (!tree->right
-      && (tree->node_type == nd_Sequence || tree->node_type == nd_If))
-    return optimize_syntax_tree (tree->left);
-
-  /// If node has left and right nodes, optimize them
-  tree->left = optimize_syntax_tree (tree->left);
-  tree->right = optimize_syntax_tree (tree->right);
+  if (type == lx_String || type == lx_Ident)
+    return get_interned_str (symbol_table->value[index]);
 
-  return tree;
+  return NULL;
 }
 
 /**
- * @brief           Print abstract syntax tree to destination file
+ * @brief       Populate symbol table with lexemes in source file pointer
  *
- * @param[in]       syntax_tree       Abstract syntax tree
- * @param[in,out]   dest_fp           Destination file pointer
+ * @param[in,out]   *symbol_table    Symbol table to populate
  *
  * @return      The error return code of the function.
  *
- * @retval          EXIT_SUCCESS    On success
- * @retval          EXIT_FAILURE    On error
- * @retval          errno           On system call failure
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    On error
+ * @retval      errno           On system call failure
  *
  */
 short
-print_ast (node_s *syntax_tree, FILE *dest_fp)
+build_symbol_table (symbol_table_s *symbol_table)
 {
   logger(DEBUG, "=== START ===");
 
-  /// Check if syntax tree pointer is not NULL
-  logger(DEBUG, "assert(syntax_tree)");
-  assert(syntax_tree);
+  /// Assert symbol table pointer is not NULL
+  logger(DEBUG, "assert(symbol_table)");
+  assert(symbol_table);
   _PASS;
 
-  /// Print syntax tree in pre-traversal mode to destination file pointer
-  traverse_ast (syntax_tree, dest_fp);
+  /// Dummy lexeme at the head of the table has no source position
+  next_lexeme = (lexeme_s) { .type = lx_NOP, .offset = -1 };
+  append_symbol (symbol_table, &next_lexeme);
+
+  /// Get lexemes in a loop until we get a EOF lexeme
+  do
+    {
+      /// Call get_next_lexeme() to populate next_lexeme
+      next_lexeme = get_next_lexeme ();
+
+      /// Append next_lexeme to symbol table
+      append_symbol (symbol_table, &next_lexeme);
+
+      /// Call get_lexeme_str() to stringify next_lexeme when it is logged
+      if (LOG_LEVEL >= DEBUG)
+        {
+          if (get_lexeme_str (symbol_table, symbol_table->count - 1,
+                              lexeme_str, lexeme_str_len) != EXIT_SUCCESS)
+            return (EXIT_FAILURE);
+          logger(DEBUG, "Append lexeme {%s}", lexeme_str);
+        }
+    }
+  while (next_lexeme.type != lx_EOF);
 
   logger(DEBUG, "=== END ===");
-  return (EXIT_SUCCESS);
+  return EXIT_SUCCESS;
 }
 
 /**
- * @brief           Traverse abstract syntax tree pre-order
- * @param[in]    node       Abstract syntax tree node to print
- * @param[in]    report_fp  Destination report file pointer
- * @param[in]    level      Level in tree
+ * @brief       Print symbol table to destination file pointer
+ *
+ * @param[in]       symbol_table    Symbol table to print
+ * @param[in,out]   dest_fp         Destination file pointer
+ *
+ * @return      The error return code of the function.
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    On error
+ * @retval      errno           On system call failure
+ *
  */
-void
-traversePreOrder_graph (node_s *node, FILE *report_fp, int level)
+short
+print_symbol_table (const symbol_table_s *symbol_table, FILE *dest_fp)
 {
-  /// If node to print is null, return
-  if (!node)
-    return;
-
-  /// If node is string, print char_val
-  if (node->node_type == nd_String)
-    fprintf (report_fp, "%d[\"'%s'\"]:::%s\n", level, node->char_val,
-             node_name[node->node_type]);
-
-  /// If node is identifier, print name
-  else if (node->node_type == nd_Ident)
-      fprintf (report_fp, "%d[%s]:::%s\n", level, node->char_val,
-               node_name[node->node_type]);
-
-  /// ... if node is integer, print the int_val
-  else if (node->node_type == nd_Integer)
-    fprintf (report_fp, "%d[%d]:::%s\n", level, node->int_val,
-             node_name[node->node_type]);
+  logger(DEBUG, "=== START ===");
 
-  /// ... else, print node type name
-  else
-    fprintf (report_fp, "%d[%s]:::%s\n", level, node_name[node->node_type],
-             node_name[node->node_type]);
+  /// Assert symbol table pointer is not NULL
+  logger(DEBUG, "assert(symbol_table)");
+  assert(symbol_table);
+  _PASS;
 
-  /// If node has left/right child nodes, create connection with array index
-  if (node->left)
-    fprintf (report_fp,"%d --> %d\n", level, level*2 + 1);
+  /// Assert destination file pointer is not NULL
+  logger(DEBUG, "assert(dest_fp)");
+  assert(dest_fp);
+  _PASS;
 
-  if (node->right)
-    fprintf (report_fp,"%d --> %d\n", level, level*2 + 2);
+  /// Write ALEX to destination file
+  logger (DEBUG, "Writing ALEX output to destination file.");
 
-  /// Print child nodes of tree recursively for left and right child nodes
-  if (node->left || node->right)
+  /// The closing EOF lexeme is not printed
+  int index = 0;
+  for (index = 0; index < symbol_table->count - 1; index++)
     {
-      traversePreOrder_graph (node->left, report_fp, level*2 + 1);
-      traversePreOrder_graph (node->right, report_fp, level*2 + 2);
+      /// Call get_lexeme_str() to stringify lexeme
+      retVal = get_lexeme_str (symbol_table, index, lexeme_str,
+                               lexeme_str_len);
+      if (retVal != EXIT_SUCCESS)
+        return (EXIT_FAILURE);
+
+      /// Append lexeme to destination file
+      retVal = fprintf (dest_fp, "%s\n", lexeme_str);
+      if (retVal < 0)
+        {
+          perror ("fprintf (dest_fp, next_lexeme_str)");
+          exit (opal_exit (retVal));
+        }
     }
+  _DONE;
+
+  logger(DEBUG, "=== END ===");
+  return EXIT_SUCCESS;
 }
 
 /**
- * @brief           Print abstract syntax tree tree to HTML report file
+ * @brief       Print symbol table HTML report to report file pointer
  *
- * @param[in]       syntax_tree       Abstract syntax tree
- * @param[in,out]   report_fp         Report file pointer
+ * @param[in]       symbol_table    Symbol table to print
+ * @param[in,out]   report_fp       Report file pointer
  *
  * @return      The error return code of the function.
  *
@@ -2090,320 +1670,2498 @@ traversePreOrder_graph (node_s *node, FILE *report_fp, int level)
  *
  */
 short
-print_ast_html (node_s *syntax_tree, FILE *report_fp)
+print_symbol_table_html (const symbol_table_s *symbol_table, FILE *report_fp)
 {
   logger(DEBUG, "=== START ===");
 
-  /// Check if syntax tree pointer is not NULL
-  logger(DEBUG, "assert(syntax_tree)");
-  assert(syntax_tree);
+  /// Assert symbol table pointer is not NULL
+  logger(DEBUG, "assert(symbol_table)");
+  assert(symbol_table);
   _PASS;
 
-  /// Write mermaid graph header
-  fprintf(report_fp, "<div class='mermaid'>\ngraph TD;\n");
+  /// Assert destination file pointer is not NULL
+  logger(DEBUG, "assert(report_fp)");
+  assert(report_fp);
+  _PASS;
 
-  /// Open res/mermaid.styles in read-only mode
-  char *mermaid_fn = "res/mermaid.styles";
-  sprintf (perror_msg, "css_fp = fopen ('%s', 'r')", mermaid_fn);
-  logger (DEBUG, perror_msg);
+  /// Walk the symbol table & print the HTML report to destination file pointer
+  logger(DEBUG, "Walk symbol table and print lexemes to HTML report");
 
-  errno = EXIT_SUCCESS;
-  FILE *mermaid_fp = fopen (mermaid_fn, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      exit (opal_exit(errno));
-    }
+  fprintf (
+      report_fp,
+      "<h3>Symbol table by Lexical analyzer <code>ALEX</code></h3>\n<hr>\n");
+  fprintf (report_fp,
+           "<div class='scroll'><table>\n" "<tr>\n" "<th>Line No.</th>\n"
+           "<th>Column No.</th>\n" "<th>Type</th>\n" "<th>Value</th>\n"
+           "</tr>");
 
-  /// Copy CSS to HTML report
-  logger (DEBUG, "Copying Mermaid styles to HTML report");
-  char ch = 0;
-  while ((ch = fgetc (mermaid_fp)) != EOF)
-    fputc (ch, report_fp);
-  _DONE;
-  fprintf(report_fp, "\n");
+  /// Append symbol table to report file
+  logger (DEBUG, "Copying ALEX output to HTML report");
 
-  /// Close res/styles.css file
-  sprintf (perror_msg, "fclose(mermaid_fp)");
-  logger (DEBUG, perror_msg);
-  if (fclose (mermaid_fp) == EXIT_SUCCESS)
-    _PASS;
-  else
+  int line = 0, col = 0;
+  int index = 0;
+  for (index = 0; index < symbol_table->count - 1; index++)
     {
-      perror (perror_msg);
-      _FAIL;
-      exit (opal_exit (errno));
-    }
-
-  /// Print abstract syntax tree to report
-  traversePreOrder_graph (syntax_tree, report_fp, 0);
+      lexeme_type_e type = symbol_table->type[index];
 
-  /// Write mermaid graph footer
-  fprintf(report_fp, "</div>\n"
-          "<script src='https://cdn.jsdelivr.net/npm/mermaid/dist/mermaid.min.js'></script>\n"
-          "<script>mermaid.initialize({startOnLoad:true, flowchart: {curve:'cardinal', useMaxWidth:false, }, });</script>\n");
+      get_line_col (symbol_table->offset[index], &line, &col);
+      fprintf (report_fp, "<tr>");
+      fprintf (report_fp, "<td>%d</td>\n"
+               "<td>%d</td>\n"
+               "<td>%s</td>\n",
+               line, col,
+               op_name[type]);
 
-  sprintf (perror_msg, "fflush(graph_fp)");
-  logger (DEBUG, perror_msg);
+      if (type == lx_Integer)
+        {
+          fprintf (report_fp, "<td>%d</td>\n", symbol_table->value[index]);
+        }
+      else if (type == lx_Ident)
+        {
+          fprintf (report_fp, "<td>%s</td>\n",
+                   get_symbol_str (symbol_table, index));
+        }
+      else if (type == lx_String)
+        {
+          fprintf (report_fp, "<td>\"%s\"</td>\n",
+                   get_symbol_str (symbol_table, index));
+        }
+      else
+        {
+          fprintf (report_fp, "<td></td>\n");
+        }
+      fprintf (report_fp, "</tr>\n");
+    }
 
-  errno = EXIT_SUCCESS;
+  fprintf (report_fp, "</table></div>\n");
   fflush (report_fp);
-  if (errno == EXIT_SUCCESS)
+
+  _DONE;
+
+  /// Flush contents of report to disk
+  sprintf (perror_msg, "fflush(report_fp)");
+  logger(DEBUG, perror_msg);
+  if (fflush (report_fp) == EXIT_SUCCESS)
     _PASS;
   else
     {
-      perror(perror_msg);
       _FAIL;
+      perror (perror_msg);
       return (errno);
     }
 
+  _DONE;
+
   logger(DEBUG, "=== END ===");
-  return (EXIT_SUCCESS);
+  return EXIT_SUCCESS;
 }
 
 /**
- * @brief       Free memory allocated for syntax tree
+ * @brief       Free memory allocated for symbol table
  *
- * @param[in,out]   node   Syntax tree to deallocate
+ * @param[in,out]   symbol_table    Symbol table to deallocate
  *
  * @return      NULL
  *
  */
 void
-free_syntax_tree (node_s *node)
+free_symbol_table (symbol_table_s *symbol_table)
+{
+  logger(DEBUG, "=== START ===");
+
+  /// All lexeme arrays were allocated from the arena of the table
+  logger(DEBUG, "Free %d symbols", symbol_table->count);
+  arena_free (&symbol_table->arena);
+  memset (symbol_table, 0, sizeof(symbol_table_s));
+
+  logger(DEBUG, "=== END ===");
+}
+
+/*
+ * ==================================
+ * END ALEX FUNCTION DEFINITIONS
+ * ==================================
+ */
+
+/*
+ * ==================================
+ * START ASTRO FUNCTION DEFINITIONS
+ * ==================================
+ */
+
+/**
+ * @brief       Grow array of node indices to hold at least need indices
+ *
+ * @param[in,out]   array       Array of node indices
+ * @param[in,out]   cap         Number of indices allocated in array
+ * @param[in]       need        Number of indices the array must hold
+ */
+void
+grow_index_array (unsigned int **array, unsigned int *cap, unsigned int need)
 {
-  if (!node)
+  if (need <= *cap)
     return;
 
-  free_syntax_tree(node->left);
-  free_syntax_tree(node->right);
+  /// Double array size until it is large enough
+  unsigned int new_cap = *cap ? *cap : 64;
+  while (new_cap < need)
+    new_cap *= 2;
 
-  if (node->char_val)
+  unsigned int *new_array = realloc (*array, new_cap * sizeof(unsigned int));
+  if (!new_array)
     {
-      free(node->char_val);
-      node->char_val = NULL;
+      perror ("realloc (index array)");
+      exit (opal_exit (errno));
     }
-
-  free(node);
-  node = NULL;
+  *array = new_array;
+  *cap = new_cap;
 }
 
 /**
- * @brief                   Traverses the syntax tree while printing the contents to dest_fp.
+ * @brief       Append a node of given type to the syntax tree node array
  *
- * @param[in]   node        The syntax tree node to be processed
- * @param[in]   dest_fp     The file to which the node's content will be printed
+ * @details     The array doubles in size when full. Node 0 is reserved so
+ * that index 0 can stand for a missing child.
  *
- * @return                  NULL
+ * @param[in]   type            Node type to create
+ *
+ * @return      Index of the new node in ast.nodes
  */
-void
-traverse_ast(node_s *node, FILE *dest_fp)
+unsigned int
+add_ast_node (ast_node_type_e type)
 {
-    /// We have reached a NULL leaf
-    if (!node)
-        return;
+  /// Reserve node 0 for an empty tree
+  if (ast.count == 0)
+    ast.count = 1;
 
-    /// If node is identifier or string, print char_val
-    if (node->node_type == nd_Ident || node->node_type == nd_String)
-        fprintf (dest_fp, "%s\n", node->char_val);
-
-    /// ... if node is integer, print the int_val
-    else if (node->node_type == nd_Integer)
-        fprintf (dest_fp, "%d\n", node->int_val);
+  /// Double node array if full
+  if (ast.count >= ast.cap)
+    {
+      unsigned int cap = ast.cap ? ast.cap * 2 : 256;
+      node_s *nodes = realloc (ast.nodes, cap * sizeof(node_s));
+      if (!nodes)
+        {
+          perror ("realloc (ast.nodes)");
+          exit (opal_exit (errno));
+        }
+      ast.nodes = nodes;
+      ast.cap = cap;
+    }
 
-    /// ... else, print node type name
-    else
-        fprintf (dest_fp, "%s\n", node_name[node->node_type]);
+  /// Initialize node with no children
+  node_s *node = &ast.nodes[ast.count];
+  memset (node, 0, sizeof(node_s));
+  node->node_type = type;
 
-    /// Recursive calls for further tree traversal
-    traverse_ast (node->left, dest_fp);
-    traverse_ast (node->right, dest_fp);
+  return ast.count++;
 }
 
-/*
- * ==================================
- * START GENIE FUNCTION DEFINITIONS
- * ==================================
+/**
+ * @brief       Add statement to the innermost block being parsed
+ *
+ * @details     Empty statements are skipped.
+ *
+ * @param[in]   stmt            Statement node index, 0 if none
  */
+void
+add_block_stmt (unsigned int stmt)
+{
+  if (!stmt)
+    return;
+
+  grow_index_array (&ast.open, &ast.open_cap, ast.open_len + 1);
+  ast.open[ast.open_len++] = stmt;
+}
 
 /**
- * @brief Append ASM code to array
- * @param code      ASM code
- * @param intval    Integer value
- * @param label     String value
+ * @brief       Close the block of statements added since mark
+ *
+ * @details     The statements are moved from ast.open to the end of ast.list,
+ * so every block keeps its statements next to each other however deeply
+ * blocks are nested.
+ *
+ * @param[in]   mark            Value of ast.open_len when the block started
+ *
+ * @return      Index of the new nd_Sequence node
  */
-void
-add_asm_code (asm_code_e code, int intval, char *label)
+unsigned int
+make_block_node (unsigned int mark)
 {
-  /// Create struct with given intval and code
-  asm_cmd_e asm_cmd = { 0 };
-  asm_cmd.intval = intval;
-  asm_cmd.cmd = code;
+  unsigned int len = ast.open_len - mark;
+  unsigned int block = add_ast_node (nd_Sequence);
 
-  /// Add the asm_code label if there is one
-  if (label)
-    asm_cmd.label = strdup (label);
+  if (len)
+    {
+      grow_index_array (&ast.list, &ast.list_cap, ast.list_len + len);
+      memcpy (ast.list + ast.list_len, ast.open + mark,
+              len * sizeof(unsigned int));
+    }
 
-  logger(DEBUG, "Added command - cmd: %s, label: %s", asm_cmds[asm_cmd.cmd],
-         asm_cmd.label ? asm_cmd.label : "NULL");
+  ast.nodes[block].first = ast.list_len;
+  ast.nodes[block].len = len;
+  ast.list_len += len;
+  ast.open_len = mark;
 
-  /// Adds the asm_cmd
-  asm_cmd_list[asm_cmd_list_len++] = asm_cmd;
+  logger (DEBUG, "node->%s\tstatements->%u", node_name[nd_Sequence], len);
+
+  return block;
 }
 
 /**
- * @brief Generate assembly command list from given abstract syntax tree
- * @param       ast   Abstract syntax tree
+ * @brief       Return syntax tree node with given left and right child nodes
  *
- * @return      NULL
+ * @param[in]   type            Node type to create
+ * @param[in]   left_child      Left child node index
+ * @param[in]   right_child     Right child node index
+ *
+ * @return      Abstract syntax tree node index
  */
-void
-gen_asm_code (node_s *ast)
+unsigned int
+make_ast_node(ast_node_type_e type, unsigned int left_child,
+              unsigned int right_child)
 {
-  int location_offset = 0;
-  // int int_val = 0;
-  char start_label[64] = { 0 };
-  char else_label[64] = { 0 };
-  char end_label[64] = { 0 };
 
-  if (!ast)
-    return;
+  /// Create node with given children and return
+  unsigned int tree = add_ast_node (type);
+  ast.nodes[tree].left = left_child;
+  ast.nodes[tree].right = right_child;
 
-  switch (ast->node_type)
-    {
-    case nd_Sequence:
-      gen_asm_code (ast->left);
-      gen_asm_code (ast->right);
-      break;
-    case nd_While:
-      sprintf (start_label, "_while_loop_%d", asm_cmd_list_len);
-      sprintf (end_label, "_while_end_%d", asm_cmd_list_len);
+  /// Log node message only when it will be written
+  if (LOG_LEVEL < DEBUG)
+    return tree;
 
-      add_asm_code (asm_Label, 0, start_label);     // while block start
-      gen_asm_code (ast->left);                     // check condition
-      add_asm_code (asm_Jz, 0, end_label);          // if false, end
-      gen_asm_code (ast->right);                    // body
-      add_asm_code (asm_Jmp, 0, start_label);       // loop back
-      add_asm_code (asm_Label, 0, end_label);       // while block end
+  /// Create buffer for logging
+  char buffer[1024] = { 0 };
 
-      break;
-    case nd_If:
-      sprintf (start_label, "_if_%d", asm_cmd_list_len);
-      sprintf (else_label, "_else_%d", asm_cmd_list_len);
-      sprintf (end_label, "_fi_%d", asm_cmd_list_len);
+  /// Append left child node type to log buffer
+  strcat (buffer, "left->");
+  if (left_child)
+    strcat (buffer, node_name[ast.nodes[left_child].node_type]);
+  else
+    strcat (buffer, "NULL");
 
-      add_asm_code (asm_Label, 0, start_label);    // start if
-      gen_asm_code (ast->left);                    // check condition
-      add_asm_code (asm_Jz, 0, else_label);        // false, jump to else block
-      gen_asm_code (ast->right->left);             // true, execute body ..
-      add_asm_code (asm_Jmp, 0, end_label);        // .. and exit
-      add_asm_code (asm_Label, 0, else_label);     // start else
-      gen_asm_code (ast->right->right);            // execute else body and exit
-      add_asm_code (asm_Label, 0, end_label);      // if/else end
+  /// Append current node type to log buffer
+  strcat (buffer, "\tnode->");
+  strcat (buffer, node_name[type]);
 
-      break;
-    case nd_Add:
-    case nd_Sub:
-    case nd_Mul:
-    case nd_Div:
-    case nd_Mod:
-    case nd_Eq:
-    case nd_Neq:
-    case nd_Lss:
-    case nd_Gtr:
-    case nd_Leq:
-    case nd_Geq:
-    case nd_And:
-    case nd_Or:
-      gen_asm_code(ast->left);
-      gen_asm_code(ast->right);
-      add_asm_code(ast->node_type, 0, NULL);
-      break;
-    case nd_Negate:
-    case nd_Not:
-      gen_asm_code(ast->left);
-      add_asm_code(ast->node_type, 0, NULL);
-      break;
-    case nd_Ident:
-      location_offset = add_var(ast->char_val);
-      add_asm_code(asm_Fetch, location_offset, NULL);
-      break;
-    case nd_Integer:
-      add_asm_code(asm_Push, ast->int_val, NULL);
-      break;
-    case nd_String:
-      location_offset = add_str(ast->char_val);
-      add_asm_code(asm_Push, location_offset, NULL);
-      break;
-    case nd_Assign:
-      gen_asm_code(ast->right);
-      location_offset = add_var(ast->left->char_val);
-      add_asm_code(asm_Store, location_offset, NULL);
-      break;
-    case nd_Input:
-      gen_asm_code(ast->left);
-      add_asm_code(asm_Input, 0, NULL);
-      break;
-    case nd_Prti:
-      gen_asm_code(ast->left);
-      add_asm_code(asm_Prti, 0, NULL);
-      break;
-    case nd_Prts:
-      gen_asm_code(ast->left);
-      add_asm_code(asm_Prts, 0, NULL);
-      break;
-    default:
-      fprintf(stderr, "Unexpected operator: %s\n", node_name[ast->node_type]);
-      exit (opal_exit (EXIT_FAILURE));
-    }
+  /// Append right child node type to log buffer
+  strcat (buffer, "\tright->");
+  if (right_child)
+    strcat (buffer, node_name[ast.nodes[right_child].node_type]);
+  else
+    strcat (buffer, "NULL");
 
-  return;
+  /// Log node message
+  logger (DEBUG, buffer);
+
+  return tree;
 }
 
 /**
- * @brief Print assembly command list
+ * @brief       Start a pre-order traversal of the syntax tree
  *
- * @param       cmd_list    Assembly command list to print
- * @param       dest_fp     Destination file pointer
+ * @param[in,out]   walk        Traversal state
+ * @param[in]       root        Index of node to start at, 0 for none
+ */
+void
+ast_walk_start (ast_walk_s *walk, unsigned int root)
+{
+  walk->len = 0;
+  grow_index_array (&walk->stack, &walk->cap, 1);
+  if (root)
+    walk->stack[walk->len++] = root;
+}
+
+/**
+ * @brief       Return next node of a pre-order traversal
  *
- * @return      Function exit code
+ * @details     Nodes are visited parent first, then the left subtree, then
+ * the right subtree, without recursion. The statements of a block are
+ * visited in order.
  *
- * @retval      EXIT_SUCCESS    On success
- * @retval      EXIT_FAILURE    On error
+ * @param[in,out]   walk        Traversal state
+ *
+ * @return      Index of the next node
+ *
+ * @retval      Node index  While nodes remain
+ * @retval      0           When the traversal is done
  */
-short
-print_asm_code(asm_cmd_e cmd_list[], FILE *dest_fp)
+unsigned int
+ast_walk_next (ast_walk_s *walk)
 {
-  /*
-   * Traverse and print the assembly code
-   * Steps:
-   * 1. Print macro header
-   * 2. Print user code
-   * 3. Print footer
-   * 4. Create strings and their lengths
-   *    4a. Read each string character and print ASCII value for newline
-   *    4b. NULL terminate string
-   *    4c. Print string length
-   *    4d. Print strings and lengths array
-   * 5. Create variables array
-   */
+  if (walk->len == 0)
+    return 0;
 
-    /// Open header file in 'r' mode
-    sprintf (perror_msg, "header_fp = fopen('res/header.asm', 'r')");
-    logger(DEBUG, perror_msg);
-    FILE *header_fp = NULL;
-    errno = EXIT_SUCCESS;
-    header_fp = fopen ("res/header.asm", "r");
-    if (errno == EXIT_SUCCESS)
-        _PASS;
-    else
+  unsigned int index = walk->stack[--walk->len];
+  const node_s *node = &ast.nodes[index];
+
+  /// Push block statements last to first so the first is visited first
+  if (node->node_type == nd_Sequence)
     {
-        perror (perror_msg);
-        _FAIL;
-        return (errno);
+      grow_index_array (&walk->stack, &walk->cap, walk->len + node->len);
+      unsigned int i = node->len;
+      while (i--)
+        walk->stack[walk->len++] = ast.list[node->first + i];
+      return index;
+    }
+
+  /// Push right child first so the left subtree is visited first
+  grow_index_array (&walk->stack, &walk->cap, walk->len + 2);
+  if (node->right)
+    walk->stack[walk->len++] = node->right;
+  if (node->left)
+    walk->stack[walk->len++] = node->left;
+
+  return index;
+}
+
+/**
+ * @brief       Free the stack of a syntax tree traversal
+ *
+ * @param[in,out]   walk        Traversal state
+ */
+void
+ast_walk_end (ast_walk_s *walk)
+{
+  free (walk->stack);
+  walk->stack = NULL;
+  walk->len = walk->cap = 0;
+}
+
+/**
+ * @brief       Build abstract syntax tree from symbol table
+ *
+ * @param       symbol_table       Lexeme symbol table
+ *
+ * @return      Abstract syntax tree built from the symbol table
+ *
+ * @retval      Tree root node index        On success
+ * @retval      0                           On error
+ *
+ */
+unsigned int
+build_syntax_tree (const symbol_table_s *symbol_table)
+{
+  logger(DEBUG, "=== START ===");
+
+  /// Check if symbol table pointer is not NULL
+  logger(DEBUG, "assert(symbol_table)");
+  assert(symbol_table);
+  _PASS;
+
+  /// Start a new syntax tree, node 0 stands for no node
+  ast.count = 1;
+  ast.list_len = 0;
+  ast.open_len = 0;
+
+  /// Start reading lexemes from the head of the symbol table
+  ast_symbols = symbol_table;
+  ast_curr = 0;
+
+  /// Add statements to the program block until lexeme with lx_EOF is seen
+  do {
+      add_block_stmt (make_statement_node ());
+  } while (ast_curr_type != lx_EOF);
+
+  unsigned int tree = make_block_node (0);
+
+  logger(DEBUG, "=== END ===");
+  return tree;
+}
+
+/**
+ * @brief       Check if lexeme is of expected type, else print error and exit
+ *
+ * @param[in]   expected_type   Expected lexeme type
+ *
+ * @return      NULL
+ */
+void
+expect_lexeme (lexeme_type_e expected_type)
+{
+  /// If lexeme at ast_curr is of expected type
+  if (ast_curr_type == expected_type)
+    {
+      /// ... read next lexeme and return
+      ++ast_curr;
+      return;
+    }
+
+  /// ... else print error and exit
+  fprintf(stderr, "%s expected but %s found.", grammar[expected_type].text,
+         grammar[ast_curr_type].text);
+  exit (opal_exit (EXIT_FAILURE));
+}
+
+/**
+ * @brief       Build and return expression inside parantheses
+ *
+ * @return      Index of syntax tree node
+ *
+ * @retval      Node index  On success
+ * @retval      0           On error
+ *
+ */
+unsigned int
+make_parentheses_expression(void)
+{
+  /// Expect left parantheses before the expression
+  expect_lexeme (lx_Lparen);
+
+  ///
+  unsigned int tree = 0;
+
+  /// Create tree for expression inside parantheses
+  tree = make_expression_node (0);
+
+  /// Expect right parantheses after the expression
+  expect_lexeme (lx_Rparen);
+
+  /// return tree
+  return tree;
+}
+
+/**
+ * @brief
+ *
+ * @param[in]   type            type of node in tree
+ * @param[in]   index           index of lexeme in symbol table to make leaf with
+ *
+ * @return      Index of syntax tree node
+ *
+ * @retval      Node index  On success
+ * @retval      0           On error
+ *
+ */
+unsigned int
+make_leaf_node (ast_node_type_e type, int index)
+{
+
+  logger(DEBUG, "=== START ===");
+
+  /// Create the leaf node to return
+  unsigned int leaf = add_ast_node (type);
+  node_s *node = &ast.nodes[leaf];
+
+  /// If lexeme type is a string or an identifier
+  if ((type == nd_String) || (type == nd_Ident))
+    node->str_id = ast_symbols->value[index];
+
+  /// Otherwise the lexeme type is an integer
+  else if (type == nd_Integer)
+    node->int_val = ast_symbols->value[index];
+
+  if (type == nd_Integer)
+    logger(DEBUG, "Returning leaf node with val: '%d'.", node->int_val);
+  else
+    logger(DEBUG, "Returning leaf node with val: '%s'.",
+           get_interned_str (node->str_id));
+
+  logger(DEBUG, "=== END ===");
+  return leaf;
+}
+
+/**
+ * @brief       Push step of the expression parser on ast.expr
+ *
+ * @param[in]   precedence    Lowest precedence of binary operator to take
+ * @param[in]   op            Node to make from the operand, nd_NOP if none
+ * @param[in]   left          Left child of binary operator node, else 0
+ * @param[in]   paren         TRUE if operand must be closed by ')'
+ */
+void
+push_expr_frame (int precedence, ast_node_type_e op, unsigned int left,
+                 short paren)
+{
+  /// Double stack size if full
+  if (ast.expr_len == ast.expr_cap)
+    {
+      unsigned int cap = ast.expr_cap ? ast.expr_cap * 2 : 64;
+      expr_frame_s *expr = realloc (ast.expr, cap * sizeof(expr_frame_s));
+      if (!expr)
+        {
+          perror ("realloc (ast.expr)");
+          exit (opal_exit (errno));
+        }
+      ast.expr = expr;
+      ast.expr_cap = cap;
+    }
+
+  expr_frame_s *frame = &ast.expr[ast.expr_len++];
+  frame->precedence = precedence;
+  frame->op = op;
+  frame->left = left;
+  frame->paren = paren;
+}
+
+/**
+ * @brief       Build and return expression node
+ *
+ * @details     Precedence climbing driven by grammar[], with the pending
+ * operators kept on ast.expr instead of the C stack. Each frame stands for
+ * one operand still being read: the operand of a unary operator, the right
+ * side of a binary operator or the contents of parentheses.
+ *
+ * @param[in]   precedence    Precedence of mathematical operation
+ *
+ * @return      Index of syntax tree node
+ *
+ * @retval      Node index  On success
+ * @retval      0           On error
+ */
+unsigned int
+make_expression_node(int precedence)
+{
+  /// Create the tree node to return
+  unsigned int tree = 0;
+  unsigned int base = ast.expr_len;
+  expr_frame_s done = { 0 };
+
+  lexeme_type_e operator = lx_NOP;
+  int line = 0, col = 0;
+
+  push_expr_frame (precedence, nd_NOP, 0, FALSE);
+
+  for (;;)
+    {
+      switch(ast_curr_type){
+
+        case lx_Not:
+          /// If lexeme type is Not, get next lexeme and read its operand
+          ++ast_curr;
+          push_expr_frame (grammar[lx_Not].precedence, nd_Not, 0, FALSE);
+          continue;
+
+        case lx_Add:
+        case lx_Sub:
+          /// If lexeme type is Add or Sub, get next lexeme and read its
+          /// operand, Sub makes a Negate node while Add keeps the operand
+          operator = ast_curr_type;
+          ++ast_curr;
+          push_expr_frame (grammar[lx_Negate].precedence,
+                           operator == lx_Sub ? nd_Negate : nd_NOP, 0, FALSE);
+          continue;
+
+        case lx_Lparen:
+          /// If lexeme type is Lparen, read the expression inside
+          expect_lexeme (lx_Lparen);
+          push_expr_frame (0, nd_NOP, 0, TRUE);
+          continue;
+
+        case lx_Integer:
+          /// If lexeme type is Integer, make leaf node and get next lexeme
+          tree = make_leaf_node(nd_Integer, ast_curr);
+          ++ast_curr;
+          break;
+
+        case lx_Ident:
+          /// If lexeme type is Ident, make leaf node and get next lexeme
+          tree = make_leaf_node(nd_Ident, ast_curr);
+          ++ast_curr;
+          break;
+
+        case lx_Input:
+          /// If lexeme type is Input, get next lexeme
+          ++ast_curr;
+
+          /// ...expect LParen
+          expect_lexeme(lx_Lparen);
+
+          /// ... and make Input node with the prompt String as its child
+          tree = make_ast_node (nd_Input,make_leaf_node(nd_String, ast_curr),0);
+
+          /// ... and expect String contents
+          expect_lexeme(lx_String);
+
+          /// ... finally expect Rparen to close Input
+          expect_lexeme(lx_Rparen);
+          break;
+
+        default:
+          /// Expressions cannot start with any other type of lexeme
+          get_line_col (ast_symbols->offset[ast_curr], &line, &col);
+          fprintf (stderr, "[%d:%d] Unexpected lexeme type found: %s\n",
+                   line, col,
+                   op_name[ast_curr_type]);
+          exit (opal_exit (EXIT_FAILURE));
+      }
+
+      /// Operand read, hand it to the frames waiting for it
+      for (;;)
+        {
+          int frame_precedence = ast.expr[ast.expr_len - 1].precedence;
+
+          /// If the next lexeme is binary and its precedence is at least as
+          /// high as the frame's, the operand is its left side
+          if (grammar[ast_curr_type].is_binary
+              && grammar[ast_curr_type].precedence >= frame_precedence)
+            {
+              /// Save lexeme type and get next lexeme
+              operator = ast_curr_type;
+              ++ast_curr;
+
+              /// Read the right side with incremented precedence unless the
+              /// operator is right associative
+              push_expr_frame (grammar[operator].precedence
+                               + !grammar[operator].right_associative,
+                               grammar[operator].node_type, tree, FALSE);
+              break;
+            }
+
+          /// ... else the frame is complete, make its node
+          done = ast.expr[--ast.expr_len];
+          if (done.paren)
+            expect_lexeme (lx_Rparen);
+          else if (done.left)
+            tree = make_ast_node (done.op, done.left, tree);
+          else if (done.op != nd_NOP)
+            tree = make_ast_node (done.op, tree, 0);
+
+          /// Return when the first frame is complete
+          if (ast.expr_len == base)
+            return tree;
+        }
+    }
+}
+
+/**
+ * @brief       Build and return syntax tree node for a statement
+ *
+ * @return      Index of syntax tree node
+ *
+ * @retval      Node index  On success
+ * @retval      0           On error
+ */
+unsigned int
+make_statement_node (void)
+{
+  unsigned int tree = 0;                ///< Syntax tree node to return
+  unsigned int value = 0;               ///< Leaf node with int/string value
+  unsigned int expression = 0;          ///< Node for expression
+  unsigned int condition_statement = 0; ///< if/while condition statement node
+  unsigned int else_statement = 0;      ///< else condition statement node
+  unsigned int block_start = 0;         ///< ast.open_len when block started
+  int line = 0, col = 0;                ///< Position of lexeme for errors
+
+  switch (ast_curr_type)
+    {
+    case lx_If:
+      /// If next lexeme is if statement, read next lexeme
+      ++ast_curr;
+
+      /// ... get expression inside left parentheses
+      expression = make_parentheses_expression ();
+
+      /// ... get condition statement node
+      condition_statement = make_statement_node ();
+
+      /// ... and create else statement node as NULL
+      else_statement = 0;
+
+      /// If next lexeme is an else
+      if (ast_curr_type == lx_Else)
+        {
+          /// ... read next lexeme
+          ++ast_curr;
+
+          /// ... and make else statement node
+          else_statement = make_statement_node ();
+        }
+
+      /// Build and return the tree with left child as the expression node &
+      /// right child as the code block to execute
+      tree = make_ast_node (
+          nd_If, expression,
+          make_ast_node (nd_If, condition_statement, else_statement));
+      break;
+
+    case lx_Print:             // print '(' expr {',' expr} ')'
+      /// If next lexeme is print, read next lexeme
+      ++ast_curr;
+
+      /// Loop over lexemes inside the left and right parantheses of print
+      /// statement, incrementing with every comma lexeme found
+      block_start = ast.open_len;
+      for (expect_lexeme (lx_Lparen);; expect_lexeme (lx_Comma))
+        {
+          /// For string inside print statement ...
+          if (ast_curr_type == lx_String)
+            {
+              /// Build tree with left child as op-code to print string &
+              /// right child as the leaf node representing the string
+              expression = make_ast_node (
+                  nd_Prts, make_leaf_node (nd_String, ast_curr), 0);
+
+              /// ... and read next lexeme
+              ++ast_curr;
+            }
+          /// For integer inside print statement ...
+          else
+            {
+              /// Build tree with left child as op-code to print integer &
+              /// right child as the expression node representing the integer
+              expression = make_ast_node (
+                  nd_Prti, make_expression_node (0), 0);
+
+              /// make_expression_node() will read next lexeme
+            }
+
+          /// Add print of this argument to the block of the statement
+          add_block_stmt (expression);
+
+          /// If no more commas in print statement, return tree
+          if (ast_curr_type != lx_Comma)
+            break;
+        }
+      tree = make_block_node (block_start);
+
+      /// Expect a ')' & a ';' after print, else print error and exit
+      expect_lexeme (lx_Rparen);
+      expect_lexeme (lx_Semi);
+      break;
+
+    case lx_Semi:
+      /// If next lexeme is semicolon, read next lexeme & return tree
+      ++ast_curr;
+      break;
+
+    case lx_NOP:
+      /// If next lexeme is no operation, read next lexeme & return tree
+      ++ast_curr;
+      break;
+
+    case lx_Ident:
+      /// If next lexeme is an identifier create leaf node for it
+      value = make_leaf_node (nd_Ident, ast_curr);
+
+      /// ... and read next lexeme
+      ++ast_curr;
+
+      /// Expect an '=' operator after an identifier, else print error and exit
+      expect_lexeme (lx_Assign);
+
+      /// Build expression tree whose result we will assign to the identifier
+      expression = make_expression_node (0);
+
+      /// Build tree with left child as identifier & right child as expression
+      tree = make_ast_node (nd_Assign, value, expression);
+
+      /// Expect a semi colon after expression, else print error and exit
+      expect_lexeme (lx_Semi);
+      break;
+
+    case lx_While:
+      /// If next lexeme is while, read next lexeme
+      ++ast_curr;
+
+      /// ... build expression node inside parantheses
+      expression = make_parentheses_expression ();
+
+      /// ... build tree node to execute if condition is true
+      condition_statement = make_statement_node ();
+
+      /// ... return while tree with left child as expression & right child as
+      /// code block to execute
+      tree = make_ast_node (nd_While, expression, condition_statement);
+      break;
+
+    case lx_Lbrace:
+      /// If next lexeme is left brace, build block of statements until
+      /// right brace lexeme is found
+      expect_lexeme (lx_Lbrace);
+      block_start = ast.open_len;
+      while (ast_curr_type != lx_Rbrace
+          && ast_curr_type != lx_EOF)
+        {
+          add_block_stmt (make_statement_node ());
+        }
+      tree = make_block_node (block_start);
+
+      /// Expect a right brace after code block and return tree, else print
+      /// error and exit
+      expect_lexeme (lx_Rbrace);
+      break;
+
+    case lx_EOF:
+      /// If next lexeme is end of file, break and return tree
+      break;
+
+    default:
+      /// Statements cannot start with any other type of lexeme
+      get_line_col (ast_symbols->offset[ast_curr], &line, &col);
+      fprintf(stderr, "[%d:%d] Cannot start statement with '%s': %s\n",
+             line, col,
+             grammar[ast_curr_type].text, get_symbol_str (ast_symbols, ast_curr));
+      exit(opal_exit(EXIT_FAILURE));
+    }
+
+  return tree;
+}
+
+/**
+ * @brief       Evaluate operator on constant operands as the runtime would
+ *
+ * @details     Follows the macros in res/header.asm on 64-bit registers:
+ * arithmetic wraps, O_DIV and O_MOD divide RDX:RAX with RDX cleared,
+ * comparisons are signed. && and || are logical, as gen_asm_code() emits
+ * them as jumps on each operand. Operators the
+ * runtime would trap on, and results that do not fit the 32-bit immediate
+ * of PUSH, are left to the runtime.
+ *
+ * @param[in]   op          Operator node type
+ * @param[in]   left        Value of left operand
+ * @param[in]   right       Value of right operand, unused by unary operators
+ * @param[out]  result      Value of operator
+ *
+ * @return      Whether the operator was evaluated
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    If the operator can not be evaluated
+ */
+short
+eval_constant (ast_node_type_e op, int left, int right, int *result)
+{
+  int64_t a = left, b = right, value = 0;
+  uint64_t dividend = (uint64_t) a, divisor = 0, quotient = 0;
+
+  switch (op)
+    {
+    case nd_Add:
+      value = (int64_t) ((uint64_t) a + (uint64_t) b);
+      break;
+    case nd_Sub:
+      value = (int64_t) ((uint64_t) a - (uint64_t) b);
+      break;
+    case nd_Mul:
+      value = (int64_t) ((uint64_t) a * (uint64_t) b);
+      break;
+    case nd_Negate:
+      value = (int64_t) (0 - (uint64_t) a);
+      break;
+    case nd_Div:
+    case nd_Mod:
+      /// The dividend is RAX read as unsigned since RDX is 0, IDIV faults
+      /// on division by zero or a quotient beyond 64 bits
+      if (b == 0)
+        return EXIT_FAILURE;
+      divisor = b < 0 ? 0 - (uint64_t) b : (uint64_t) b;
+      quotient = dividend / divisor;
+      if (quotient > (b < 0 ? (uint64_t) INT64_MAX + 1 : (uint64_t) INT64_MAX))
+        return EXIT_FAILURE;
+      if (op == nd_Mod)
+        value = (int64_t) (dividend % divisor);
+      else
+        value = (int64_t) (b < 0 ? 0 - quotient : quotient);
+      break;
+    case nd_Eq:
+      value = a == b;
+      break;
+    case nd_Neq:
+      value = a != b;
+      break;
+    case nd_Lss:
+      value = a < b;
+      break;
+    case nd_Gtr:
+      value = a > b;
+      break;
+    case nd_Leq:
+      value = a <= b;
+      break;
+    case nd_Geq:
+      value = a >= b;
+      break;
+    case nd_And:
+      value = a && b;
+      break;
+    case nd_Or:
+      value = a || b;
+      break;
+    case nd_Not:
+      value = a == 0;
+      break;
+    default:
+      return EXIT_FAILURE;
+    }
+
+  if (value < INT_MIN || value > INT_MAX)
+    return EXIT_FAILURE;
+
+  *result = (int) value;
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief       Replace operators on constants with their value
+ *
+ * @details     Children are always made before their parent, so one pass
+ * over ast.nodes in order sees the operands of every operator folded
+ * before the operator itself. Each fold is recorded in ast.folds.
+ *
+ * @return      None
+ */
+void
+fold_constants (void)
+{
+  unsigned int index = 0;
+  int result = 0;
+
+  for (index = 1; index < ast.count; index++)
+    {
+      node_s *node = &ast.nodes[index];
+
+      /// Operands must be Integer nodes, unary operators have no right one
+      if (node->node_type == nd_Sequence || !node->left
+          || ast.nodes[node->left].node_type != nd_Integer)
+        continue;
+      if (node->right && ast.nodes[node->right].node_type != nd_Integer)
+        continue;
+
+      int left = ast.nodes[node->left].int_val;
+      int right = node->right ? ast.nodes[node->right].int_val : 0;
+      if (eval_constant (node->node_type, left, right, &result)
+          != EXIT_SUCCESS)
+        continue;
+
+      /// Record the fold for the report
+      if (ast.folds_len == ast.folds_cap)
+        {
+          unsigned int cap = ast.folds_cap ? ast.folds_cap * 2 : 64;
+          fold_s *folds = realloc (ast.folds, cap * sizeof(fold_s));
+          if (!folds)
+            {
+              perror ("realloc (ast.folds)");
+              exit (opal_exit (errno));
+            }
+          ast.folds = folds;
+          ast.folds_cap = cap;
+        }
+      ast.folds[ast.folds_len++] = (fold_s) { node->node_type, left, right,
+                                              result };
+
+      logger(DEBUG, "Folded %s(%d, %d) to %d", node_name[node->node_type],
+             left, right, result);
+
+      /// Turn the operator into an Integer leaf
+      node->node_type = nd_Integer;
+      node->left = node->right = 0;
+      node->int_val = result;
+    }
+}
+
+/**
+ * @brief       Optimize the abstract syntax tree
+ *
+ * @details     Folds constant expressions, then removes empty statements
+ * and blocks. One call does all the work.
+ *
+ * @param[in]   tree
+ *
+ * @return      Optimized abstract syntax tree root index
+ *
+ * @retval      Node index  On success
+ * @retval      0           On error
+ */
+unsigned int
+optimize_syntax_tree(unsigned int tree)
+{
+  fold_constants ();
+  return prune_syntax_tree (tree);
+}
+
+/**
+ * @brief       Check if statement never completes
+ *
+ * @details     Only a while loop with a constant true condition runs
+ * forever, as the language has no break. Blocks and if statements never
+ * complete when they can not get past such a loop.
+ *
+ * @param[in]   stmt        Pruned statement node index
+ *
+ * @return      TRUE if statement never completes, else FALSE
+ */
+short
+is_endless (unsigned int stmt)
+{
+  const node_s *node = &ast.nodes[stmt];
+
+  if (!stmt)
+    return FALSE;
+
+  switch (node->node_type)
+    {
+    case nd_While:
+      return ast.nodes[node->left].node_type == nd_Integer
+          && ast.nodes[node->left].int_val != 0;
+    case nd_Sequence:
+      return node->len && is_endless (ast.list[node->first + node->len - 1]);
+    case nd_If:
+      return is_endless (ast.nodes[node->right].left)
+          && is_endless (ast.nodes[node->right].right);
+    default:
+      return FALSE;
+    }
+}
+
+/**
+ * @brief       Remove empty statements and blocks, branches that can never
+ *              run and unreachable statements from the syntax tree
+ *
+ * @details     Blocks of one statement are replaced by the statement. An if
+ * with a constant condition is replaced by the branch it takes, a while
+ * with a constant false condition is removed, and statements after an
+ * endless loop are dropped. Variables and strings used only in removed
+ * code never reach the GENIE tables.
+ *
+ * @param[in]   tree
+ *
+ * @return      Pruned abstract syntax tree root index
+ *
+ * @retval      Node index  On success
+ * @retval      0           If nothing is left
+ */
+unsigned int
+prune_syntax_tree(unsigned int tree)
+{
+
+  /// Return 0 if no node
+  if (!tree)
+    return 0;
+
+  node_s *node = &ast.nodes[tree];
+
+  /// Prune block statements in place, dropping empty ones and those
+  /// after a statement that never completes
+  if (node->node_type == nd_Sequence)
+    {
+      unsigned int *stmt = ast.list + node->first;
+      unsigned int i = 0, len = 0;
+      for (i = 0; i < node->len; i++)
+        {
+          if (!(stmt[len] = prune_syntax_tree (stmt[i])))
+            continue;
+          if (is_endless (stmt[len++]))
+            break;
+        }
+      if (i + 1 < node->len)
+        logger(DEBUG, "Removed %u unreachable statements", node->len - i - 1);
+      node->len = len;
+
+      /// Empty code block, or block of a single statement
+      if (len == 0)
+        return 0;
+      if (len == 1)
+        return stmt[0];
+
+      return tree;
+    }
+
+  /// Only if and while statements hold blocks below them, expressions and
+  /// other statements are left as they are
+  const node_s *cond = &ast.nodes[node->left];
+  unsigned int branch = 0;
+  switch (node->node_type)
+    {
+    case nd_If:
+      /// Prune both branches, kept in the right child if node
+      branch = node->right;
+      ast.nodes[branch].left = prune_syntax_tree (ast.nodes[branch].left);
+      ast.nodes[branch].right = prune_syntax_tree (ast.nodes[branch].right);
+
+      /// A constant condition always takes the same branch
+      if (cond->node_type == nd_Integer)
+        {
+          logger(DEBUG, "Removed %s branch of if (%d)",
+                 cond->int_val ? "else" : "then", cond->int_val);
+          return cond->int_val ? ast.nodes[branch].left
+                               : ast.nodes[branch].right;
+        }
+      return tree;
+
+    case nd_While:
+      /// A constant false condition never runs the loop
+      if (cond->node_type == nd_Integer && cond->int_val == 0)
+        {
+          logger(DEBUG, "Removed while (0)");
+          return 0;
+        }
+      node->right = prune_syntax_tree (node->right);
+      return tree;
+
+    default:
+      return tree;
+    }
+}
+
+/**
+ * @brief           Print abstract syntax tree to destination file
+ *
+ * @param[in]       syntax_tree       Abstract syntax tree
+ * @param[in,out]   dest_fp           Destination file pointer
+ *
+ * @return      The error return code of the function.
+ *
+ * @retval          EXIT_SUCCESS    On success
+ * @retval          EXIT_FAILURE    On error
+ * @retval          errno           On system call failure
+ *
+ */
+short
+print_ast (unsigned int syntax_tree, FILE *dest_fp)
+{
+  logger(DEBUG, "=== START ===");
+
+  /// Check if syntax tree is not empty
+  logger(DEBUG, "assert(syntax_tree)");
+  assert(syntax_tree);
+  _PASS;
+
+  /// Print syntax tree in pre-traversal mode to destination file pointer
+  traverse_ast (syntax_tree, dest_fp);
+
+  logger(DEBUG, "=== END ===");
+  return (EXIT_SUCCESS);
+}
+
+/**
+ * @brief           Traverse abstract syntax tree pre-order
+ *
+ * @details         Mermaid node ids are the node indices in ast.nodes.
+ *
+ * @param[in]    root       Abstract syntax tree node to print
+ * @param[in]    report_fp  Destination report file pointer
+ */
+void
+traversePreOrder_graph (unsigned int root, FILE *report_fp)
+{
+  ast_walk_s walk = { 0 };
+  unsigned int index = 0;
+
+  for (ast_walk_start (&walk, root); (index = ast_walk_next (&walk));)
+    {
+      const node_s *node = &ast.nodes[index];
+
+      /// If node is string, print its interned value
+      if (node->node_type == nd_String)
+        fprintf (report_fp, "%u[\"'%s'\"]:::%s\n", index,
+                 get_interned_str (node->str_id),
+                 node_name[node->node_type]);
+
+      /// If node is identifier, print name
+      else if (node->node_type == nd_Ident)
+        fprintf (report_fp, "%u[%s]:::%s\n", index,
+                 get_interned_str (node->str_id),
+                 node_name[node->node_type]);
+
+      /// ... if node is integer, print the int_val
+      else if (node->node_type == nd_Integer)
+        fprintf (report_fp, "%u[%d]:::%s\n", index, node->int_val,
+                 node_name[node->node_type]);
+
+      /// ... else, print node type name
+      else
+        fprintf (report_fp, "%u[%s]:::%s\n", index,
+                 node_name[node->node_type], node_name[node->node_type]);
+
+      /// Connect block to its statements
+      if (node->node_type == nd_Sequence)
+        {
+          unsigned int i = 0;
+          for (i = 0; i < node->len; i++)
+            fprintf (report_fp, "%u --> %u\n", index,
+                     ast.list[node->first + i]);
+          continue;
+        }
+
+      /// If node has left/right child nodes, create connection to them
+      if (node->left)
+        fprintf (report_fp, "%u --> %u\n", index, node->left);
+
+      if (node->right)
+        fprintf (report_fp, "%u --> %u\n", index, node->right);
+    }
+
+  ast_walk_end (&walk);
+}
+
+/**
+ * @brief           Print abstract syntax tree tree to HTML report file
+ *
+ * @param[in]       syntax_tree       Abstract syntax tree
+ * @param[in,out]   report_fp         Report file pointer
+ *
+ * @return      The error return code of the function.
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    On error
+ * @retval      errno           On system call failure
+ *
+ */
+short
+print_ast_html (unsigned int syntax_tree, FILE *report_fp)
+{
+  logger(DEBUG, "=== START ===");
+
+  /// Check if syntax tree is not empty
+  logger(DEBUG, "assert(syntax_tree)");
+  assert(syntax_tree);
+  _PASS;
+
+  /// Write mermaid graph header
+  fprintf(report_fp, "<div class='mermaid'>\ngraph TD;\n");
+
+  /// Open res/mermaid.styles in read-only mode
+  char *mermaid_fn = "res/mermaid.styles";
+  sprintf (perror_msg, "css_fp = fopen ('%s', 'r')", mermaid_fn);
+  logger (DEBUG, perror_msg);
+
+  errno = EXIT_SUCCESS;
+  FILE *mermaid_fp = fopen (mermaid_fn, "r");
+  if (errno == EXIT_SUCCESS)
+    _PASS;
+  else
+    {
+      perror (perror_msg);
+      _FAIL;
+      exit (opal_exit(errno));
+    }
+
+  /// Copy CSS to HTML report
+  logger (DEBUG, "Copying Mermaid styles to HTML report");
+  char ch = 0;
+  while ((ch = fgetc (mermaid_fp)) != EOF)
+    fputc (ch, report_fp);
+  _DONE;
+  fprintf(report_fp, "\n");
+
+  /// Close res/styles.css file
+  sprintf (perror_msg, "fclose(mermaid_fp)");
+  logger (DEBUG, perror_msg);
+  if (fclose (mermaid_fp) == EXIT_SUCCESS)
+    _PASS;
+  else
+    {
+      perror (perror_msg);
+      _FAIL;
+      exit (opal_exit (errno));
+    }
+
+  /// Print abstract syntax tree to report
+  traversePreOrder_graph (syntax_tree, report_fp);
+
+  /// Write mermaid graph footer
+  fprintf(report_fp, "</div>\n"
+          "<script src='https://cdn.jsdelivr.net/npm/mermaid/dist/mermaid.min.js'></script>\n"
+          "<script>mermaid.initialize({startOnLoad:true, flowchart: {curve:'cardinal', useMaxWidth:false, }, });</script>\n");
+
+  sprintf (perror_msg, "fflush(graph_fp)");
+  logger (DEBUG, perror_msg);
+
+  errno = EXIT_SUCCESS;
+  fflush (report_fp);
+  if (errno == EXIT_SUCCESS)
+    _PASS;
+  else
+    {
+      perror(perror_msg);
+      _FAIL;
+      return (errno);
+    }
+
+  logger(DEBUG, "=== END ===");
+  return (EXIT_SUCCESS);
+}
+
+/**
+ * @brief           Print constants folded by optimize_syntax_tree() to HTML
+ *                  report file
+ *
+ * @param[in,out]   report_fp         Report file pointer
+ *
+ * @return      The error return code of the function.
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      errno           On system call failure
+ *
+ */
+short
+print_folds_html (FILE *report_fp)
+{
+  logger(DEBUG, "=== START ===");
+
+  /// Assert destination file pointer is not NULL
+  logger(DEBUG, "assert(report_fp)");
+  assert(report_fp);
+  _PASS;
+
+  fprintf (report_fp, "<h3>Constants folded: %u</h3>\n<hr>\n",
+           ast.folds_len);
+  if (ast.folds_len)
+    {
+      fprintf (report_fp,
+               "<div class='scroll'><table>\n" "<tr>\n" "<th>Operator</th>\n"
+               "<th>Left</th>\n" "<th>Right</th>\n" "<th>Value</th>\n"
+               "</tr>");
+
+      unsigned int index = 0;
+      for (index = 0; index < ast.folds_len; index++)
+        {
+          const fold_s *fold = &ast.folds[index];
+          fprintf (report_fp, "<tr>");
+          fprintf (report_fp, "<td>%s</td>\n" "<td>%d</td>\n",
+                   node_name[fold->op], fold->left);
+          if (fold->op == nd_Negate || fold->op == nd_Not)
+            fprintf (report_fp, "<td></td>\n");
+          else
+            fprintf (report_fp, "<td>%d</td>\n", fold->right);
+          fprintf (report_fp, "<td>%d</td>\n", fold->result);
+          fprintf (report_fp, "</tr>\n");
+        }
+
+      fprintf (report_fp, "</table></div>\n");
+    }
+
+  /// Flush contents of report to disk
+  sprintf (perror_msg, "fflush(report_fp)");
+  logger(DEBUG, perror_msg);
+  if (fflush (report_fp) == EXIT_SUCCESS)
+    _PASS;
+  else
+    {
+      _FAIL;
+      perror (perror_msg);
+      return (errno);
+    }
+
+  logger(DEBUG, "=== END ===");
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief       Free memory allocated for syntax tree
+ *
+ * @details     All nodes, including those dropped by optimize_syntax_tree(),
+ * live in the ast.nodes array and are released together.
+ *
+ * @return      NULL
+ *
+ */
+void
+free_syntax_tree (void)
+{
+  logger(DEBUG, "Free syntax tree nodes");
+  free (ast.nodes);
+  free (ast.list);
+  free (ast.open);
+  free (ast.expr);
+  free (ast.folds);
+  memset (&ast, 0, sizeof(ast));
+}
+
+/**
+ * @brief                   Traverses the syntax tree while printing the contents to dest_fp.
+ *
+ * @param[in]   root        The syntax tree node to start at
+ * @param[in]   dest_fp     The file to which the node's content will be printed
+ *
+ * @return                  NULL
+ */
+void
+traverse_ast(unsigned int root, FILE *dest_fp)
+{
+    ast_walk_s walk = { 0 };
+    unsigned int index = 0;
+
+    for (ast_walk_start (&walk, root); (index = ast_walk_next (&walk));)
+      {
+        const node_s *node = &ast.nodes[index];
+
+        /// If node is identifier or string, print its interned value
+        if (node->node_type == nd_Ident || node->node_type == nd_String)
+            fprintf (dest_fp, "%s\n", get_interned_str (node->str_id));
+
+        /// ... if node is integer, print the int_val
+        else if (node->node_type == nd_Integer)
+            fprintf (dest_fp, "%d\n", node->int_val);
+
+        /// ... else, print node type name
+        else
+            fprintf (dest_fp, "%s\n", node_name[node->node_type]);
+      }
+
+    ast_walk_end (&walk);
+}
+
+/*
+ * ==================================
+ * START GENIE FUNCTION DEFINITIONS
+ * ==================================
+ */
+
+/**
+ * @brief Append ASM code to array
+ * @param code      ASM code
+ * @param intval    Integer value
+ * @param label     String value
+ */
+void
+add_asm_code (asm_code_e code, int intval, const char *label)
+{
+  /// Create struct with given intval and code
+  asm_cmd_e asm_cmd = { 0 };
+  asm_cmd.intval = intval;
+  asm_cmd.cmd = code;
+
+  /// Intern the asm_code label if there is one
+  if (label)
+    asm_cmd.label = intern_str (label, strlen (label));
+
+  logger(DEBUG, "Added command - cmd: %s, label: %s", asm_cmds[asm_cmd.cmd],
+         label ? label : "NULL");
+
+  /// Double the list if full
+  if (asm_cmd_list_len == asm_cmd_list_cap)
+    {
+      unsigned int cap = asm_cmd_list_cap ? asm_cmd_list_cap * 2 : 1024;
+      asm_cmd_e *list = realloc (asm_cmd_list, cap * sizeof(asm_cmd_e));
+      if (!list)
+        {
+          perror ("realloc (asm_cmd_list)");
+          exit (opal_exit (errno));
+        }
+      asm_cmd_list = list;
+      asm_cmd_list_cap = cap;
+    }
+
+  /// Adds the asm_cmd
+  asm_cmd_list[asm_cmd_list_len++] = asm_cmd;
+}
+
+/**
+ * @brief Check whether assembly command jumps to its label
+ * @param code      ASM code
+ *
+ * @return      TRUE for jumps, else FALSE
+ */
+short
+is_jump (asm_code_e code)
+{
+  return code == asm_Jmp || code == asm_Jz || code == asm_Jnz
+      || (code >= asm_Jeq && code <= asm_Jgeq);
+}
+
+/**
+ * @brief Push code generation task
+ *
+ * @details     Tasks run last pushed first, see run_asm_tasks().
+ *
+ * @param       type    Task type
+ * @param       node    Syntax tree node of the task, 0 for task_Add
+ * @param       cmd     Command of task_Add and task_Var
+ * @param       value   Integer value of task_Add, truth of task_Jump
+ * @param       label   Label of task_Add and task_Jump, or NULL
+ *
+ * @return      NULL
+ */
+void
+push_asm_task (asm_task_e type, unsigned int node, asm_code_e cmd, int value,
+               const char *label)
+{
+  asm_task_s task = { 0 };
+  task.type = type;
+  task.node = node;
+  task.cmd = cmd;
+  task.value = value;
+
+  /// Labels are interned now, the buffers holding them do not outlive us
+  if (label)
+    task.label = intern_str (label, strlen (label));
+
+  /// Double the stack if full
+  if (asm_tasks_len == asm_tasks_cap)
+    {
+      unsigned int cap = asm_tasks_cap ? asm_tasks_cap * 2 : 256;
+      asm_task_s *tasks = realloc (asm_tasks, cap * sizeof(asm_task_s));
+      if (!tasks)
+        {
+          perror ("realloc (asm_tasks)");
+          exit (opal_exit (errno));
+        }
+      asm_tasks = tasks;
+      asm_tasks_cap = cap;
+    }
+
+  asm_tasks[asm_tasks_len++] = task;
+}
+
+/**
+ * @brief Run code generation tasks above base of the task stack
+ *
+ * @details     A task expanding a node pushes the steps of that node in the
+ * order they run, which are then reversed so the first step is on top. The
+ * steps run in the order the calls of a recursive generator would, so
+ * labels and variable slots are numbered the same, while the depth of the
+ * syntax tree only grows the task stack.
+ *
+ * @param       base    Stack length to run down to
+ *
+ * @return      NULL
+ */
+void
+run_asm_tasks (unsigned int base)
+{
+  asm_task_s task = { 0 };
+  unsigned int top = 0;
+  unsigned int i = 0;
+  const char *label = NULL;
+
+  while (asm_tasks_len > base)
+    {
+      task = asm_tasks[--asm_tasks_len];
+      top = asm_tasks_len;
+      label = task.label ? get_interned_str (task.label) : NULL;
+
+      switch (task.type)
+        {
+        case task_Code:
+          expand_asm_code (task.node);
+          break;
+        case task_Jump:
+          expand_asm_jump (task.node, task.value, label);
+          break;
+        case task_Var:
+          add_asm_code (task.cmd, add_var (ast.nodes[task.node].str_id),
+                        label);
+          break;
+        default:
+          add_asm_code (task.cmd, task.value, label);
+        }
+
+      /// Put the first step pushed on top
+      for (i = 0; i < (asm_tasks_len - top) / 2; i++)
+        {
+          task = asm_tasks[top + i];
+          asm_tasks[top + i] = asm_tasks[asm_tasks_len - 1 - i];
+          asm_tasks[asm_tasks_len - 1 - i] = task;
+        }
+    }
+}
+
+/**
+ * @brief Generate assembly command list from given abstract syntax tree
+ * @param       tree  Abstract syntax tree node index
+ *
+ * @return      NULL
+ */
+void
+gen_asm_code (unsigned int tree)
+{
+  unsigned int base = asm_tasks_len;
+
+  push_asm_task (task_Code, tree, asm_NOP, 0, NULL);
+  run_asm_tasks (base);
+}
+
+/**
+ * @brief Push the steps generating the code of a syntax tree node
+ *
+ * @details     Labels are numbered when the node is expanded, after the
+ * code before it has been generated.
+ *
+ * @param       tree  Abstract syntax tree node index
+ *
+ * @return      NULL
+ */
+void
+expand_asm_code (unsigned int tree)
+{
+  int location_offset = 0;
+  unsigned int i = 0;
+  const node_s *branch = NULL;
+  char start_label[64] = { 0 };
+  char else_label[64] = { 0 };
+  char end_label[64] = { 0 };
+
+  if (!tree)
+    return;
+
+  const node_s *node = &ast.nodes[tree];
+
+  switch (node->node_type)
+    {
+    case nd_Sequence:
+      for (i = 0; i < node->len; i++)
+        push_asm_task (task_Code, ast.list[node->first + i], asm_NOP, 0, NULL);
+      break;
+    case nd_While:
+      sprintf (start_label, "_while_loop_%d", asm_cmd_list_len);
+      sprintf (end_label, "_while_end_%d", asm_cmd_list_len);
+
+      /// A constant true condition loops forever without a check
+      if (ast.nodes[node->left].node_type == nd_Integer
+          && ast.nodes[node->left].int_val != 0)
+        {
+          add_asm_code (asm_Label, 0, start_label);   // while block start
+          push_asm_task (task_Code, node->right, asm_NOP, 0, NULL); // body
+          push_asm_task (task_Add, 0, asm_Jmp, 0, start_label); // loop back
+          break;
+        }
+
+      add_asm_code (asm_Label, 0, start_label);     // while block start
+      push_asm_task (task_Jump, node->left, asm_NOP, FALSE, end_label);
+      push_asm_task (task_Code, node->right, asm_NOP, 0, NULL); // body
+      push_asm_task (task_Add, 0, asm_Jmp, 0, start_label);   // loop back
+      push_asm_task (task_Add, 0, asm_Label, 0, end_label);   // block end
+
+      break;
+    case nd_If:
+      sprintf (start_label, "_if_%d", asm_cmd_list_len);
+      sprintf (else_label, "_else_%d", asm_cmd_list_len);
+      sprintf (end_label, "_fi_%d", asm_cmd_list_len);
+
+      branch = &ast.nodes[node->right];
+
+      add_asm_code (asm_Label, 0, start_label);    // start if
+      push_asm_task (task_Jump, node->left, asm_NOP, FALSE, else_label);
+      push_asm_task (task_Code, branch->left, asm_NOP, 0, NULL); // true ..
+      push_asm_task (task_Add, 0, asm_Jmp, 0, end_label);     // .. and exit
+      push_asm_task (task_Add, 0, asm_Label, 0, else_label);  // start else
+      push_asm_task (task_Code, branch->right, asm_NOP, 0, NULL);
+      push_asm_task (task_Add, 0, asm_Label, 0, end_label);   // if/else end
+
+      break;
+    case nd_Add:
+    case nd_Sub:
+    case nd_Mul:
+    case nd_Div:
+    case nd_Mod:
+    case nd_Eq:
+    case nd_Neq:
+    case nd_Lss:
+    case nd_Gtr:
+    case nd_Leq:
+    case nd_Geq:
+      push_asm_task (task_Code, node->left, asm_NOP, 0, NULL);
+      push_asm_task (task_Code, node->right, asm_NOP, 0, NULL);
+      push_asm_task (task_Add, 0, node->node_type, 0, NULL);
+      break;
+    case nd_And:
+    case nd_Or:
+      /// Jump over the right operand once the left one decides the value
+      sprintf (else_label, "_false_%u", tree);
+      sprintf (end_label, "_bool_%u", tree);
+
+      push_asm_task (task_Jump, tree, asm_NOP, FALSE, else_label);
+      push_asm_task (task_Add, 0, asm_Push, 1, NULL);     // true, isTrue ..
+      push_asm_task (task_Add, 0, asm_Jmp, 0, end_label); // .. and exit
+      push_asm_task (task_Add, 0, asm_Label, 0, else_label);
+      push_asm_task (task_Add, 0, asm_Push, 0, NULL);
+      push_asm_task (task_Add, 0, asm_Label, 0, end_label);
+      break;
+    case nd_Negate:
+    case nd_Not:
+      push_asm_task (task_Code, node->left, asm_NOP, 0, NULL);
+      push_asm_task (task_Add, 0, node->node_type, 0, NULL);
+      break;
+    case nd_Ident:
+      location_offset = add_var(node->str_id);
+      add_asm_code(asm_Fetch, location_offset, NULL);
+      break;
+    case nd_Integer:
+      add_asm_code(asm_Push, node->int_val, NULL);
+      break;
+    case nd_String:
+      location_offset = add_str(node->str_id);
+      add_asm_code(asm_Push, location_offset, NULL);
+      break;
+    case nd_Assign:
+      /// The slot is added after the variables read by the expression
+      push_asm_task (task_Code, node->right, asm_NOP, 0, NULL);
+      push_asm_task (task_Var, node->left, asm_Store, 0, NULL);
+      break;
+    case nd_Input:
+      push_asm_task (task_Code, node->left, asm_NOP, 0, NULL);
+      push_asm_task (task_Add, 0, asm_Input, 0, NULL);
+      break;
+    case nd_Prti:
+      push_asm_task (task_Code, node->left, asm_NOP, 0, NULL);
+      push_asm_task (task_Add, 0, asm_Prti, 0, NULL);
+      break;
+    case nd_Prts:
+      push_asm_task (task_Code, node->left, asm_NOP, 0, NULL);
+      push_asm_task (task_Add, 0, asm_Prts, 0, NULL);
+      break;
+    default:
+      fprintf(stderr, "Unexpected operator: %s\n", node_name[node->node_type]);
+      exit (opal_exit (EXIT_FAILURE));
+    }
+
+  return;
+}
+
+/**
+ * @brief Push the steps of a jump to label taken when condition has the
+ * given truth
+ *
+ * @details     The operands of && and || are evaluated left to right and
+ * the right one is skipped when the left one decides the result. ! flips
+ * the jump, comparisons jump with a fused compare and jump instruction
+ * without pushing isTrue or isFalse. Other conditions are evaluated on the
+ * stack and tested with O_JZ or O_JNZ.
+ *
+ * @param       cond        Condition node index
+ * @param       jump_if     TRUE to jump if condition holds, FALSE if not
+ * @param       label       Label to jump to
+ *
+ * @return      NULL
+ */
+void
+expand_asm_jump (unsigned int cond, short jump_if, const char *label)
+{
+  char skip_label[64] = { 0 };
+  const node_s *node = &ast.nodes[cond];
+  ast_node_type_e op = node->node_type;
+
+  switch (node->node_type)
+    {
+    case nd_Eq:
+    case nd_Neq:
+    case nd_Lss:
+    case nd_Gtr:
+    case nd_Leq:
+    case nd_Geq:
+      /// Jump on the inverse comparison if the condition must not hold
+      if (!jump_if)
+        switch (op)
+          {
+          case nd_Eq:
+            op = nd_Neq;
+            break;
+          case nd_Neq:
+            op = nd_Eq;
+            break;
+          case nd_Lss:
+            op = nd_Geq;
+            break;
+          case nd_Gtr:
+            op = nd_Leq;
+            break;
+          case nd_Leq:
+            op = nd_Gtr;
+            break;
+          default:
+            op = nd_Lss;
+            break;
+          }
+
+      push_asm_task (task_Code, node->left, asm_NOP, 0, NULL);
+      push_asm_task (task_Code, node->right, asm_NOP, 0, NULL);
+      push_asm_task (task_Add, 0, asm_Jeq + (op - nd_Eq), 0, label);
+      break;
+    case nd_Not:
+      push_asm_task (task_Jump, node->left, asm_NOP, !jump_if, label);
+      break;
+    case nd_And:
+      if (!jump_if)
+        {
+          push_asm_task (task_Jump, node->left, asm_NOP, FALSE, label);
+          push_asm_task (task_Jump, node->right, asm_NOP, FALSE, label);
+          break;
+        }
+
+      /// A false left operand falls through, past the jump
+      sprintf (skip_label, "_and_%u", cond);
+      push_asm_task (task_Jump, node->left, asm_NOP, FALSE, skip_label);
+      push_asm_task (task_Jump, node->right, asm_NOP, TRUE, label);
+      push_asm_task (task_Add, 0, asm_Label, 0, skip_label);
+      break;
+    case nd_Or:
+      if (jump_if)
+        {
+          push_asm_task (task_Jump, node->left, asm_NOP, TRUE, label);
+          push_asm_task (task_Jump, node->right, asm_NOP, TRUE, label);
+          break;
+        }
+
+      /// A true left operand falls through, past the jump
+      sprintf (skip_label, "_or_%u", cond);
+      push_asm_task (task_Jump, node->left, asm_NOP, TRUE, skip_label);
+      push_asm_task (task_Jump, node->right, asm_NOP, FALSE, label);
+      push_asm_task (task_Add, 0, asm_Label, 0, skip_label);
+      break;
+    default:
+      push_asm_task (task_Code, cond, asm_NOP, 0, NULL);
+      push_asm_task (task_Add, 0, jump_if ? asm_Jnz : asm_Jz, 0, label);
+    }
+}
+
+/**
+ * @brief Apply peephole rule to the tail of assembly code list
+ *
+ * @details     Rules only look at commands already in the optimized list.
+ * Labels are the only jump targets, so commands next to each other without
+ * a label between them always run in sequence.
+ *
+ * @param       rule        Rule to apply
+ * @param       cmd         Optimized assembly code list
+ * @param       len         Length of optimized list, updated on rewrite
+ *
+ * @return      TRUE if the rule rewrote the list, else FALSE
+ */
+short
+peephole_rewrite (peephole_rule_e rule, asm_cmd_e cmd[], unsigned int *len)
+{
+  asm_cmd_e *last = *len ? &cmd[*len - 1] : NULL;
+  asm_cmd_e *prev = *len > 1 ? &cmd[*len - 2] : NULL;
+  unsigned int i = 0;
+
+  if (!prev)
+    return FALSE;
+
+  switch (rule)
+    {
+    case peep_StoreFetch:
+      /// Store a copy of the value and leave it on the stack
+      if (prev->cmd != asm_Store || last->cmd != asm_Fetch
+          || prev->intval != last->intval)
+        return FALSE;
+      prev->cmd = asm_StoreKeep;
+      break;
+    case peep_PushNegate:
+      /// -INT_MIN does not fit the 32-bit immediate of PUSH
+      if (prev->cmd != asm_Push || last->cmd != asm_Negate
+          || prev->intval == INT_MIN)
+        return FALSE;
+      prev->intval = -prev->intval;
+      break;
+    case peep_NotNot:
+      if (*len < 3 || cmd[*len - 3].cmd != asm_Not || prev->cmd != asm_Not
+          || last->cmd != asm_Not)
+        return FALSE;
+      *len -= 1;
+      break;
+    case peep_NotJz:
+    case peep_NotJnz:
+      /// Test the operand of O_NOT with the opposite jump
+      if (prev->cmd != asm_Not
+          || last->cmd != (rule == peep_NotJz ? asm_Jz : asm_Jnz))
+        return FALSE;
+      last->cmd = rule == peep_NotJz ? asm_Jnz : asm_Jz;
+      *prev = *last;
+      break;
+    case peep_JmpNext:
+      /// Look for the jump behind the labels at the end of the list
+      if (last->cmd != asm_Label)
+        return FALSE;
+      for (i = *len - 1; i > 0 && cmd[i - 1].cmd == asm_Label; i--)
+        ;
+      if (i == 0 || cmd[i - 1].cmd != asm_Jmp
+          || cmd[i - 1].label != last->label)
+        return FALSE;
+      label_refs[last->label]--;
+      memmove (&cmd[i - 1], &cmd[i], (*len - i) * sizeof(asm_cmd_e));
+      *len -= 1;
+      return TRUE;
+    case peep_DeadLabel:
+      if (last->cmd != asm_Label || label_refs[last->label])
+        return FALSE;
+      *len -= 1;
+      return TRUE;
+    }
+
+  /// Rewrites other than label removal merge the last two commands
+  *len -= 1;
+  return TRUE;
+}
+
+/**
+ * @brief Rewrite redundant patterns in assembly code list
+ *
+ * @details     Commands are moved one at a time to the optimized list, which
+ * is kept in place at the start of asm_cmd_list. After each move the rules
+ * of peephole_rules[] are tried on the end of the optimized list until none
+ * of them matches, so the result of one rewrite is matched again.
+ *
+ * @return      NULL
+ */
+void
+optimize_asm_code (void)
+{
+  unsigned int rule_count = sizeof(peephole_rules) / sizeof(peephole_rules[0]);
+  unsigned int i = 0, len = 0, rule = 0;
+
+  /// Count the jumps to every label
+  grow_slot_map (&label_refs, &label_refs_len);
+  for (i = 0; i < asm_cmd_list_len; i++)
+    if (is_jump (asm_cmd_list[i].cmd))
+      label_refs[asm_cmd_list[i].label]++;
+
+  for (i = 0; i < asm_cmd_list_len; i++)
+    {
+      asm_cmd_list[len++] = asm_cmd_list[i];
+
+      for (rule = 0; rule < rule_count;)
+        if (peephole_rewrite (peephole_rules[rule].rule, asm_cmd_list, &len))
+          {
+            peephole_rules[rule].hits++;
+            rule = 0;
+          }
+        else
+          rule++;
+    }
+
+  logger(DEBUG, "Peephole optimizer removed %u of %u commands",
+         asm_cmd_list_len - len, asm_cmd_list_len);
+  asm_cmd_list_len = len;
+}
+
+/**
+ * @brief           Print peephole rule hit counts to HTML report file
+ *
+ * @param[in,out]   report_fp         Report file pointer
+ *
+ * @return      The error return code of the function.
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      errno           On system call failure
+ *
+ */
+short
+print_peephole_html (FILE *report_fp)
+{
+  logger(DEBUG, "=== START ===");
+
+  /// Assert destination file pointer is not NULL
+  logger(DEBUG, "assert(report_fp)");
+  assert(report_fp);
+  _PASS;
+
+  fprintf (report_fp, "<h3>Peephole optimizations</h3>\n<hr>\n"
+           "<div class='scroll'><table>\n" "<tr>\n" "<th>Pattern</th>\n"
+           "<th>Rewrite</th>\n" "<th>Hits</th>\n" "</tr>");
+
+  unsigned int index = 0;
+  for (index = 0;
+      index < sizeof(peephole_rules) / sizeof(peephole_rules[0]); index++)
+    fprintf (report_fp, "<tr>\n<td>%s</td>\n<td>%s</td>\n<td>%u</td>\n"
+             "</tr>\n", peephole_rules[index].pattern,
+             peephole_rules[index].rewrite, peephole_rules[index].hits);
+
+  fprintf (report_fp, "</table></div>\n");
+
+  /// Flush contents of report to disk
+  sprintf (perror_msg, "fflush(report_fp)");
+  logger(DEBUG, perror_msg);
+  if (fflush (report_fp) == EXIT_SUCCESS)
+    _PASS;
+  else
+    {
+      _FAIL;
+      perror (perror_msg);
+      return (errno);
+    }
+
+  logger(DEBUG, "=== END ===");
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief       Choose variables kept in registers and print their
+ *              initialization
+ *
+ * @details     Every _FETCH_ and _STORE_ of a variable adds to its weight,
+ * eight times as much for each loop around it. Loops are found as the
+ * ranges between a label and a later jump back to it. With --pin-vars the
+ * PIN_REG_COUNT heaviest variables are kept in the pin_names registers for
+ * the whole program instead of in 'data'.
+ *
+ * @param[in]   dest_fp     Destination file pointer, NULL to only choose
+ *
+ * @return      None
+ */
+void
+pin_hot_vars (FILE *dest_fp)
+{
+  unsigned int i = 0, j = 0, best = 0;
+  int depth = 0;
+
+  var_pin = arena_alloc (&asm_arena, (vars_len + 1) * sizeof(int));
+  for (i = 0; i < vars_len; i++)
+    var_pin[i] = -1;
+  if (!pin_vars)
+    return;
+
+  /// Find the labels, then count loops around every command
+  unsigned int *label_at = NULL, label_at_len = 0;
+  grow_slot_map (&label_at, &label_at_len);
+  for (i = 0; i < asm_cmd_list_len; i++)
+    if (asm_cmd_list[i].cmd == asm_Label)
+      label_at[asm_cmd_list[i].label] = i + 1;
+
+  int *loops = arena_alloc (&asm_arena, (asm_cmd_list_len + 1) * sizeof(int));
+  for (i = 0; i < asm_cmd_list_len; i++)
+    if (is_jump (asm_cmd_list[i].cmd)
+        && label_at[asm_cmd_list[i].label] - 1 < i)
+      {
+        loops[label_at[asm_cmd_list[i].label] - 1]++;
+        loops[i + 1]--;
+      }
+
+  uint64_t *weight = arena_alloc (&asm_arena, vars_len * sizeof(uint64_t));
+  for (i = 0; i < asm_cmd_list_len; i++)
+    {
+      depth += loops[i];
+      if (asm_cmd_list[i].cmd == asm_Fetch || asm_cmd_list[i].cmd == asm_Store
+          || asm_cmd_list[i].cmd == asm_StoreKeep)
+        weight[asm_cmd_list[i].intval] += (uint64_t) 1 << 3 * (depth < 16
+            ? depth : 16);
+    }
+
+  /// Pin the heaviest variables, zeroed as 'data' is
+  for (j = 0; j < PIN_REG_COUNT; j++)
+    {
+      for (best = 0, i = 1; i < vars_len; i++)
+        if (weight[i] > weight[best])
+          best = i;
+      if (!vars_len || !weight[best])
+        break;
+
+      var_pin[best] = j;
+      weight[best] = 0;
+      logger(DEBUG, "Pinned variable '%s' to %s", get_interned_str (vars[best]),
+             pin_names[j]);
+      if (dest_fp)
+        fprintf (dest_fp, "  XOR  %s, %s\n", pin_names[j], pin_names[j]);
+    }
+}
+
+/**
+ * @brief       Format variable as instruction operand
+ *
+ * @param[out]  buf         Buffer of at least 32 characters
+ * @param[in]   index       Data index of the variable
+ *
+ * @return      buf
+ */
+const char*
+format_var (char *buf, int index)
+{
+  if (var_pin[index] >= 0)
+    strcpy (buf, pin_names[var_pin[index]]);
+  else
+    sprintf (buf, "QWORD [data+8*%d]", index);
+
+  return buf;
+}
+
+/**
+ * @brief       Get cache slot of operand stack position
+ *
+ * @param[in]   pos         Operand stack position, may be below the last label
+ *
+ * @return      Index into reg_cache.entry and reg_names
+ */
+int
+reg_slot (int pos)
+{
+  return ((pos % REG_CACHE_SIZE) + REG_CACHE_SIZE) % REG_CACHE_SIZE;
+}
+
+/**
+ * @brief       Get register of operand stack position
+ *
+ * @param[in]   pos         Operand stack position
+ *
+ * @return      Register name
+ */
+const char*
+reg_name (int pos)
+{
+  return reg_names[reg_slot (pos)];
+}
+
+/**
+ * @brief       Format operand stack entry as instruction operand
+ *
+ * @param[out]  buf         Buffer of at least 32 characters
+ * @param[in]   opnd        Operand stack entry
+ * @param[in]   pos         Operand stack position of entry
+ *
+ * @return      buf
+ */
+const char*
+format_opnd (char *buf, const opnd_s *opnd, int pos)
+{
+  switch (opnd->kind)
+    {
+    case opnd_Reg:
+      strcpy (buf, reg_name (pos));
+      break;
+    case opnd_Imm:
+      sprintf (buf, "%d", opnd->val);
+      break;
+    case opnd_Mem:
+      format_var (buf, opnd->val);
+      break;
+    }
+
+  return buf;
+}
+
+/**
+ * @brief       Spill bottom cached operand stack entry to the hardware stack
+ *
+ * @param[in]   dest_fp     Destination file pointer
+ *
+ * @return      None
+ */
+void
+reg_spill (FILE *dest_fp)
+{
+  char buf[32] = { 0 };
+  int pos = reg_cache.depth - reg_cache.cached;
+
+  fprintf (dest_fp, "  PUSH %s\n",
+           format_opnd (buf, &reg_cache.entry[reg_slot (pos)], pos));
+  reg_cache.cached--;
+}
+
+/**
+ * @brief       Spill all cached operand stack entries to the hardware stack,
+ *              as the stack macros and other paths to a label expect them
+ *
+ * @param[in]   dest_fp     Destination file pointer
+ *
+ * @return      None
+ */
+void
+reg_flush (FILE *dest_fp)
+{
+  while (reg_cache.cached)
+    reg_spill (dest_fp);
+}
+
+/**
+ * @brief       Push entry on operand stack, spilling the bottom cached entry
+ *              if all registers are in use
+ *
+ * @param[in]   dest_fp     Destination file pointer
+ * @param[in]   kind        Kind of entry
+ * @param[in]   val         Constant or data index of the entry
+ *
+ * @return      None
+ */
+void
+reg_push (FILE *dest_fp, opnd_kind_e kind, int val)
+{
+  if (reg_cache.cached == REG_CACHE_SIZE)
+    reg_spill (dest_fp);
+
+  opnd_s *opnd = &reg_cache.entry[reg_slot (reg_cache.depth)];
+  opnd->kind = kind;
+  opnd->val = val;
+  reg_cache.depth++;
+  reg_cache.cached++;
+}
+
+/**
+ * @brief       Pop entry from operand stack, from the hardware stack into the
+ *              register of its position if it is not cached
+ *
+ * @param[in]   dest_fp     Destination file pointer
+ *
+ * @return      Entry popped, its position is reg_cache.depth
+ */
+opnd_s
+reg_pop (FILE *dest_fp)
+{
+  opnd_s opnd = { opnd_Reg, 0 };
+
+  reg_cache.depth--;
+  if (reg_cache.cached)
+    {
+      reg_cache.cached--;
+      return reg_cache.entry[reg_slot (reg_cache.depth)];
+    }
+
+  fprintf (dest_fp, "  POP  %s\n", reg_name (reg_cache.depth));
+  return opnd;
+}
+
+/**
+ * @brief       Load operand stack entry into the register of its position
+ *
+ * @param[in]   dest_fp     Destination file pointer
+ * @param[in,out] opnd      Operand stack entry
+ * @param[in]   pos         Operand stack position of entry
+ *
+ * @return      Register name
+ */
+const char*
+reg_load (FILE *dest_fp, opnd_s *opnd, int pos)
+{
+  char buf[32] = { 0 };
+
+  if (opnd->kind != opnd_Reg)
+    {
+      fprintf (dest_fp, "  MOV  %s, %s\n", reg_name (pos),
+               format_opnd (buf, opnd, pos));
+      opnd->kind = opnd_Reg;
+    }
+
+  return reg_name (pos);
+}
+
+/**
+ * @brief       Load cached entries of a variable before it is stored to
+ *
+ * @param[in]   dest_fp     Destination file pointer
+ * @param[in]   index       Data index of the variable
+ *
+ * @return      None
+ */
+void
+reg_reload_var (FILE *dest_fp, int index)
+{
+  int pos = 0;
+
+  for (pos = reg_cache.depth - reg_cache.cached; pos < reg_cache.depth; pos++)
+    {
+      opnd_s *opnd = &reg_cache.entry[reg_slot (pos)];
+      if (opnd->kind == opnd_Mem && opnd->val == index)
+        reg_load (dest_fp, opnd, pos);
+    }
+}
+
+/**
+ * @brief       Print assembly code list as register code
+ *
+ * @details     The operand stack is tracked at compile time. Its top
+ * REG_CACHE_SIZE entries live in registers, by stack position, and constants
+ * and variables are only loaded when an instruction needs them in a
+ * register. Entries are spilled to the hardware stack when the registers run
+ * out, and all of them before labels, jumps and the print and input macros,
+ * so every path reaches a label with the operand stack on the hardware stack.
+ *
+ * @param[in]   dest_fp     Destination file pointer
+ *
+ * @return      None
+ */
+void
+print_reg_code (FILE *dest_fp)
+{
+  /// Condition codes of asm_Eq .. asm_Geq and asm_Jeq .. asm_Jgeq
+  const char *cc[] = { "E", "NE", "L", "G", "LE", "GE" };
+  char buf[32] = { 0 }, a_buf[32] = { 0 };
+  unsigned int i = 0;
+  int pos = 0;
+  const char *reg = NULL;
+  opnd_s a = { 0 }, b = { 0 };
+
+  memset (&reg_cache, 0, sizeof(reg_cache));
+
+  for (i = 0; i < asm_cmd_list_len; i++)
+    {
+      const asm_cmd_e *cmd = &asm_cmd_list[i];
+
+      switch (cmd->cmd)
+        {
+        case asm_Push:
+          reg_push (dest_fp, opnd_Imm, cmd->intval);
+          break;
+        case asm_Fetch:
+          reg_push (dest_fp, opnd_Mem, cmd->intval);
+          break;
+        case asm_Store:
+        case asm_StoreKeep:
+          /// Cached copies of the variable keep its old value
+          b = reg_pop (dest_fp);
+          pos = reg_cache.depth;
+          reg_reload_var (dest_fp, cmd->intval);
+          if (b.kind != opnd_Mem || b.val != cmd->intval)
+            {
+              if (b.kind == opnd_Mem && var_pin[b.val] < 0
+                  && var_pin[cmd->intval] < 0)
+                reg_load (dest_fp, &b, pos);
+              fprintf (dest_fp, "  MOV  %s, %s\n",
+                       format_var (a_buf, cmd->intval),
+                       format_opnd (buf, &b, pos));
+            }
+          if (cmd->cmd == asm_StoreKeep)
+            reg_push (dest_fp, b.kind, b.val);
+          break;
+        case asm_Add:
+        case asm_Sub:
+        case asm_Mul:
+        case asm_And:
+        case asm_Or:
+        case asm_Eq:
+        case asm_Neq:
+        case asm_Lss:
+        case asm_Gtr:
+        case asm_Leq:
+        case asm_Geq:
+          b = reg_pop (dest_fp);
+          format_opnd (buf, &b, reg_cache.depth);
+          a = reg_pop (dest_fp);
+          reg = reg_load (dest_fp, &a, reg_cache.depth);
+
+          if (cmd->cmd == asm_Add)
+            fprintf (dest_fp, "  ADD  %s, %s\n", reg, buf);
+          else if (cmd->cmd == asm_Sub)
+            fprintf (dest_fp, "  SUB  %s, %s\n", reg, buf);
+          else if (cmd->cmd == asm_Mul && b.kind == opnd_Imm)
+            fprintf (dest_fp, "  IMUL %s, %s, %s\n", reg, reg, buf);
+          else if (cmd->cmd == asm_Mul)
+            fprintf (dest_fp, "  IMUL %s, %s\n", reg, buf);
+          else if (cmd->cmd == asm_And || cmd->cmd == asm_Or)
+            fprintf (dest_fp, "  %s  %s, %s\n  SETNZ AL\n  MOVZX %s, AL\n",
+                     cmd->cmd == asm_And ? "AND" : "OR ", reg, buf, reg);
+          else
+            fprintf (dest_fp, "  CMP  %s, %s\n  SET%s AL\n  MOVZX %s, AL\n",
+                     reg, buf, cc[cmd->cmd - asm_Eq], reg);
+
+          reg_push (dest_fp, opnd_Reg, 0);
+          break;
+        case asm_Div:
+        case asm_Mod:
+          /// Divide RDX:RAX with RDX cleared, as O_DIV and O_MOD do
+          b = reg_pop (dest_fp);
+          if (b.kind == opnd_Imm)
+            reg_load (dest_fp, &b, reg_cache.depth);
+          format_opnd (buf, &b, reg_cache.depth);
+          a = reg_pop (dest_fp);
+          fprintf (dest_fp, "  MOV  RAX, %s\n",
+                   format_opnd (a_buf, &a, reg_cache.depth));
+          fprintf (dest_fp, "  XOR  EDX, EDX\n  IDIV %s\n  MOV  %s, %s\n", buf,
+                   reg_name (reg_cache.depth),
+                   cmd->cmd == asm_Div ? "RAX" : "RDX");
+          reg_push (dest_fp, opnd_Reg, 0);
+          break;
+        case asm_Negate:
+          a = reg_pop (dest_fp);
+          fprintf (dest_fp, "  NEG  %s\n",
+                   reg_load (dest_fp, &a, reg_cache.depth));
+          reg_push (dest_fp, opnd_Reg, 0);
+          break;
+        case asm_Not:
+          a = reg_pop (dest_fp);
+          reg = reg_load (dest_fp, &a, reg_cache.depth);
+          fprintf (dest_fp, "  TEST %s, %s\n  SETZ AL\n  MOVZX %s, AL\n", reg,
+                   reg, reg);
+          reg_push (dest_fp, opnd_Reg, 0);
+          break;
+        case asm_Jz:
+        case asm_Jnz:
+          a = reg_pop (dest_fp);
+          if (a.kind == opnd_Mem && var_pin[a.val] < 0)
+            fprintf (dest_fp, "  CMP  %s, 0\n",
+                     format_opnd (buf, &a, reg_cache.depth));
+          else if (a.kind == opnd_Mem)
+            fprintf (dest_fp, "  TEST %s, %s\n", pin_names[var_pin[a.val]],
+                     pin_names[var_pin[a.val]]);
+          else
+            {
+              reg = reg_load (dest_fp, &a, reg_cache.depth);
+              fprintf (dest_fp, "  TEST %s, %s\n", reg, reg);
+            }
+
+          /// PUSH and MOV leave the flags alone
+          reg_flush (dest_fp);
+          fprintf (dest_fp, "  %s   %s\n", cmd->cmd == asm_Jz ? "JZ " : "JNZ",
+                   get_interned_str (cmd->label));
+          break;
+        case asm_Jeq:
+        case asm_Jneq:
+        case asm_Jlss:
+        case asm_Jgtr:
+        case asm_Jleq:
+        case asm_Jgeq:
+          b = reg_pop (dest_fp);
+          pos = reg_cache.depth;
+          a = reg_pop (dest_fp);
+          if (a.kind == opnd_Imm
+              || (a.kind == opnd_Mem && var_pin[a.val] < 0
+                  && b.kind == opnd_Mem && var_pin[b.val] < 0))
+            reg_load (dest_fp, &a, reg_cache.depth);
+          fprintf (dest_fp, "  CMP  %s, %s\n",
+                   format_opnd (a_buf, &a, reg_cache.depth),
+                   format_opnd (buf, &b, pos));
+
+          reg_flush (dest_fp);
+          fprintf (dest_fp, "  J%-3s %s\n", cc[cmd->cmd - asm_Jeq],
+                   get_interned_str (cmd->label));
+          break;
+        case asm_Jmp:
+          reg_flush (dest_fp);
+          fprintf (dest_fp, "  JMP  %s\n", get_interned_str (cmd->label));
+          break;
+        case asm_Label:
+          reg_flush (dest_fp);
+          fprintf (dest_fp, "%s:\n", get_interned_str (cmd->label));
+          reg_cache.depth = 0;
+          break;
+        case asm_Prts:
+        case asm_Prti:
+        case asm_Input:
+          /// The macros take their operand from the hardware stack and
+          /// clobber the registers
+          reg_flush (dest_fp);
+          fprintf (dest_fp, "  %s\n", asm_cmds[cmd->cmd]);
+          if (cmd->cmd != asm_Input)
+            reg_cache.depth--;
+          break;
+        case asm_HALT:
+          fprintf (dest_fp, "  %s\n", asm_cmds[cmd->cmd]);
+          break;
+        default:
+          logger(ERROR, "Unknown opcode %d\n", cmd->cmd);
+          exit (opal_exit (EXIT_FAILURE));
+        }
+    }
+}
+
+/**
+ * @brief Print assembly command list
+ *
+ * @param       cmd_list    Assembly command list to print
+ * @param       dest_fp     Destination file pointer
+ *
+ * @return      Function exit code
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    On error
+ */
+short
+print_asm_code(asm_cmd_e cmd_list[], FILE *dest_fp)
+{
+  /*
+   * Traverse and print the assembly code
+   * Steps:
+   * 1. Print macro header
+   * 2. Print user code
+   * 3. Print footer
+   * 4. Create strings and their lengths
+   *    4a. Read each string character and print ASCII value for newline
+   *    4b. NULL terminate string
+   *    4c. Print string length
+   *    4d. Print strings and lengths array
+   * 5. Create variables array
+   */
+
+    /// Open header file in 'r' mode
+    sprintf (perror_msg, "header_fp = fopen('res/header.asm', 'r')");
+    logger(DEBUG, perror_msg);
+    FILE *header_fp = NULL;
+    errno = EXIT_SUCCESS;
+    header_fp = fopen ("res/header.asm", "r");
+    if (errno == EXIT_SUCCESS)
+        _PASS;
+    else
+    {
+        perror (perror_msg);
+        _FAIL;
+        return (errno);
     }
 
 
@@ -2412,219 +4170,1693 @@ print_asm_code(asm_cmd_e cmd_list[], FILE *dest_fp)
   assert(dest_fp);
   _PASS;
 
-  /// Copy contents of header char by char to dest_fp
-  logger(DEBUG, "Copying contents of header.asm in print_asm_code()");
-  char ch = fgetc (header_fp);
-  while (ch != EOF)
-  {
-      fputc (ch, dest_fp);
-      ch = fgetc (header_fp);
-  }
+  /// Copy contents of header char by char to dest_fp
+  logger(DEBUG, "Copying contents of header.asm in print_asm_code()");
+  char ch = fgetc (header_fp);
+  while (ch != EOF)
+  {
+      fputc (ch, dest_fp);
+      ch = fgetc (header_fp);
+  }
+
+  /// Close header file pointer if not NULL
+  sprintf (perror_msg, "fclose(header_fp)");
+  logger(DEBUG, perror_msg);
+  if (header_fp)
+  {
+      if (fclose (header_fp) == EXIT_SUCCESS)
+      {
+          _PASS;
+          header_fp = NULL;
+      }
+      else
+      {
+          perror (perror_msg);
+          _FAIL;
+          return (errno);
+      }
+  }
+
+  /// Print user code
+  int i = 0;
+  char var[32] = { 0 };
+  logger(DEBUG, "Print ASM user code");
+  pin_hot_vars (dest_fp);
+  if (asm_backend == backend_Regs)
+    print_reg_code (dest_fp);
+  for (i = 0; asm_backend == backend_Stack && i < asm_cmd_list_len; i++)
+    {
+      /// Pinned variables are pushed and popped directly
+      if ((asm_cmd_list[i].cmd == asm_Fetch || asm_cmd_list[i].cmd == asm_Store
+          || asm_cmd_list[i].cmd == asm_StoreKeep)
+          && var_pin[asm_cmd_list[i].intval] >= 0)
+        {
+          format_var (var, asm_cmd_list[i].intval);
+          if (asm_cmd_list[i].cmd == asm_Fetch)
+            fprintf (dest_fp, "  PUSH\t%s\n", var);
+          else if (asm_cmd_list[i].cmd == asm_Store)
+            fprintf (dest_fp, "  POP\t%s\n", var);
+          else
+            fprintf (dest_fp, "  MOV\t%s, [RSP]\n", var);
+          continue;
+        }
+
+      switch (asm_cmd_list[i].cmd)
+        {
+        case asm_Fetch:
+        case asm_Store:
+        case asm_StoreKeep:
+        case asm_Push:
+          fprintf (dest_fp, "  %s\t%d\n", asm_cmds[asm_cmd_list[i].cmd],
+                   asm_cmd_list[i].intval);
+          break;
+        case asm_Add:
+        case asm_Sub:
+        case asm_Negate:
+        case asm_Mul:
+        case asm_Div:
+        case asm_Mod:
+        case asm_Eq:
+        case asm_Neq:
+        case asm_Lss:
+        case asm_Gtr:
+        case asm_Leq:
+        case asm_Geq:
+        case asm_And:
+        case asm_Or:
+        case asm_Not:
+        case asm_Prts:
+        case asm_Input:
+        case asm_Prti:
+        case asm_HALT:
+          fprintf (dest_fp, "  %s\n", asm_cmds[asm_cmd_list[i].cmd]);
+          break;
+        case asm_Label:
+          fprintf (dest_fp, "%s:\n",
+                   get_interned_str (asm_cmd_list[i].label));
+          break;
+        case asm_Jz:
+        case asm_Jnz:
+        case asm_Jeq:
+        case asm_Jneq:
+        case asm_Jlss:
+        case asm_Jgtr:
+        case asm_Jleq:
+        case asm_Jgeq:
+        case asm_Jmp:
+          fprintf (dest_fp, "  %s\t\t%s\n", asm_cmds[asm_cmd_list[i].cmd],
+                   get_interned_str (asm_cmd_list[i].label));
+          break;
+        default:
+          logger(ERROR, "Unknown opcode %d\n", asm_cmd_list[i].cmd);
+          exit (opal_exit (EXIT_FAILURE));
+        }
+    }
+  _DONE;
+
+  /// Open footer file in 'r' mode
+  sprintf (perror_msg, "footer_fp = fopen('res/footer.asm', 'r')");
+  logger(DEBUG, perror_msg);
+  FILE *footer_fp = NULL;
+  errno = EXIT_SUCCESS;
+  footer_fp = fopen ("res/footer.asm", "r");
+  if (errno == EXIT_SUCCESS)
+      _PASS;
+  else
+  {
+      perror (perror_msg);
+      _FAIL;
+      return (errno);
+  }
+
+  /// Copy contents of footer char by char to dest_fp
+  logger(DEBUG, "Copying contents of footer.asm in print_asm_code()");
+  ch = fgetc (footer_fp);
+  while (ch != EOF)
+  {
+      fputc (ch, dest_fp);
+      ch = fgetc (footer_fp);
+  }
+
+  /// Close footer file pointer if not NULL
+  sprintf (perror_msg, "fclose(footer_fp)");
+  logger(DEBUG, perror_msg);
+  if (footer_fp)
+    {
+      if (fclose (footer_fp) == EXIT_SUCCESS)
+        {
+          _PASS;
+          footer_fp = NULL;
+        }
+      else
+        {
+          perror (perror_msg);
+          _FAIL;
+          return (errno);
+        }
+    }
+
+  /// Create strings and their lengths
+  fprintf (dest_fp, "  ; === Strings ===;\n");
+  for (i = 0; i < strs_len; i++)
+    {
+      fprintf (dest_fp, "  msg%d: DB \"", i);
+      /// Read each string character
+      const char *str = get_interned_str (strs[i]);
+      int j = 0;
+      for (j = 0; str[j]; j++)
+        {
+          ///print ASCII values for newlines
+          if (str[j] == '\\' && str[j + 1] == 'n')
+            {
+              fprintf (dest_fp, "\", 13, 10, \"");
+              j = j + 1;
+            }
+
+          /// directly print all other characters
+          else
+            fprintf (dest_fp, "%c", str[j]);
+        }
+
+      /// NULL terminate string
+      fprintf (dest_fp, "\", NULL\n");
+
+      /// Print string length
+      fprintf (dest_fp, "  len%d EQU $ - msg%d\n", i, i);
+    }
+
+  if (strs_len > 0)
+    {
+      /// Print string array
+      fprintf (dest_fp, "  strs: DQ ");
+      for (i = 0; i < strs_len; i++)
+        {
+          fprintf (dest_fp, "msg%d, ", i);
+        }
+      fprintf (dest_fp, "\n");
+
+      /// ...and length array
+      fprintf (dest_fp, "  lens: DQ ");
+      for (i = 0; i < strs_len; i++)
+        {
+          fprintf (dest_fp, "len%d, ", i);
+        }
+      fprintf (dest_fp, "\n");
+    }
+
+  /// Create integers array
+  if (vars_len > 0)
+    {
+      logger(DEBUG, "Create data array of length: %d", vars_len);
+      fprintf (dest_fp, "  ; === Integers ===;\n  data  TIMES %d DQ 0\n",
+               vars_len);
+    }
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Print assembly code list to HTML report file
+ *
+ * @param       cmd_list    Assembly command list to print
+ * @param       dest_fp   Destination HTML reportfile pointer
+ *
+ * @return      Function exit code
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    On error
+ */
+short
+print_asm_code_html (asm_cmd_e cmd_list[], FILE *dest_fp)
+{
+  logger(DEBUG, "=== START ===");
+
+  fprintf (dest_fp, "<h3>0-address stack machine code by Code generator "
+           "<code>GENIE</code></h3>\n<hr>\n");
+
+  fprintf (dest_fp,
+           "<textarea style='resize: none;' readonly rows='25' cols='80'>");
+
+  int i = 0;
+  logger(DEBUG, "Print ASM user code to HTML");
+  for (i = 0; i < asm_cmd_list_len; i++)
+    {
+      switch (asm_cmd_list[i].cmd)
+        {
+        case asm_Fetch:
+        case asm_Store:
+        case asm_StoreKeep:
+        case asm_Push:
+          fprintf (dest_fp, "  %s\t%d\n", asm_cmds[asm_cmd_list[i].cmd],
+                   asm_cmd_list[i].intval);
+          break;
+        case asm_Add:
+        case asm_Sub:
+        case asm_Negate:
+        case asm_Mul:
+        case asm_Div:
+        case asm_Mod:
+        case asm_Eq:
+        case asm_Neq:
+        case asm_Lss:
+        case asm_Gtr:
+        case asm_Leq:
+        case asm_Geq:
+        case asm_And:
+        case asm_Or:
+        case asm_Not:
+        case asm_Prts:
+        case asm_Input:
+        case asm_Prti:
+        case asm_HALT:
+          fprintf (dest_fp, "  %s\n", asm_cmds[asm_cmd_list[i].cmd]);
+          break;
+        case asm_Label:
+          fprintf (dest_fp, "%s:\n",
+                   get_interned_str (asm_cmd_list[i].label));
+          break;
+        case asm_Jz:
+        case asm_Jnz:
+        case asm_Jeq:
+        case asm_Jneq:
+        case asm_Jlss:
+        case asm_Jgtr:
+        case asm_Jleq:
+        case asm_Jgeq:
+        case asm_Jmp:
+          fprintf (dest_fp, "  %s\t\t%s\n", asm_cmds[asm_cmd_list[i].cmd],
+                   get_interned_str (asm_cmd_list[i].label));
+          break;
+        default:
+          fprintf(stderr, "Unknown opcode %d\n", asm_cmd_list[i].cmd);
+          exit (opal_exit (EXIT_FAILURE));
+        }
+    }
+  _DONE;
+
+  /// Create strings and their lengths
+  fprintf (dest_fp, "  ; === Strings ===;\n");
+  for (i = 0; i < strs_len; i++)
+    {
+      fprintf (dest_fp, "  msg%d: DB \"", i);
+      /// Read each string character
+      const char *str = get_interned_str (strs[i]);
+      int j = 0;
+      for (j = 0; str[j]; j++)
+        {
+          ///print ASCII values for newlines
+          if (str[j] == '\\' && str[j + 1] == 'n')
+            {
+              fprintf (dest_fp, "\", 13, 10, \"");
+              j = j + 1;
+            }
+
+          /// directly print all other characters
+          else
+            fprintf (dest_fp, "%c", str[j]);
+        }
+
+      /// NULL terminate string
+      fprintf (dest_fp, "\", NULL\n");
+
+      /// Print string length
+      fprintf (dest_fp, "  len%d EQU $ - msg%d\n", i, i);
+    }
+
+  if (strs_len > 0)
+    {
+      /// Print string array
+      fprintf (dest_fp, "  strs: DQ ");
+      for (i = 0; i < strs_len; i++)
+        fprintf (dest_fp, "msg%d, ", i);
+
+      fprintf (dest_fp, "\n");
+
+      /// ...and length array
+      fprintf (dest_fp, "  lens: DQ ");
+      for (i = 0; i < strs_len; i++)
+        fprintf (dest_fp, "len%d, ", i);
+
+      fprintf (dest_fp, "\n");
+    }
+
+  /// Create integers array
+  if (vars_len > 0)
+    {
+      logger(DEBUG, "Create data array of length: %d", vars_len);
+      fprintf (dest_fp, "  ; === Integers ===;\n  data  TIMES %d DQ 0\n",
+               vars_len);
+    }
+
+  fprintf (dest_fp, "</textarea>");
+  logger(DEBUG, "=== END ===");
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief       Print value of expression node as C operand
+ *
+ * @details     Integers, variables and strings are printed as they are,
+ * other nodes by the temporary print_c_expr() computed them in.
+ *
+ * @param[in]   tree        Expression node index
+ * @param[in]   dest_fp     Destination file pointer
+ *
+ * @return      None
+ */
+void
+print_c_value (unsigned int tree, FILE *dest_fp)
+{
+  const node_s *node = &ast.nodes[tree];
+
+  switch (node->node_type)
+    {
+    case nd_Integer:
+      fprintf (dest_fp, node->int_val < 0 ? "(%d)" : "%d", node->int_val);
+      break;
+    case nd_Ident:
+      fprintf (dest_fp, "v_%s", get_interned_str (node->str_id));
+      break;
+    case nd_String:
+      fprintf (dest_fp, "%d", add_str (node->str_id));
+      break;
+    default:
+      fprintf (dest_fp, "t_%u", tree);
+    }
+}
+
+/**
+ * @brief       Print C statements computing expression of syntax tree
+ *
+ * @details     Every operator gets an int64_t temporary, declared once its
+ * operands are computed, so the operands are evaluated left to right like
+ * GENIE does and gcc never sees a nested expression, however deep the
+ * tree. Arithmetic calls the wrapping functions of res/header.c,
+ * comparisons are the C ones, which give 1 or 0 like the stack machine.
+ * && and || jump over the statements of their right operand when the left
+ * one decides the value. The tree is walked in post-order on an explicit
+ * stack. print_c_value() prints the value of the expression afterwards.
+ *
+ * @param[in]   tree        Expression node index
+ * @param[in]   indent      Number of spaces to indent by
+ * @param[in]   dest_fp     Destination file pointer
+ *
+ * @return      None
+ */
+void
+print_c_expr (unsigned int tree, int indent, FILE *dest_fp)
+{
+  unsigned int *stack = NULL, *stage = NULL;
+  unsigned int stack_cap = 0, stage_cap = 0, len = 0, next = 0;
+  const node_s *node = NULL;
+  const char *op = NULL;
+
+  grow_index_array (&stack, &stack_cap, 1);
+  grow_index_array (&stage, &stage_cap, 1);
+  stack[len] = tree;
+  stage[len++] = 0;
+
+  while (len)
+    {
+      tree = stack[len - 1];
+      node = &ast.nodes[tree];
+
+      /// Leaves are operands, printed where they are used
+      if (node->node_type == nd_Integer || node->node_type == nd_Ident
+          || node->node_type == nd_String)
+        {
+          len--;
+          continue;
+        }
+
+      /// Compute the left operand, then the right one if any, then the node
+      if (stage[len - 1] < 2)
+        {
+          if (stage[len - 1]++ == 0)
+            next = node->left;
+          else
+            {
+              next = node->right;
+              if (node->node_type == nd_And || node->node_type == nd_Or)
+                {
+                  fprintf (dest_fp, "%*sint64_t t_%u = ", indent, "", tree);
+                  print_c_value (node->left, dest_fp);
+                  fprintf (dest_fp, " != 0;\n%*sif (%st_%u)\n", indent, "",
+                           node->node_type == nd_And ? "!" : "", tree);
+                  fprintf (dest_fp, "%*sgoto s_%u;\n", indent + 2, "", tree);
+                }
+            }
+
+          if (next)
+            {
+              grow_index_array (&stack, &stack_cap, len + 1);
+              grow_index_array (&stage, &stage_cap, len + 1);
+              stack[len] = next;
+              stage[len++] = 0;
+            }
+          continue;
+        }
+      len--;
+
+      switch (node->node_type)
+        {
+        case nd_Input:
+          fprintf (dest_fp, "%*sint64_t t_%u = O_INPUT (", indent, "", tree);
+          print_c_value (node->left, dest_fp);
+          fprintf (dest_fp, ");\n");
+          break;
+        case nd_Negate:
+          fprintf (dest_fp, "%*sint64_t t_%u = o_neg (", indent, "", tree);
+          print_c_value (node->left, dest_fp);
+          fprintf (dest_fp, ");\n");
+          break;
+        case nd_Not:
+          fprintf (dest_fp, "%*sint64_t t_%u = !", indent, "", tree);
+          print_c_value (node->left, dest_fp);
+          fprintf (dest_fp, ";\n");
+          break;
+        case nd_And:
+        case nd_Or:
+          fprintf (dest_fp, "%*st_%u = ", indent, "", tree);
+          print_c_value (node->right, dest_fp);
+          fprintf (dest_fp, " != 0;\n%*ss_%u:;\n", indent, "", tree);
+          break;
+        case nd_Add:
+        case nd_Sub:
+        case nd_Mul:
+        case nd_Div:
+        case nd_Mod:
+        case nd_Eq:
+        case nd_Neq:
+        case nd_Lss:
+        case nd_Gtr:
+        case nd_Leq:
+        case nd_Geq:
+          op = c_ops[node->node_type];
+          fprintf (dest_fp, "%*sint64_t t_%u = ", indent, "", tree);
+          if (!ispunct ((unsigned char) op[0]))
+            fprintf (dest_fp, "%s (", op);
+          print_c_value (node->left, dest_fp);
+          fprintf (dest_fp, ispunct ((unsigned char) op[0]) ? " %s " : ", ",
+                   op);
+          print_c_value (node->right, dest_fp);
+          fprintf (dest_fp, ispunct ((unsigned char) op[0]) ? ";\n" : ");\n");
+          break;
+        default:
+          fprintf (stderr, "Unexpected operator: %s\n",
+                   node_name[node->node_type]);
+          exit (opal_exit (EXIT_FAILURE));
+        }
+    }
+
+  free (stack);
+  free (stage);
+}
+
+/**
+ * @brief       Print statement of syntax tree as C statement
+ *
+ * @details     While and if nodes become C while and if statements, so gcc
+ * sees the loops of the program as written. A loop condition that needs
+ * statements to compute is computed at the top of a for (;;) loop, which
+ * it breaks out of.
+ *
+ * @param[in]   tree        Statement node index, 0 for none
+ * @param[in]   indent      Number of spaces to indent by
+ * @param[in]   dest_fp     Destination file pointer
+ *
+ * @return      None
+ */
+void
+print_c_stmt (unsigned int tree, int indent, FILE *dest_fp)
+{
+  const node_s *node = &ast.nodes[tree];
+  const node_s *branch = NULL;
+  const node_s *cond = NULL;
+  unsigned int i = 0;
+
+  if (!tree)
+    return;
+
+  switch (node->node_type)
+    {
+    case nd_Sequence:
+      for (i = 0; i < node->len; i++)
+        print_c_stmt (ast.list[node->first + i], indent, dest_fp);
+      break;
+    case nd_While:
+      cond = &ast.nodes[node->left];
+      if (cond->node_type == nd_Integer || cond->node_type == nd_Ident
+          || cond->node_type == nd_String)
+        {
+          fprintf (dest_fp, "%*swhile (", indent, "");
+          print_c_value (node->left, dest_fp);
+          fprintf (dest_fp, ")\n%*s{\n", indent, "");
+        }
+      else
+        {
+          fprintf (dest_fp, "%*sfor (;;)\n%*s{\n", indent, "", indent, "");
+          print_c_expr (node->left, indent + 2, dest_fp);
+          fprintf (dest_fp, "%*sif (!", indent + 2, "");
+          print_c_value (node->left, dest_fp);
+          fprintf (dest_fp, ")\n%*sbreak;\n", indent + 4, "");
+        }
+      print_c_stmt (node->right, indent + 2, dest_fp);
+      fprintf (dest_fp, "%*s}\n", indent, "");
+      break;
+    case nd_If:
+      branch = &ast.nodes[node->right];
+      print_c_expr (node->left, indent, dest_fp);
+      fprintf (dest_fp, "%*sif (", indent, "");
+      print_c_value (node->left, dest_fp);
+      fprintf (dest_fp, ")\n%*s{\n", indent, "");
+      print_c_stmt (branch->left, indent + 2, dest_fp);
+      fprintf (dest_fp, "%*s}\n", indent, "");
+      if (branch->right)
+        {
+          fprintf (dest_fp, "%*selse\n%*s{\n", indent, "", indent, "");
+          print_c_stmt (branch->right, indent + 2, dest_fp);
+          fprintf (dest_fp, "%*s}\n", indent, "");
+        }
+      break;
+    case nd_Assign:
+      print_c_expr (node->right, indent, dest_fp);
+      fprintf (dest_fp, "%*sv_%s = ", indent, "",
+               get_interned_str (ast.nodes[node->left].str_id));
+      print_c_value (node->right, dest_fp);
+      fprintf (dest_fp, ";\n");
+      break;
+    case nd_Prti:
+      print_c_expr (node->left, indent, dest_fp);
+      fprintf (dest_fp, "%*so_prti (", indent, "");
+      print_c_value (node->left, dest_fp);
+      fprintf (dest_fp, ");\n");
+      break;
+    case nd_Prts:
+      print_c_expr (node->left, indent, dest_fp);
+      fprintf (dest_fp, "%*sO_PRTS (", indent, "");
+      print_c_value (node->left, dest_fp);
+      fprintf (dest_fp, ");\n");
+      break;
+    default:
+      print_c_expr (tree, indent, dest_fp);
+      fprintf (dest_fp, "%*s(void) ", indent, "");
+      print_c_value (tree, dest_fp);
+      fprintf (dest_fp, ";\n");
+    }
+}
+
+/**
+ * @brief       Print syntax tree as C program
+ *
+ * @details     The runtime of res/header.c comes first, then the strings as
+ * printed and main() with a local int64_t for every variable. The variables
+ * and strings are those found by gen_asm_code(), which must run first.
+ *
+ * @param[in]   tree        Syntax tree root node index
+ * @param[in]   dest_fp     Destination file pointer
+ *
+ * @return      Function exit code
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      errno           On system call failure
+ */
+short
+print_c_code (unsigned int tree, FILE *dest_fp)
+{
+  logger(DEBUG, "=== START ===");
+  assert(dest_fp);
+  unsigned int i = 0, j = 0, len = 0;
+
+  /// Copy the runtime
+  sprintf (perror_msg, "header_fp = fopen('res/header.c', 'r')");
+  logger(DEBUG, perror_msg);
+  FILE *header_fp = fopen ("res/header.c", "r");
+  if (!header_fp)
+    {
+      perror (perror_msg);
+      _FAIL;
+      return (errno);
+    }
+  _PASS;
+
+  int ch = 0;
+  while ((ch = fgetc (header_fp)) != EOF)
+    fputc (ch, dest_fp);
+  fclose (header_fp);
+
+  /// Strings as printed, octal escapes keep the bytes as they are
+  fprintf (dest_fp, "\nstatic const o_str_s o_strs[] =\n  {\n");
+  for (i = 0; i < strs_len; i++)
+    {
+      const char *str = get_interned_str (strs[i]);
+      unsigned char *bytes = malloc (strlen (str) + 1);
+      if (!bytes)
+        {
+          perror ("malloc (c_str)");
+          return (errno);
+        }
+
+      len = encode_str (bytes, str);
+      fprintf (dest_fp, "    { (const unsigned char *) \"");
+      for (j = 0; j + 1 < len; j++)
+        if (isalnum (bytes[j]) || bytes[j] == ' ')
+          fputc (bytes[j], dest_fp);
+        else
+          fprintf (dest_fp, "\\%03o", bytes[j]);
+      fprintf (dest_fp, "\", %u },\n", len);
+      free (bytes);
+    }
+  fprintf (dest_fp, "    { 0 }\n  };\n\nint\nmain (void)\n{\n");
+
+  for (i = 0; i < vars_len; i++)
+    fprintf (dest_fp, "  int64_t v_%s = 0;\n", get_interned_str (vars[i]));
+  if (vars_len)
+    fprintf (dest_fp, "\n");
+
+  print_c_stmt (tree, 2, dest_fp);
+  fprintf (dest_fp, "\n  o_flush ();\n  return EXIT_SUCCESS;\n}\n");
+
+  logger(DEBUG, "=== END ===");
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief       Grow slot lookup array to cover every interned id
+ *
+ * @param[in,out]   slot        Array of slot index + 1 by interned id
+ * @param[in,out]   slot_len    Number of ids covered by the array
+ *
+ * @return      None
+ */
+void
+grow_slot_map (unsigned int **slot, unsigned int *slot_len)
+{
+  if (*slot_len >= str_table.count)
+    return;
+
+  /// Cover all ids the string table has room for, new ids are unused
+  unsigned int len = str_table.cap;
+  unsigned int *map = arena_alloc (&asm_arena, len * sizeof(unsigned int));
+  if (*slot_len)
+    memcpy (map, *slot, *slot_len * sizeof(unsigned int));
+
+  *slot = map;
+  *slot_len = len;
+}
+
+/**
+ * @brief       Get index of an identifier in array, add if missing
+ *
+ * @param[in]   ident_id   interned identifier to get index for
+ *
+ * @return      index of identifier in the array
+ */
+int
+add_var (unsigned int ident_id)
+{
+  /// Look the identifier up by its interned id
+  grow_slot_map (&var_slot, &var_slot_len);
+  if (var_slot[ident_id])
+    {
+      logger(DEBUG, "Identifier '%s' found at index %d.",
+             get_interned_str (ident_id), var_slot[ident_id] - 1);
+      return var_slot[ident_id] - 1;
+    }
+
+  int index = vars_len;
+  /// Otherwise append the identifier to the array
+  logger(DEBUG, "Created new identifier '%s' at index %d.",
+         get_interned_str (ident_id), index);
+  grow_index_array (&vars, &vars_cap, vars_len + 1);
+  vars[vars_len++] = ident_id;
+  var_slot[ident_id] = vars_len;
+
+  /// and return its index
+  return index;
+}
+
+/**
+ * @brief       Get index of a string in array, add if missing
+ *
+ * @param[in]   str_id   interned string to get index for
+ *
+ * @return      index of string in the array
+ */
+int
+add_str (unsigned int str_id)
+{
+  /// Look the string up by its interned id
+  grow_slot_map (&str_slot, &str_slot_len);
+  if (str_slot[str_id])
+    {
+      logger(DEBUG, "Identifier '%s' found at index %d.",
+             get_interned_str (str_id), str_slot[str_id] - 1);
+      return str_slot[str_id] - 1;
+    }
+
+  int index = strs_len;
+  /// Otherwise append the string to the array
+  logger(DEBUG, "Created new identifier '%s' at index %d.",
+         get_interned_str (str_id), index);
+  grow_index_array (&strs, &strs_cap, strs_len + 1);
+  strs[strs_len++] = str_id;
+  str_slot[str_id] = strs_len;
+
+  /// and return its index
+  return index;
+}
+
+/**
+ * @brief Free assembly command list, vars & strs arrays and their lookups
+ * @param NONE
+ */
+short
+free_asm_arrays ()
+{
+  free (asm_cmd_list);
+  asm_cmd_list = NULL;
+  asm_cmd_list_len = asm_cmd_list_cap = 0;
+
+  free (vars);
+  vars = NULL;
+  vars_len = vars_cap = 0;
+
+  free (strs);
+  strs = NULL;
+  strs_len = strs_cap = 0;
+
+  free (asm_tasks);
+  asm_tasks = NULL;
+  asm_tasks_len = asm_tasks_cap = 0;
+
+  /// Names are owned by the string table, the lookups by asm_arena
+  arena_free (&asm_arena);
+
+  var_slot = NULL;
+  var_slot_len = 0;
+  str_slot = NULL;
+  str_slot_len = 0;
+  label_refs = NULL;
+  label_refs_len = 0;
+
+  return EXIT_SUCCESS;
+}
+
+/*
+ * ==================================
+ * START ORCHESTRATOR FUNCTION DEFINITIONS
+ * ==================================
+ */
+
+/**
+ * @brief          Assemble object file using NASM
+ * @param asm_fn   Assembly source file name
+ * @param obj_fn   Object destination file name
+ */
+short
+gen_obj (char *asm_fn, char *obj_fn)
+{
+    logger(DEBUG, "=== START ===");
+    /// Assert assembly file name is not null
+    assert(asm_fn);
+    /// Assert object file name is not null
+    assert(obj_fn);
+    /// Check if asm_fn can be read
+    sprintf(perror_msg, "access (%s, R_OK)", asm_fn);
+    logger(DEBUG, perror_msg);
+    errno = EXIT_SUCCESS;
+    if (access (asm_fn, R_OK) == EXIT_SUCCESS)
+    {
+        _PASS;
+        /// Create the NASM call with -g, -f and -o flags
+        logger(DEBUG, "Calling NASM to assemble object.");
+        char nasm_cmd[1024] = { 0 };
+        sprintf (nasm_cmd, "nasm -g -f elf64 -o %s %s", obj_fn, asm_fn);
+        logger(DEBUG, nasm_cmd);
+        int sys_call = system (nasm_cmd);
+        if (sys_call == EXIT_SUCCESS)
+        {
+            _PASS;
+            /// Check if obj_fn can be read
+            sprintf (perror_msg, "access (%s, R_OK)", obj_fn);
+            logger(DEBUG, perror_msg);
+            errno = EXIT_SUCCESS;
+            if (access (obj_fn, R_OK) == EXIT_SUCCESS)
+                _PASS;
+            else
+            {
+                perror (perror_msg);
+                _FAIL;
+                return (errno);
+            }
+        }
+        else
+        {
+            perror (nasm_cmd);
+            _FAIL;
+            return (sys_call);
+        }
+    }
+    else
+    {
+        perror (perror_msg);
+        _FAIL;
+        return (errno);
+    }
+    logger(DEBUG, "=== END ===");
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * @brief           Link object using LD
+ * @param obj_fn    Source object file name
+ * @param dest_fn   Destination binary file name
+ */
+short
+gen_bin (char *obj_fn, char *dest_fn)
+{
+  logger(DEBUG, "=== START ===");
+
+  /// Assert object file name is not null
+  assert(obj_fn);
+
+  /// Assert destination file name is not null
+  assert(dest_fn);
+
+  /// Call to linker
+  logger(DEBUG, "Calling LD to link object.");
+  char LD_cmd[1024] = { 0 };
+  sprintf(LD_cmd, "ld -m elf_x86_64 -o %s -lc -I/lib64/ld-linux-x86-64.so.2 %s", dest_fn, obj_fn);
+
+  /// Confirm obj_fn can be read
+  logger(DEBUG, "access(obj_fn, R_OK)");
+  errno = EXIT_SUCCESS;
+  if (access(obj_fn, R_OK) == 0)
+    {
+
+      /// Use LD to link the obj_fn contents
+      logger(DEBUG, "ld -m elf_x86_64 -o %s -lc -I/lib64/ld-linux-x86-64.so.2 %s", dest_fn, obj_fn);
+      errno = EXIT_SUCCESS;
+      int sys_call = system(LD_cmd);
+
+      /// Confirm successful linking
+      if (sys_call == 0)
+        {
+          /// Confirm dest_fn can be read to and executed
+          logger(DEBUG, "access(obj_fn, R_OK) && access(obj_fn, X_OK)");
+          errno = EXIT_SUCCESS;
+          if ((access(dest_fn, R_OK) == 0) && (access(dest_fn, X_OK) == 0))
+            _PASS;
+
+            /// Return errno if missing permissions on dest_fn
+          else
+            {
+              perror("access(obj_fn, R_OK) && access(obj_fn, X_OK)");
+              return errno;
+            }
+        }
+
+      /// ...or log command if unsuccessful
+      else{
+        perror(LD_cmd);
+        return sys_call;
+      }
+    }
+
+  /// ...or missing read permission on obj_fn
+  else
+    {
+      perror("access(obj_fn, R_OK)");
+      return errno;
+    }
+
+  logger(DEBUG, "=== END ===");
 
-  /// Close header file pointer if not NULL
-  sprintf (perror_msg, "fclose(header_fp)");
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief           Compile C program using gcc
+ *
+ * @param c_fn      C source file name, written by print_c_code()
+ * @param dest_fn   Destination binary file name
+ *
+ * @return      Function exit code
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    On compile error
+ * @retval      errno           On system call failure
+ */
+short
+gen_c_bin (char *c_fn, char *dest_fn)
+{
+  logger(DEBUG, "=== START ===");
+  assert(c_fn);
+  assert(dest_fn);
+
+  /// Compile with the optimizer, the source has no extension
+  char gcc_cmd[1024] = { 0 };
+  sprintf (gcc_cmd, "gcc -O2 -x c -o %s %s", dest_fn, c_fn);
+  logger(DEBUG, gcc_cmd);
+  int sys_call = system (gcc_cmd);
+  if (sys_call != EXIT_SUCCESS)
+    {
+      logger(ERROR, "'%s' failed with status %d", gcc_cmd, sys_call);
+      _FAIL;
+      return EXIT_FAILURE;
+    }
+  _PASS;
+
+  /// Confirm dest_fn can be executed
+  sprintf (perror_msg, "access (%s, X_OK)", dest_fn);
   logger(DEBUG, perror_msg);
-  if (header_fp)
-  {
-      if (fclose (header_fp) == EXIT_SUCCESS)
+  if (access (dest_fn, X_OK) != EXIT_SUCCESS)
+    {
+      perror (perror_msg);
+      _FAIL;
+      return (errno);
+    }
+  _PASS;
+
+  logger(DEBUG, "=== END ===");
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief       Append bytes to x86 image code
+ *
+ * @param[in]   img         x86 image to append to
+ * @param[in]   bytes       Machine code bytes
+ * @param[in]   len         Number of bytes
+ *
+ * @return      None
+ */
+void
+x86_emit (x86_image_s *img, const char *bytes, unsigned int len)
+{
+  if (img->code_len + len > img->code_cap)
+    {
+      unsigned int cap = img->code_cap ? img->code_cap : 4096;
+      while (img->code_len + len > cap)
+        cap *= 2;
+
+      unsigned char *code = realloc (img->code, cap);
+      if (!code)
+        {
+          perror ("realloc (img->code)");
+          exit (opal_exit (errno));
+        }
+      img->code = code;
+      img->code_cap = cap;
+    }
+
+  memcpy (img->code + img->code_len, bytes, len);
+  img->code_len += len;
+}
+
+/**
+ * @brief       Append 32 bit little endian value to x86 image code
+ *
+ * @param[in]   img         x86 image to append to
+ * @param[in]   value       Immediate, displacement or address
+ *
+ * @return      None
+ */
+void
+x86_emit_u32 (x86_image_s *img, uint32_t value)
+{
+  unsigned char bytes[4] = { value, value >> 8, value >> 16, value >> 24 };
+  x86_emit (img, (const char*) bytes, 4);
+}
+
+/**
+ * @brief       Append jump to label, patched by x86_patch_jumps()
+ *
+ * @param[in]   img         x86 image to append to
+ * @param[in]   op          Bytes up to the rel32 of the jump
+ * @param[in]   len         Number of bytes in op
+ * @param[in]   label       Interned label jumped to
+ *
+ * @return      None
+ */
+void
+x86_emit_jump (x86_image_s *img, const char *op, unsigned int len,
+               unsigned int label)
+{
+  x86_emit (img, op, len);
+
+  if (img->fixups_len == img->fixups_cap)
+    {
+      unsigned int cap = img->fixups_cap ? img->fixups_cap * 2 : 64;
+      x86_fixup_s *fixups = realloc (img->fixups, cap * sizeof(x86_fixup_s));
+      if (!fixups)
+        {
+          perror ("realloc (img->fixups)");
+          exit (opal_exit (errno));
+        }
+      img->fixups = fixups;
+      img->fixups_cap = cap;
+    }
+  img->fixups[img->fixups_len].offset = img->code_len;
+  img->fixups[img->fixups_len].label = label;
+  img->fixups_len++;
+
+  x86_emit_u32 (img, 0);
+}
+
+/**
+ * @brief       Append call of x86_runtime routine
+ *
+ * @param[in]   img         x86 image to append to
+ * @param[in]   routine     Offset of the routine, X86_RT_WRITE, X86_RT_PRTI,
+ *                          X86_RT_INPUT, X86_RT_HALT or X86_RT_INIT
+ *
+ * @return      None
+ */
+void
+x86_emit_call (x86_image_s *img, unsigned int routine)
+{
+  x86_emit (img, "\xe8", 1);
+  x86_emit_u32 (img, routine - (img->code_len + 4));
+}
+
+/**
+ * @brief       Append push, pop or copy of a variable pinned to a register
+ *
+ * @param[in]   img         x86 image to append to
+ * @param[in]   cmd         asm_Fetch, asm_Store or asm_StoreKeep
+ * @param[in]   pin         pin_names index of the register
+ *
+ * @return      None
+ */
+void
+x86_emit_pinned (x86_image_s *img, asm_code_e cmd, int pin)
+{
+  unsigned char reg = pin_regs[pin];
+
+  /// R12 - R15 need REX.B to push and pop, REX.R as MOV destination
+  if (cmd == asm_StoreKeep)
+    {
+      unsigned char op[4] = { 0x48 | (reg >> 3) << 2, 0x8b,
+          0x04 | (reg & 7) << 3, 0x24 };        /* MOV reg, [RSP] */
+      x86_emit (img, (const char*) op, 4);
+      return;
+    }
+  if (reg >> 3)
+    x86_emit (img, "\x41", 1);
+  unsigned char op = (cmd == asm_Fetch ? 0x50 : 0x58) | (reg & 7);
+  x86_emit (img, (const char*) &op, 1);         /* PUSH reg / POP reg */
+}
+
+/**
+ * @brief       Patch jump offsets once all labels are placed
+ *
+ * @param[in]   img         x86 image to patch
+ *
+ * @return      None
+ */
+void
+x86_patch_jumps (x86_image_s *img)
+{
+  unsigned int i = 0, j = 0;
+
+  for (i = 0; i < img->fixups_len; i++)
+    {
+      x86_fixup_s *fix = &img->fixups[i];
+      if (fix->label >= img->label_at_len || !img->label_at[fix->label])
+        {
+          logger(ERROR, "Jump to undefined label '%s'",
+                 get_interned_str (fix->label));
+          exit (opal_exit (EXIT_FAILURE));
+        }
+
+      uint32_t rel = img->label_at[fix->label] - 1 - (fix->offset + 4);
+      for (j = 0; j < 4; j++)
+        img->code[fix->offset + j] = rel >> 8 * j;
+    }
+}
+
+/**
+ * @brief       Encode string as printed by the program, "\n" becomes CR LF
+ *              and the NUL terminator is printed as by print_asm_code()
+ *
+ * @param[out]  out         Buffer of at least strlen(str) + 1 bytes
+ * @param[in]   str         String from the strs array
+ *
+ * @return      Number of bytes written, including the NUL terminator
+ */
+unsigned int
+encode_str (unsigned char *out, const char *str)
+{
+  unsigned int i = 0, len = 0;
+
+  for (i = 0; str[i]; i++)
+    if (str[i] == '\\' && str[i + 1] == 'n')
       {
-          _PASS;
-          header_fp = NULL;
+        out[len++] = 13;
+        out[len++] = 10;
+        i++;
       }
-      else
+    else
+      out[len++] = str[i];
+  out[len++] = '\0';
+
+  return len;
+}
+
+/**
+ * @brief       Get size of the data encoded by x86_encode()
+ *
+ * @return      Bytes of string tables and strings, a multiple of 8
+ */
+unsigned int
+x86_data_len (void)
+{
+  unsigned int i = 0, len = 16 * strs_len;
+
+  for (i = 0; i < strs_len; i++)
+    len += strlen (get_interned_str (strs[i])) + 1;
+
+  return (len + 7) & ~7u;
+}
+
+/**
+ * @brief       Encode assembly command list as x86-64 machine code and data
+ *
+ * @details     The code is the equivalent of the stack macros of
+ * res/header.asm, honoring variables pinned by --pin-vars. It starts with
+ * x86_runtime, the user code follows. Strings, variables and the runtime
+ * data are addressed absolutely, so data_addr plus their size must stay
+ * below 2 GiB.
+ *
+ * @param[out]  img         x86 image to fill, freed with free_x86_image()
+ * @param[in]   data_addr   Address data will be loaded at
+ *
+ * @return      Function exit code
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    On error
+ */
+short
+x86_encode (x86_image_s *img, uint64_t data_addr)
+{
+  logger(DEBUG, "=== START ===");
+  assert(img);
+  memset (img, 0, sizeof(x86_image_s));
+  unsigned int i = 0;
+
+  /// Strings follow their address and length tables
+  img->data_addr = data_addr;
+  img->data_len = x86_data_len ();
+
+  img->data = calloc (img->data_len + 8, 1);
+  if (!img->data)
+    {
+      perror ("calloc (img->data)");
+      return (errno);
+    }
+
+  unsigned char *out = img->data + 16 * strs_len;
+  for (i = 0; i < strs_len; i++)
+    {
+      uint64_t addr = data_addr + (out - img->data);
+      uint64_t len = encode_str (out, get_interned_str (strs[i]));
+      memcpy (img->data + 8 * i, &addr, 8);
+      memcpy (img->data + 8 * (strs_len + i), &len, 8);
+      out += len;
+    }
+
+  /// Variables and the runtime data are zeroed by the loader
+  img->vars_addr = data_addr + img->data_len;
+  img->bss_len = 8 * vars_len + X86_RT_DATA_SIZE;
+  if (img->vars_addr + img->bss_len > INT32_MAX)
+    {
+      logger(ERROR, "Data at 0x%lx does not fit 32 bit addresses",
+             (unsigned long) data_addr);
+      return EXIT_FAILURE;
+    }
+
+  uint32_t strs_at = data_addr, lens_at = data_addr + 8 * strs_len;
+  uint32_t rt_data_at = img->vars_addr + 8 * vars_len;
+
+  /// Runtime first, pointed at its data, then install its SIGFPE handler
+  /// and zero the pinned variables
+  x86_emit (img, (const char*) x86_runtime, sizeof(x86_runtime));
+  for (i = 0; i < sizeof(x86_runtime_relocs) / sizeof(*x86_runtime_relocs);
+      i++)
+    {
+      uint32_t addr = 0;
+      memcpy (&addr, img->code + x86_runtime_relocs[i], 4);
+      addr += rt_data_at;
+      memcpy (img->code + x86_runtime_relocs[i], &addr, 4);
+    }
+  x86_emit_call (img, X86_RT_INIT);
+  pin_hot_vars (NULL);
+  for (i = 0; i < vars_len; i++)
+    if (var_pin[i] >= 0)
       {
-          perror (perror_msg);
-          _FAIL;
-          return (errno);
+        unsigned char reg = pin_regs[var_pin[i]];
+        unsigned char op[3] = { 0x48 | (reg >> 3) * 5, 0x31,
+            0xc0 | (reg & 7) * 9 };
+        x86_emit (img, (const char*) op, 3);    /* XOR reg, reg */
       }
-  }
 
-  /// Print user code
-  int i = 0;
-  logger(DEBUG, "Print ASM user code");
+  /// SETcc opcodes by asm_Eq .. asm_Geq, Jcc is 0x10 below
+  const unsigned char setcc[] = { 0x94, 0x95, 0x9c, 0x9f, 0x9e, 0x9d };
+
+  grow_slot_map (&img->label_at, &img->label_at_len);
   for (i = 0; i < asm_cmd_list_len; i++)
     {
-      switch (asm_cmd_list[i].cmd)
+      asm_cmd_e *cmd = &asm_cmd_list[i];
+      if ((cmd->cmd == asm_Fetch || cmd->cmd == asm_Store
+          || cmd->cmd == asm_StoreKeep) && var_pin[cmd->intval] >= 0)
+        {
+          x86_emit_pinned (img, cmd->cmd, var_pin[cmd->intval]);
+          continue;
+        }
+
+      uint32_t var = img->vars_addr + 8 * cmd->intval;
+      switch (cmd->cmd)
         {
+        case asm_Push:
+          x86_emit (img, "\x68", 1);            /* PUSH imm32 */
+          x86_emit_u32 (img, cmd->intval);
+          break;
         case asm_Fetch:
+          x86_emit (img, "\xff\x34\x25", 3);    /* PUSH QWORD [var] */
+          x86_emit_u32 (img, var);
+          break;
         case asm_Store:
-        case asm_Push:
-          fprintf (dest_fp, "  %s\t%d\n", asm_cmds[asm_cmd_list[i].cmd],
-                   asm_cmd_list[i].intval);
+          x86_emit (img, "\x8f\x04\x25", 3);    /* POP QWORD [var] */
+          x86_emit_u32 (img, var);
+          break;
+        case asm_StoreKeep:
+          /* MOV RAX, [RSP]; MOV [var], RAX */
+          x86_emit (img, "\x48\x8b\x04\x24\x48\x89\x04\x25", 8);
+          x86_emit_u32 (img, var);
           break;
         case asm_Add:
+          /* POP RAX; POP RBX; ADD RAX, RBX; PUSH RAX */
+          x86_emit (img, "\x58\x5b\x48\x01\xd8\x50", 6);
+          break;
         case asm_Sub:
-        case asm_Negate:
+          /* POP RBX; POP RAX; SUB RAX, RBX; PUSH RAX */
+          x86_emit (img, "\x5b\x58\x48\x29\xd8\x50", 6);
+          break;
         case asm_Mul:
+          /* POP RAX; POP RBX; IMUL RBX; PUSH RAX */
+          x86_emit (img, "\x58\x5b\x48\xf7\xeb\x50", 6);
+          break;
         case asm_Div:
+          /* POP RBX; POP RAX; XOR RDX, RDX; IDIV RBX; PUSH RAX */
+          x86_emit (img, "\x5b\x58\x48\x31\xd2\x48\xf7\xfb\x50", 9);
+          break;
         case asm_Mod:
+          /* POP RBX; POP RAX; XOR RDX, RDX; IDIV RBX; PUSH RDX */
+          x86_emit (img, "\x5b\x58\x48\x31\xd2\x48\xf7\xfb\x52", 9);
+          break;
+        case asm_Negate:
+          /* POP RAX; NEG RAX; PUSH RAX */
+          x86_emit (img, "\x58\x48\xf7\xd8\x50", 5);
+          break;
         case asm_Eq:
         case asm_Neq:
         case asm_Lss:
         case asm_Gtr:
         case asm_Leq:
         case asm_Geq:
+          /* POP RBX; POP RAX; CMP RAX, RBX; SETcc AL; MOVZX EAX, AL;
+             PUSH RAX */
+          x86_emit (img, "\x5b\x58\x48\x39\xd8\x0f", 6);
+          x86_emit (img, (const char*) &setcc[cmd->cmd - asm_Eq], 1);
+          x86_emit (img, "\xc0\x0f\xb6\xc0\x50", 5);
+          break;
         case asm_And:
+          /* POP RAX; POP RBX; AND RAX, RBX; SETNZ AL; MOVZX EAX, AL;
+             PUSH RAX */
+          x86_emit (img, "\x58\x5b\x48\x21\xd8\x0f\x95\xc0\x0f\xb6\xc0\x50",
+                    12);
+          break;
         case asm_Or:
+          /* POP RAX; POP RBX; OR RAX, RBX; SETNZ AL; MOVZX EAX, AL;
+             PUSH RAX */
+          x86_emit (img, "\x58\x5b\x48\x09\xd8\x0f\x95\xc0\x0f\xb6\xc0\x50",
+                    12);
+          break;
         case asm_Not:
+          /* POP RAX; TEST RAX, RAX; SETZ AL; MOVZX EAX, AL; PUSH RAX */
+          x86_emit (img, "\x58\x48\x85\xc0\x0f\x94\xc0\x0f\xb6\xc0\x50", 11);
+          break;
         case asm_Prts:
         case asm_Input:
+          /* POP RAX; MOV RSI, [strs+8*RAX]; MOV RDX, [lens+8*RAX] */
+          x86_emit (img, "\x58\x48\x8b\x34\xc5", 5);
+          x86_emit_u32 (img, strs_at);
+          x86_emit (img, "\x48\x8b\x14\xc5", 4);
+          x86_emit_u32 (img, lens_at);
+          x86_emit_call (img, X86_RT_WRITE);
+          if (cmd->cmd == asm_Prts)
+            break;
+          x86_emit_call (img, X86_RT_INPUT);
+          x86_emit (img, "\x50", 1);            /* PUSH RAX */
+          break;
         case asm_Prti:
-        case asm_HALT:
-          fprintf (dest_fp, "  %s\n", asm_cmds[asm_cmd_list[i].cmd]);
+          x86_emit (img, "\x58", 1);            /* POP RAX */
+          x86_emit_call (img, X86_RT_PRTI);
           break;
         case asm_Label:
-          fprintf (dest_fp, "%s:\n", asm_cmd_list[i].label);
+          img->label_at[cmd->label] = img->code_len + 1;
           break;
-        case asm_Jz:
         case asm_Jmp:
-          fprintf (dest_fp, "  %s\t\t%s\n", asm_cmds[asm_cmd_list[i].cmd],
-                   asm_cmd_list[i].label);
+          x86_emit_jump (img, "\xe9", 1, cmd->label);
+          break;
+        case asm_Jz:
+          /* POP RAX; TEST RAX, RAX; JZ rel32 */
+          x86_emit_jump (img, "\x58\x48\x85\xc0\x0f\x84", 6, cmd->label);
+          break;
+        case asm_Jnz:
+          /* POP RAX; TEST RAX, RAX; JNZ rel32 */
+          x86_emit_jump (img, "\x58\x48\x85\xc0\x0f\x85", 6, cmd->label);
+          break;
+        case asm_Jeq:
+        case asm_Jneq:
+        case asm_Jlss:
+        case asm_Jgtr:
+        case asm_Jleq:
+        case asm_Jgeq:
+          {
+            /* POP RBX; POP RAX; CMP RAX, RBX; Jcc rel32 */
+            unsigned char op[7] = { 0x5b, 0x58, 0x48, 0x39, 0xd8, 0x0f,
+                setcc[cmd->cmd - asm_Jeq] - 0x10 };
+            x86_emit_jump (img, (const char*) op, 7, cmd->label);
+          }
+          break;
+        case asm_HALT:
+          x86_emit_call (img, X86_RT_HALT);
           break;
         default:
-          logger(ERROR, "Unknown opcode %d\n", asm_cmd_list[i].cmd);
+          logger(ERROR, "Unknown opcode %d\n", cmd->cmd);
           exit (opal_exit (EXIT_FAILURE));
         }
     }
-  _DONE;
 
-  /// Open footer file in 'r' mode
-  sprintf (perror_msg, "footer_fp = fopen('res/footer.asm', 'r')");
+  x86_patch_jumps (img);
+  logger(DEBUG, "Encoded %u code bytes, %u data bytes", img->code_len,
+         img->data_len);
+
+  logger(DEBUG, "=== END ===");
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief       Write x86 image as static ELF64 executable
+ *
+ * @details     The file holds the ELF header, three program headers and the
+ * code in one read-only executable segment at X86_CODE_ADDR, followed by
+ * the data segment at the page aligned offset matching img->data_addr. The
+ * variables and the runtime data take no room in the file.
+ *
+ * @param[in]   img         x86 image encoded with x86_encode()
+ * @param[in]   dest_fn     Destination binary file name
+ *
+ * @return      Function exit code
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      errno           On system call failure
+ */
+short
+gen_elf (x86_image_s *img, char *dest_fn)
+{
+  logger(DEBUG, "=== START ===");
+
+  /// Assert image and destination file name are not null
+  assert(img);
+  assert(dest_fn);
+
+  Elf64_Ehdr ehdr = { 0 };
+  Elf64_Phdr phdr[3] = { { 0 } };
+  uint64_t head = sizeof(ehdr) + sizeof(phdr);
+  uint64_t data_off = (head + img->code_len + X86_PAGE_SIZE - 1)
+      & ~(uint64_t) (X86_PAGE_SIZE - 1);
+
+  memcpy (ehdr.e_ident, ELFMAG, SELFMAG);
+  ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+  ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+  ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+  ehdr.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+  ehdr.e_type = ET_EXEC;
+  ehdr.e_machine = EM_X86_64;
+  ehdr.e_version = EV_CURRENT;
+  ehdr.e_entry = X86_CODE_ADDR + head + sizeof(x86_runtime);
+  ehdr.e_phoff = sizeof(ehdr);
+  ehdr.e_ehsize = sizeof(ehdr);
+  ehdr.e_phentsize = sizeof(Elf64_Phdr);
+  ehdr.e_phnum = 3;
+
+  /// Code, including the headers
+  phdr[0].p_type = PT_LOAD;
+  phdr[0].p_flags = PF_R | PF_X;
+  phdr[0].p_vaddr = phdr[0].p_paddr = X86_CODE_ADDR;
+  phdr[0].p_filesz = phdr[0].p_memsz = head + img->code_len;
+  phdr[0].p_align = X86_PAGE_SIZE;
+
+  /// Strings, then zeroed variables and runtime data
+  phdr[1].p_type = PT_LOAD;
+  phdr[1].p_flags = PF_R | PF_W;
+  phdr[1].p_offset = data_off;
+  phdr[1].p_vaddr = phdr[1].p_paddr = img->data_addr;
+  phdr[1].p_filesz = img->data_len;
+  phdr[1].p_memsz = img->data_len + img->bss_len;
+  phdr[1].p_align = X86_PAGE_SIZE;
+
+  /// Non executable stack
+  phdr[2].p_type = PT_GNU_STACK;
+  phdr[2].p_flags = PF_R | PF_W;
+
+  sprintf (perror_msg, "elf_fp = fopen('%s', 'wb')", dest_fn);
   logger(DEBUG, perror_msg);
-  FILE *footer_fp = NULL;
   errno = EXIT_SUCCESS;
-  footer_fp = fopen ("res/footer.asm", "r");
-  if (errno == EXIT_SUCCESS)
-      _PASS;
+  FILE *elf_fp = fopen (dest_fn, "wb");
+  if (elf_fp)
+    _PASS;
   else
-  {
+    {
       perror (perror_msg);
       _FAIL;
       return (errno);
-  }
-
-  /// Copy contents of footer char by char to dest_fp
-  logger(DEBUG, "Copying contents of footer.asm in print_asm_code()");
-  ch = fgetc (footer_fp);
-  while (ch != EOF)
-  {
-      fputc (ch, dest_fp);
-      ch = fgetc (footer_fp);
-  }
+    }
 
-  /// Close footer file pointer if not NULL
-  sprintf (perror_msg, "fclose(footer_fp)");
+  /// Write headers, code, padding up to the data segment and data
+  uint64_t pad = data_off - head - img->code_len;
+  char *zeros = calloc (pad + 1, 1);
+  short failed = !zeros || fwrite (&ehdr, sizeof(ehdr), 1, elf_fp) != 1
+      || fwrite (phdr, sizeof(phdr), 1, elf_fp) != 1
+      || fwrite (img->code, img->code_len, 1, elf_fp) != 1
+      || (pad && fwrite (zeros, pad, 1, elf_fp) != 1)
+      || (img->data_len && fwrite (img->data, img->data_len, 1, elf_fp) != 1);
+  free (zeros);
+
+  sprintf (perror_msg, "fwrite/fclose(elf_fp)");
   logger(DEBUG, perror_msg);
-  if (footer_fp)
+  if (fclose (elf_fp) != EXIT_SUCCESS || failed)
     {
-      if (fclose (footer_fp) == EXIT_SUCCESS)
-        {
-          _PASS;
-          footer_fp = NULL;
-        }
-      else
-        {
-          perror (perror_msg);
-          _FAIL;
-          return (errno);
-        }
+      perror (perror_msg);
+      _FAIL;
+      return (errno ? errno : EXIT_FAILURE);
     }
+  _PASS;
 
-  /// Create strings and their lengths
-  fprintf (dest_fp, "  ; === Strings ===;\n");
-  for (i = 0; i < strs_len; i++)
+  /// Make the binary executable like ld does
+  sprintf (perror_msg, "chmod('%s', 0755)", dest_fn);
+  logger(DEBUG, perror_msg);
+  if (chmod (dest_fn, 0755) == EXIT_SUCCESS)
+    _PASS;
+  else
     {
-      fprintf (dest_fp, "  msg%d: DB \"", i);
-      /// Read each string character
-      int j = 0;
-      for (j = 0; j < strlen (strs[i]); j++)
-        {
-          ///print ASCII values for newlines
-          if (strs[i][j] == '\\' && strs[i][j + 1] == 'n')
-            {
-              fprintf (dest_fp, "\", 13, 10, \"");
-              j = j + 1;
-            }
+      perror (perror_msg);
+      _FAIL;
+      return (errno);
+    }
 
-          /// directly print all other characters
-          else
-            fprintf (dest_fp, "%c", strs[i][j]);
-        }
+  logger(DEBUG, "=== END ===");
+  return EXIT_SUCCESS;
+}
 
-      /// NULL terminate string
-      fprintf (dest_fp, "\", NULL\n");
+/**
+ * @brief       Free memory used by x86 image
+ *
+ * @param[in]   img         x86 image to free, label_at is owned by asm_arena
+ *
+ * @return      None
+ */
+void
+free_x86_image (x86_image_s *img)
+{
+  free (img->code);
+  free (img->data);
+  free (img->fixups);
+  memset (img, 0, sizeof(x86_image_s));
+}
 
-      /// Print string length
-      fprintf (dest_fp, "  len%d EQU $ - msg%d\n", i, i);
+/**
+ * @brief       Run assembly command list in memory
+ *
+ * @details     The data is mapped below 2 GiB as x86_encode() addresses it
+ * absolutely, the code is copied to its own mapping that is made executable
+ * once written. The program ends the process through HALT or a failed
+ * write, with the same exit code as the executable written by gen_elf(), so
+ * the function only returns on error. Open streams are flushed first.
+ *
+ * @return      Function exit code
+ *
+ * @retval      EXIT_FAILURE    On error
+ * @retval      errno           On system call failure
+ */
+short
+x86_run (void)
+{
+  logger(DEBUG, "=== START ===");
+
+  /// Map zeroed data first, the code depends on its address
+  size_t data_size = x86_data_len () + 8 * vars_len + X86_RT_DATA_SIZE;
+  sprintf (perror_msg, "mmap(%zu, PROT_READ | PROT_WRITE, MAP_32BIT)",
+           data_size);
+  logger(DEBUG, perror_msg);
+  void *data = mmap (NULL, data_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+  if (data == MAP_FAILED)
+    {
+      perror (perror_msg);
+      _FAIL;
+      return (errno);
     }
+  _PASS;
 
-  if (strs_len > 0)
+  x86_image_s image;
+  retVal = x86_encode (&image, (uintptr_t) data);
+  if (retVal != EXIT_SUCCESS)
     {
-      /// Print string array
-      fprintf (dest_fp, "  strs: DQ ");
-      for (i = 0; i < strs_len; i++)
-        {
-          fprintf (dest_fp, "msg%d, ", i);
-        }
-      fprintf (dest_fp, "\n");
+      free_x86_image (&image);
+      munmap (data, data_size);
+      return (retVal);
+    }
+  memcpy (data, image.data, image.data_len);
 
-      /// ...and length array
-      fprintf (dest_fp, "  lens: DQ ");
-      for (i = 0; i < strs_len; i++)
-        {
-          fprintf (dest_fp, "len%d, ", i);
-        }
-      fprintf (dest_fp, "\n");
+  /// Copy code to a writable mapping, then flip it to executable
+  sprintf (perror_msg, "mmap(%u, PROT_READ | PROT_WRITE)", image.code_len);
+  logger(DEBUG, perror_msg);
+  unsigned char *code = mmap (NULL, image.code_len, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (code == MAP_FAILED)
+    {
+      perror (perror_msg);
+      _FAIL;
+      free_x86_image (&image);
+      munmap (data, data_size);
+      return (errno);
     }
+  _PASS;
+  memcpy (code, image.code, image.code_len);
 
-  /// Create integers array
-  if (vars_len > 0)
+  sprintf (perror_msg, "mprotect(code, PROT_READ | PROT_EXEC)");
+  logger(DEBUG, perror_msg);
+  if (mprotect (code, image.code_len, PROT_READ | PROT_EXEC) == EXIT_SUCCESS)
+    _PASS;
+  else
     {
-      logger(DEBUG, "Create data array of length: %d", vars_len);
-      fprintf (dest_fp, "  ; === Integers ===;\n  data  TIMES %d DQ 0\n",
-               vars_len);
+      perror (perror_msg);
+      _FAIL;
+      free_x86_image (&image);
+      munmap (code, image.code_len);
+      munmap (data, data_size);
+      return (errno);
     }
 
-  return EXIT_SUCCESS;
+  /// User code starts after the runtime and never returns
+  void (*entry) (void) = (void (*) (void)) (code + sizeof(x86_runtime));
+  free_x86_image (&image);
+  logger(DEBUG, "Running program at %p", (void*) entry);
+  fflush (NULL);
+  entry ();
+
+  logger(ERROR, "Program returned without HALT");
+  return EXIT_FAILURE;
 }
 
+/*
+ * ==================================
+ * START INTERPRETER FUNCTION DEFINITIONS
+ * ==================================
+ */
+
 /**
- * @brief Print assembly code list to HTML report file
+ * @brief       Encode assembly command list as bytecode
  *
- * @param       cmd_list    Assembly command list to print
- * @param       dest_fp   Destination HTML reportfile pointer
+ * @details     The first pass places the labels and finds the deepest
+ * operand stack, taking the depth at a label from the jumps to it when the
+ * command before it does not fall through. The second pass writes the
+ * opcodes with jumps to code offsets, so the code is position independent.
+ * Both passes take the opcodes from bc_select(), so runs of commands become
+ * superinstructions the same way in each.
+ *
+ * @param[out]  img         Bytecode image, freed with free_bc_image()
  *
  * @return      Function exit code
  *
  * @retval      EXIT_SUCCESS    On success
  * @retval      EXIT_FAILURE    On error
+ * @retval      errno           On system call failure
  */
 short
-print_asm_code_html (asm_cmd_e cmd_list[], FILE *dest_fp)
+bc_encode (bc_image_s *img)
 {
   logger(DEBUG, "=== START ===");
+  assert(img);
+  memset (img, 0, sizeof(bc_image_s));
+  unsigned int i = 0, j = 0, depth = 0, fused = 0;
 
-  fprintf (dest_fp, "<h3>0-address stack machine code by Code generator "
-           "<code>GENIE</code></h3>\n<hr>\n");
-
-  fprintf (dest_fp,
-           "<textarea style='resize: none;' readonly rows='25' cols='80'>");
+  unsigned int *label_at = NULL, label_at_len = 0;
+  unsigned int *label_depth = NULL, label_depth_len = 0;
+  grow_slot_map (&label_at, &label_at_len);
+  grow_slot_map (&label_depth, &label_depth_len);
 
-  int i = 0;
-  logger(DEBUG, "Print ASM user code to HTML");
   for (i = 0; i < asm_cmd_list_len; i++)
     {
-      switch (asm_cmd_list[i].cmd)
+      asm_cmd_e *cmd = &asm_cmd_list[i];
+      if (cmd->cmd == asm_Label)
+        {
+          label_at[cmd->label] = img->code_len;
+          if (label_depth[cmd->label] > depth)
+            depth = label_depth[cmd->label];
+          continue;
+        }
+      if (bc_ops[cmd->cmd] == bc_OpCount)
+        {
+          logger(ERROR, "Unknown opcode %d\n", cmd->cmd);
+          return EXIT_FAILURE;
+        }
+
+      /// Stack effect of the command
+      switch (cmd->cmd)
         {
-        case asm_Fetch:
-        case asm_Store:
         case asm_Push:
-          fprintf (dest_fp, "  %s\t%d\n", asm_cmds[asm_cmd_list[i].cmd],
-                   asm_cmd_list[i].intval);
+        case asm_Fetch:
+          depth++;
           break;
+        case asm_Jeq:
+        case asm_Jneq:
+        case asm_Jlss:
+        case asm_Jgtr:
+        case asm_Jleq:
+        case asm_Jgeq:
+          depth--;
+          /* fall through */
+        case asm_Store:
         case asm_Add:
         case asm_Sub:
-        case asm_Negate:
         case asm_Mul:
         case asm_Div:
         case asm_Mod:
@@ -2636,330 +5868,885 @@ print_asm_code_html (asm_cmd_e cmd_list[], FILE *dest_fp)
         case asm_Geq:
         case asm_And:
         case asm_Or:
-        case asm_Not:
+        case asm_Jz:
+        case asm_Jnz:
         case asm_Prts:
-        case asm_Input:
         case asm_Prti:
-        case asm_HALT:
-          fprintf (dest_fp, "  %s\n", asm_cmds[asm_cmd_list[i].cmd]);
-          break;
-        case asm_Label:
-          fprintf (dest_fp, "%s:\n", asm_cmd_list[i].label);
-          break;
-        case asm_Jz:
-        case asm_Jmp:
-          fprintf (dest_fp, "  %s\t\t%s\n", asm_cmds[asm_cmd_list[i].cmd],
-                   asm_cmd_list[i].label);
+          depth--;
           break;
         default:
-          fprintf(stderr, "Unknown opcode %d\n", asm_cmd_list[i].cmd);
-          exit (opal_exit (EXIT_FAILURE));
+          break;
+        }
+      if (depth > img->stack_max)
+        img->stack_max = depth;
+      if (is_jump (cmd->cmd) && label_depth[cmd->label] < depth)
+        label_depth[cmd->label] = depth;
+      if (cmd->cmd == asm_Jmp || cmd->cmd == asm_HALT)
+        depth = 0;
+
+      /// One opcode for all commands of a superinstruction
+      if (fused == 0)
+        {
+          bc_select (i, &fused);
+          img->code_len += 1;
         }
+      fused--;
+      if (cmd->cmd == asm_Push || cmd->cmd == asm_Fetch
+          || cmd->cmd == asm_Store || cmd->cmd == asm_StoreKeep
+          || is_jump (cmd->cmd))
+        img->code_len += 4;
     }
-  _DONE;
 
-  /// Create strings and their lengths
-  fprintf (dest_fp, "  ; === Strings ===;\n");
+  /// Strings as printed, with their pool offsets and lengths
   for (i = 0; i < strs_len; i++)
+    img->pool_len += strlen (get_interned_str (strs[i])) + 1;
+  img->code = malloc (img->code_len + 1);
+  img->pool = malloc (img->pool_len + 1);
+  img->str_at = malloc ((2 * strs_len + 1) * sizeof(uint32_t));
+  if (!img->code || !img->pool || !img->str_at)
     {
-      fprintf (dest_fp, "  msg%d: DB \"", i);
-      /// Read each string character
-      int j = 0;
-      for (j = 0; j < strlen (strs[i]); j++)
-        {
-          ///print ASCII values for newlines
-          if (strs[i][j] == '\\' && strs[i][j + 1] == 'n')
-            {
-              fprintf (dest_fp, "\", 13, 10, \"");
-              j = j + 1;
-            }
-
-          /// directly print all other characters
-          else
-            fprintf (dest_fp, "%c", strs[i][j]);
-        }
-
-      /// NULL terminate string
-      fprintf (dest_fp, "\", NULL\n");
+      perror ("malloc (bc_image)");
+      return (errno);
+    }
 
-      /// Print string length
-      fprintf (dest_fp, "  len%d EQU $ - msg%d\n", i, i);
+  img->pool_len = 0;
+  for (i = 0; i < strs_len; i++)
+    {
+      img->str_at[2 * i] = img->pool_len;
+      img->str_at[2 * i + 1] = encode_str (img->pool + img->pool_len,
+                                           get_interned_str (strs[i]));
+      img->pool_len += img->str_at[2 * i + 1];
     }
+  img->strs_len = strs_len;
+  img->vars_len = vars_len;
 
-  if (strs_len > 0)
+  unsigned char *out = img->code;
+  for (i = 0; i < asm_cmd_list_len; i++)
     {
-      /// Print string array
-      fprintf (dest_fp, "  strs: DQ ");
-      for (i = 0; i < strs_len; i++)
-        fprintf (dest_fp, "msg%d, ", i);
+      asm_cmd_e *cmd = &asm_cmd_list[i];
+      if (cmd->cmd == asm_Label)
+        continue;
+
+      if (fused == 0)
+        *out++ = bc_select (i, &fused);
+      fused--;
+      uint32_t operand = is_jump (cmd->cmd) ? label_at[cmd->label]
+          : (uint32_t) cmd->intval;
+      if (cmd->cmd == asm_Push || cmd->cmd == asm_Fetch
+          || cmd->cmd == asm_Store || cmd->cmd == asm_StoreKeep
+          || is_jump (cmd->cmd))
+        for (j = 0; j < 4; j++)
+          *out++ = operand >> 8 * j;
+    }
 
-      fprintf (dest_fp, "\n");
+  logger(DEBUG, "Encoded %u bytecode bytes, operand stack of %u",
+         img->code_len, img->stack_max);
+  logger(DEBUG, "=== END ===");
+  return EXIT_SUCCESS;
+}
 
-      /// ...and length array
-      fprintf (dest_fp, "  lens: DQ ");
-      for (i = 0; i < strs_len; i++)
-        fprintf (dest_fp, "len%d, ", i);
+/**
+ * @brief       Select opcode for the commands at an index of asm_cmd_list
+ *
+ * @details     The first superinstruction of bc_super_ops[] matching the
+ * commands is taken, the longest come first. Labels never match, so a
+ * superinstruction is never entered in the middle. With bc_super cleared
+ * the plain opcode of the command is returned.
+ *
+ * @param[in]   at          Index of the first command
+ * @param[out]  len         Number of commands covered by the opcode
+ *
+ * @return      Opcode to write for the commands
+ */
+unsigned char
+bc_select (unsigned int at, unsigned int *len)
+{
+  int k = 0, j = 0;
 
-      fprintf (dest_fp, "\n");
+  for (k = 0; bc_super && k < BC_SUPER_COUNT; k++)
+    {
+      for (j = 0; bc_super_ops[k][j] != bc_OpCount; j++)
+        if (at + j >= asm_cmd_list_len
+            || bc_ops[asm_cmd_list[at + j].cmd] != bc_super_ops[k][j])
+          break;
+      if (bc_super_ops[k][j] == bc_OpCount)
+        {
+          *len = j;
+          return bc_OpCount + k;
+        }
     }
 
-  /// Create integers array
-  if (vars_len > 0)
+  *len = 1;
+  return bc_ops[asm_cmd_list[at].cmd];
+}
+
+/**
+ * @brief       Divide like IDIV with RDX cleared, as O_DIV and O_MOD do
+ *
+ * @details     The dividend is the unsigned 128 bit value RDX:RAX with RDX
+ * zero. IDIV faults when the divisor is zero or the quotient does not fit
+ * 64 signed bits, which for this dividend only happens with divisors 1 and
+ * -1.
+ *
+ * @param[in]   a           Dividend, taken as unsigned
+ * @param[in]   b           Divisor
+ * @param[out]  quot        Quotient
+ * @param[out]  rem         Remainder, never negative
+ *
+ * @return      TRUE on success, FALSE where IDIV faults
+ */
+short
+bc_idiv (uint64_t a, int64_t b, int64_t *quot, int64_t *rem)
+{
+  uint64_t d = b < 0 ? -(uint64_t) b : (uint64_t) b;
+
+  if (d == 0 || (b == 1 && a >> 63) || (b == -1 && a > (uint64_t) 1 << 63))
+    return FALSE;
+
+  *quot = b < 0 ? -(a / d) : a / d;
+  *rem = a % d;
+  return TRUE;
+}
+
+/**
+ * @brief       Write bytes to stdout like the print macros, one system call
+ *
+ * @param[in]   buf         Bytes to write
+ * @param[in]   len         Number of bytes
+ *
+ * @return      Bytes written, negative errno on failure like SYS_WRITE
+ */
+int64_t
+bc_write (const void *buf, uint64_t len)
+{
+  ssize_t written = write (STDOUT_FILENO, buf, len);
+
+  return written < 0 ? -errno : written;
+}
+
+/**
+ * @brief       Print integer like O_PRTI, the sign and the digits
+ *
+ * @param[in]   value       Integer to print
+ *
+ * @return      0 on success, else the exit code of the short write
+ */
+int64_t
+bc_prti (int64_t value)
+{
+  unsigned char digits[32] = { 0 };
+  unsigned char *start = digits + sizeof(digits);
+  uint64_t mag = value;
+  int64_t written = 0;
+
+  if (value < 0)
     {
-      logger(DEBUG, "Create data array of length: %d", vars_len);
-      fprintf (dest_fp, "  ; === Integers ===;\n  data  TIMES %d DQ 0\n",
-               vars_len);
+      if ((written = bc_write ("-", 1)) != 1)
+        return written;
+      mag = -mag;
     }
 
-  fprintf (dest_fp, "</textarea>");
-  logger(DEBUG, "=== END ===");
+  do
+    {
+      *--start = '0' + mag % 10;
+      mag /= 10;
+    }
+  while (mag);
 
-  return EXIT_SUCCESS;
+  uint64_t len = digits + sizeof(digits) - start;
+  if ((written = bc_write (start, len)) != (int64_t) len)
+    return written;
+  return 0;
 }
 
 /**
- * @brief       Get index of an identifier in array, add if missing
+ * @brief       Get next input character like rt_getc
  *
- * @param[in]   ident_curr   identifier to get index for
+ * @details     Reads X86_INPUT_SIZE bytes at a time once those read are
+ * used up, so successive calls are served from memory.
  *
- * @return      index of identifier in the array
+ * @param[in]   in          Input read, kept between calls
+ *
+ * @return      Next character, a newline at the end of input
  */
 int
-add_var (char *ident_curr)
+bc_getc (bc_input_s *in)
 {
-  /// If identifier array is not empty
-  if (vars_len > 0)
+  if (in->pos == in->len)
     {
-      /// Search it for the current identifier
-      int i = 0;
-      for (i = 0; i < vars_len; i++)
-        {
-          /// and return its index if found
-          if (strcmp (ident_curr, vars[i]) == 0)
-            {
-              logger(DEBUG, "Identifier '%s' found at index %d.", ident_curr,
-                     i);
-              return i;
-            }
-        }
+      ssize_t got = read (STDIN_FILENO, in->buf, X86_INPUT_SIZE);
+      if (got <= 0)
+        return '\n';
+      in->pos = 0;
+      in->len = got;
     }
 
-  int index = vars_len;
-  /// Otherwise append the identifier to the array
-  logger(DEBUG, "Created new identifier '%s' at index %d.", ident_curr, index);
-  vars[vars_len++] = strdup (ident_curr);
-
-  /// and return its index
-  return index;
+  return in->buf[in->pos++];
 }
 
 /**
- * @brief       Get index of a string in array, add if missing
+ * @brief       Read integer like _INPUT_
  *
- * @param[in]   str_curr   string to get index for
+ * @details     Converts the next line as the macro does: an optional
+ * leading '-', then digits up to the first other character, wrapping at 64
+ * bits. The rest of the line is skipped.
  *
- * @return      index of string in the array
+ * @param[in]   in          Input read, kept between calls
+ *
+ * @return      Integer read
  */
-int
-add_str (char *str_curr)
+int64_t
+bc_input (bc_input_s *in)
 {
-  /// If string array is not empty
-  if (strs_len > 0)
+  uint64_t value = 0;
+  short first = TRUE, neg = FALSE, digits = TRUE;
+  int c = 0;
+
+  while ((c = bc_getc (in)) != '\n')
     {
-      /// Search it for the current string
-      int i = 0;
-      for (i = 0; i < strs_len; i++)
-        {
-          /// and return its index if found
-          if (strcmp (str_curr, strs[i]) == 0)
-            {
-              logger(DEBUG, "Identifier '%s' found at index %d.", str_curr, i);
-              return i;
-            }
-        }
+      if (first && c == '-')
+        neg = TRUE;
+      else if (digits && isdigit (c))
+        value = value * 10 + (c - '0');
+      else
+        digits = FALSE;
+      first = FALSE;
     }
 
-  int index = strs_len;
-  /// Otherwise append the string to the array
-  logger(DEBUG, "Created new identifier '%s' at index %d.", str_curr, index);
-  strs[strs_len++] = strdup (str_curr);
-
-  /// and return its index
-  return index;
+  return neg ? -value : value;
 }
 
 /**
- * @brief Free vars & strs arrays used for generating assembly code
- * @param NONE
+ * @brief       Run bytecode program
+ *
+ * @details     Dispatches with computed gotos, one indirect jump at the end
+ * of every handler. The handler bodies are BC_DO_ macros taking the offset
+ * of their operand, so the superinstructions of bc_super.h are built from
+ * the same bodies. The operand stack is allocated for the depth found by
+ * bc_encode() and the variables are zeroed like 'data'. Division faults
+ * raise SIGFPE like the native code does.
+ *
+ * @param[in]   img         Bytecode program
+ *
+ * @return      Exit code of the program, that of HALT or of a short write
  */
-short
-free_asm_arrays ()
+int
+bc_run (const bc_image_s *img)
 {
-
-  /// Walk the list of vars & free as needed
-  int i = 0;
-  for (i = 0; i < vars_len; i++)
+  static const void *const dispatch[bc_OpCount + BC_SUPER_COUNT] =
     {
-      if (vars[i])
-        {
-          free (vars[i]);
-          vars[i] = NULL;
-        }
-    }
+      [bc_Halt] = &&do_halt, [bc_Push] = &&do_push, [bc_Fetch] = &&do_fetch,
+      [bc_Store] = &&do_store, [bc_StoreKeep] = &&do_store_keep,
+      [bc_Add] = &&do_add, [bc_Sub] = &&do_sub, [bc_Mul] = &&do_mul,
+      [bc_Div] = &&do_div, [bc_Mod] = &&do_mod, [bc_Negate] = &&do_negate,
+      [bc_Eq] = &&do_eq, [bc_Neq] = &&do_neq, [bc_Lss] = &&do_lss,
+      [bc_Gtr] = &&do_gtr, [bc_Leq] = &&do_leq, [bc_Geq] = &&do_geq,
+      [bc_And] = &&do_and, [bc_Or] = &&do_or, [bc_Not] = &&do_not,
+      [bc_Jmp] = &&do_jmp, [bc_Jz] = &&do_jz, [bc_Jnz] = &&do_jnz,
+      [bc_Jeq] = &&do_jeq, [bc_Jneq] = &&do_jneq, [bc_Jlss] = &&do_jlss,
+      [bc_Jgtr] = &&do_jgtr, [bc_Jleq] = &&do_jleq, [bc_Jgeq] = &&do_jgeq,
+      [bc_Prts] = &&do_prts, [bc_Prti] = &&do_prti, [bc_Input] = &&do_input,
+      BC_SUPER_DISPATCH
+    };
 
-  /// Walk the list of strs & free as needed
-  for (i = 0; i < strs_len; i++)
+/// Dispatch the next opcode
+#define BC_NEXT goto *dispatch[*pc++]
+/// Read the 32 bit operand at the given offset from pc
+#define BC_ARG(o) ((uint32_t) pc[(o)] | (uint32_t) pc[(o) + 1] << 8 \
+    | (uint32_t) pc[(o) + 2] << 16 | (uint32_t) pc[(o) + 3] << 24)
+/// Jump to the operand at the given offset if the condition holds
+#define BC_JUMP_IF(o, cond) \
+  { if (cond) { pc = code + BC_ARG (o); BC_NEXT; } }
+/// Binary operator on the two top entries
+#define BC_BINARY(expr) { sp--; sp[0] = (expr); }
+/// Signed comparison of the two top entries
+#define BC_COMPARE(op) BC_BINARY ((int64_t) sp[0] op (int64_t) sp[1])
+/// Compare and jump with the two top entries
+#define BC_JUMP_CMP(o, op) \
+  { sp -= 2; BC_JUMP_IF (o, (int64_t) sp[1] op (int64_t) sp[2]) }
+#define BC_DO_PUSH(o) { *++sp = (int64_t) (int32_t) BC_ARG (o); }
+#define BC_DO_FETCH(o) { *++sp = vars[BC_ARG (o)]; }
+#define BC_DO_STORE(o) { vars[BC_ARG (o)] = *sp--; }
+#define BC_DO_STOREKEEP(o) { vars[BC_ARG (o)] = *sp; }
+#define BC_DO_ADD(o) BC_BINARY (sp[0] + sp[1])
+#define BC_DO_SUB(o) BC_BINARY (sp[0] - sp[1])
+#define BC_DO_MUL(o) BC_BINARY (sp[0] * sp[1])
+#define BC_DO_DIV(o) \
+  { sp--; if (!bc_idiv (sp[0], sp[1], &quot, &rem)) goto fault; sp[0] = quot; }
+#define BC_DO_MOD(o) \
+  { sp--; if (!bc_idiv (sp[0], sp[1], &quot, &rem)) goto fault; sp[0] = rem; }
+#define BC_DO_NEGATE(o) { sp[0] = -sp[0]; }
+#define BC_DO_EQ(o) BC_BINARY (sp[0] == sp[1])
+#define BC_DO_NEQ(o) BC_BINARY (sp[0] != sp[1])
+#define BC_DO_LSS(o) BC_COMPARE (<)
+#define BC_DO_GTR(o) BC_COMPARE (>)
+#define BC_DO_LEQ(o) BC_COMPARE (<=)
+#define BC_DO_GEQ(o) BC_COMPARE (>=)
+#define BC_DO_AND(o) BC_BINARY ((sp[0] & sp[1]) != 0)
+#define BC_DO_OR(o) BC_BINARY ((sp[0] | sp[1]) != 0)
+#define BC_DO_NOT(o) { sp[0] = !sp[0]; }
+#define BC_DO_JMP(o) BC_JUMP_IF (o, TRUE)
+#define BC_DO_JZ(o) { sp--; BC_JUMP_IF (o, !sp[1]) }
+#define BC_DO_JNZ(o) { sp--; BC_JUMP_IF (o, sp[1]) }
+#define BC_DO_JEQ(o) BC_JUMP_CMP (o, ==)
+#define BC_DO_JNEQ(o) BC_JUMP_CMP (o, !=)
+#define BC_DO_JLSS(o) BC_JUMP_CMP (o, <)
+#define BC_DO_JGTR(o) BC_JUMP_CMP (o, >)
+#define BC_DO_JLEQ(o) BC_JUMP_CMP (o, <=)
+#define BC_DO_JGEQ(o) BC_JUMP_CMP (o, >=)
+
+  logger(DEBUG, "=== START ===");
+  assert(img);
+
+  const unsigned char *code = img->code, *pc = code;
+  bc_input_s input = { 0 };
+  int64_t quot = 0, rem = 0, status = 0;
+
+  /// Stack entries are unsigned so arithmetic wraps like the registers do
+  uint64_t *stack = malloc (((size_t) img->stack_max + 1) * sizeof(uint64_t));
+  uint64_t *vars = calloc ((size_t) img->vars_len + 1, sizeof(uint64_t));
+  if (!stack || !vars)
     {
-      if (strs[i])
-        {
-          free (strs[i]);
-          strs[i] = NULL;
-        }
+      perror ("malloc (bc_run)");
+      free (stack);
+      free (vars);
+      return (errno);
     }
+  uint64_t *sp = stack - 1;
+
+  BC_NEXT;
+
+do_push:
+  BC_DO_PUSH (0)
+  pc += 4;
+  BC_NEXT;
+do_fetch:
+  BC_DO_FETCH (0)
+  pc += 4;
+  BC_NEXT;
+do_store:
+  BC_DO_STORE (0)
+  pc += 4;
+  BC_NEXT;
+do_store_keep:
+  BC_DO_STOREKEEP (0)
+  pc += 4;
+  BC_NEXT;
+do_add:
+  BC_DO_ADD (0)
+  BC_NEXT;
+do_sub:
+  BC_DO_SUB (0)
+  BC_NEXT;
+do_mul:
+  BC_DO_MUL (0)
+  BC_NEXT;
+do_div:
+  BC_DO_DIV (0)
+  BC_NEXT;
+do_mod:
+  BC_DO_MOD (0)
+  BC_NEXT;
+do_negate:
+  BC_DO_NEGATE (0)
+  BC_NEXT;
+do_eq:
+  BC_DO_EQ (0)
+  BC_NEXT;
+do_neq:
+  BC_DO_NEQ (0)
+  BC_NEXT;
+do_lss:
+  BC_DO_LSS (0)
+  BC_NEXT;
+do_gtr:
+  BC_DO_GTR (0)
+  BC_NEXT;
+do_leq:
+  BC_DO_LEQ (0)
+  BC_NEXT;
+do_geq:
+  BC_DO_GEQ (0)
+  BC_NEXT;
+do_and:
+  BC_DO_AND (0)
+  BC_NEXT;
+do_or:
+  BC_DO_OR (0)
+  BC_NEXT;
+do_not:
+  BC_DO_NOT (0)
+  BC_NEXT;
+do_jmp:
+  BC_DO_JMP (0)
+do_jz:
+  BC_DO_JZ (0)
+  pc += 4;
+  BC_NEXT;
+do_jnz:
+  BC_DO_JNZ (0)
+  pc += 4;
+  BC_NEXT;
+do_jeq:
+  BC_DO_JEQ (0)
+  pc += 4;
+  BC_NEXT;
+do_jneq:
+  BC_DO_JNEQ (0)
+  pc += 4;
+  BC_NEXT;
+do_jlss:
+  BC_DO_JLSS (0)
+  pc += 4;
+  BC_NEXT;
+do_jgtr:
+  BC_DO_JGTR (0)
+  pc += 4;
+  BC_NEXT;
+do_jleq:
+  BC_DO_JLEQ (0)
+  pc += 4;
+  BC_NEXT;
+do_jgeq:
+  BC_DO_JGEQ (0)
+  pc += 4;
+  BC_NEXT;
+do_prts:
+do_input:
+  status = bc_write (img->pool + img->str_at[2 * sp[0]],
+                     img->str_at[2 * sp[0] + 1]);
+  if (status != img->str_at[2 * sp[0] + 1])
+    goto done;
+  if (pc[-1] == bc_Prts)
+    sp--;
+  else
+    sp[0] = bc_input (&input);
+  BC_NEXT;
+do_prti:
+  if ((status = bc_prti (*sp--)) != 0)
+    goto done;
+  BC_NEXT;
+do_halt:
+  status = 0;
+  goto done;
+
+  /// Superinstructions, pc past their operands unless they jumped
+  BC_SUPER_HANDLERS
+
+fault:
+  logger(DEBUG, "Division fault, raising SIGFPE");
+  fflush (NULL);
+  raise (SIGFPE);
+  status = EXIT_FAILURE;
+
+done:
+#undef BC_NEXT
+#undef BC_ARG
+#undef BC_JUMP_IF
+#undef BC_BINARY
+#undef BC_COMPARE
+#undef BC_JUMP_CMP
+#undef BC_DO_PUSH
+#undef BC_DO_FETCH
+#undef BC_DO_STORE
+#undef BC_DO_STOREKEEP
+#undef BC_DO_ADD
+#undef BC_DO_SUB
+#undef BC_DO_MUL
+#undef BC_DO_DIV
+#undef BC_DO_MOD
+#undef BC_DO_NEGATE
+#undef BC_DO_EQ
+#undef BC_DO_NEQ
+#undef BC_DO_LSS
+#undef BC_DO_GTR
+#undef BC_DO_LEQ
+#undef BC_DO_GEQ
+#undef BC_DO_AND
+#undef BC_DO_OR
+#undef BC_DO_NOT
+#undef BC_DO_JMP
+#undef BC_DO_JZ
+#undef BC_DO_JNZ
+#undef BC_DO_JEQ
+#undef BC_DO_JNEQ
+#undef BC_DO_JLSS
+#undef BC_DO_JGTR
+#undef BC_DO_JLEQ
+#undef BC_DO_JGEQ
+  free (stack);
+  free (vars);
+  logger(DEBUG, "Program exit code: %ld", (long) status);
+  logger(DEBUG, "=== END ===");
+  return status;
+}
 
-  /// Walk the list of ASM commands & free as needed
-  for (i = 0; i < asm_cmd_list_len; i++)
+/**
+ * @brief       Write bytecode image as bytecode file
+ *
+ * @param[in]   img         Bytecode image
+ * @param[in]   dest_fp     Destination file pointer, opened in 'wb' mode
+ *
+ * @return      Function exit code
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      errno           On system call failure
+ */
+short
+write_opb (const bc_image_s *img, FILE *dest_fp)
+{
+  logger(DEBUG, "=== START ===");
+  assert(img);
+  assert(dest_fp);
+
+  opb_header_s head = { OPB_MAGIC, OPB_VERSION };
+  head.str_at_off = sizeof(opb_header_s);
+  head.strs_len = img->strs_len;
+  head.pool_off = head.str_at_off + 2 * img->strs_len * sizeof(uint32_t);
+  head.pool_len = img->pool_len;
+  head.code_off = head.pool_off + img->pool_len;
+  head.code_len = img->code_len;
+  head.vars_len = img->vars_len;
+  head.stack_max = img->stack_max;
+  head.ops_id = BC_SUPER_ID;
+
+  sprintf (perror_msg, "fwrite(dest_fp)");
+  logger(DEBUG, perror_msg);
+  errno = EXIT_SUCCESS;
+  if (fwrite (&head, sizeof(head), 1, dest_fp) != 1
+      || fwrite (img->str_at, sizeof(uint32_t), 2 * img->strs_len, dest_fp)
+          != 2 * img->strs_len
+      || fwrite (img->pool, 1, img->pool_len, dest_fp) != img->pool_len
+      || fwrite (img->code, 1, img->code_len, dest_fp) != img->code_len)
     {
-      if (asm_cmd_list[i].label)
-        {
-          free (asm_cmd_list[i].label);
-          asm_cmd_list[i].label = NULL;
-        }
+      perror (perror_msg);
+      _FAIL;
+      return (errno ? errno : EXIT_FAILURE);
     }
+  _PASS;
 
+  logger(DEBUG, "=== END ===");
   return EXIT_SUCCESS;
 }
 
-/*
- * ==================================
- * START ORCHESTRATOR FUNCTION DEFINITIONS
- * ==================================
- */
-
 /**
- * @brief          Assemble object file using NASM
- * @param asm_fn   Assembly source file name
- * @param obj_fn   Object destination file name
+ * @brief       Map bytecode file as bytecode image
+ *
+ * @details     The image points into the read-only mapping, nothing is
+ * copied or relocated. The header and the string table are checked to stay
+ * within the file, and the code is checked by bc_verify() as bc_run() runs
+ * it without checks.
+ *
+ * @param[in]   opb_fn      Bytecode file name
+ * @param[out]  img         Bytecode image, freed with free_bc_image()
+ *
+ * @return      Function exit code
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    On invalid file
+ * @retval      errno           On system call failure
  */
 short
-gen_obj (char *asm_fn, char *obj_fn)
+map_opb (const char *opb_fn, bc_image_s *img)
 {
-    logger(DEBUG, "=== START ===");
-    /// Assert assembly file name is not null
-    assert(asm_fn);
-    /// Assert object file name is not null
-    assert(obj_fn);
-    /// Check if asm_fn can be read
-    sprintf(perror_msg, "access (%s, R_OK)", asm_fn);
-    logger(DEBUG, perror_msg);
-    errno = EXIT_SUCCESS;
-    if (access (asm_fn, R_OK) == EXIT_SUCCESS)
+  logger(DEBUG, "=== START ===");
+  assert(opb_fn);
+  assert(img);
+  memset (img, 0, sizeof(bc_image_s));
+
+  sprintf (perror_msg, "open('%s', O_RDONLY)", opb_fn);
+  logger(DEBUG, perror_msg);
+  int fd = open (opb_fn, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat (fd, &st) != EXIT_SUCCESS)
     {
-        _PASS;
-        /// Create the NASM call with -g, -f and -o flags
-        logger(DEBUG, "Calling NASM to assemble object.");
-        char nasm_cmd[1024] = { 0 };
-        sprintf (nasm_cmd, "nasm -g -f elf64 -o %s %s", obj_fn, asm_fn);
-        logger(DEBUG, nasm_cmd);
-        int sys_call = system (nasm_cmd);
-        if (sys_call == EXIT_SUCCESS)
-        {
-            _PASS;
-            /// Check if obj_fn can be read
-            sprintf (perror_msg, "access (%s, R_OK)", obj_fn);
-            logger(DEBUG, perror_msg);
-            errno = EXIT_SUCCESS;
-            if (access (obj_fn, R_OK) == EXIT_SUCCESS)
-                _PASS;
-            else
-            {
-                perror (perror_msg);
-                _FAIL;
-                return (errno);
-            }
-        }
-        else
-        {
-            perror (nasm_cmd);
-            _FAIL;
-            return (sys_call);
-        }
+      int err = errno;
+      perror (perror_msg);
+      _FAIL;
+      if (fd >= 0)
+        close (fd);
+      return (err);
     }
-    else
+  _PASS;
+
+  if ((size_t) st.st_size < sizeof(opb_header_s))
     {
-        perror (perror_msg);
-        _FAIL;
-        return (errno);
+      logger(ERROR, "'%s' is too short for a bytecode file", opb_fn);
+      close (fd);
+      return EXIT_FAILURE;
     }
-    logger(DEBUG, "=== END ===");
-    return EXIT_SUCCESS;
-}
 
+  sprintf (perror_msg, "mmap('%s', PROT_READ)", opb_fn);
+  logger(DEBUG, perror_msg);
+  void *map = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    {
+      perror (perror_msg);
+      _FAIL;
+      return (errno);
+    }
+  _PASS;
+  img->map = map;
+  img->map_len = st.st_size;
+
+  /// Check the sections stay within the file, in 64 bits against overflow
+  const opb_header_s *head = map;
+  uint64_t size = st.st_size;
+  if (memcmp (head->magic, OPB_MAGIC, sizeof(head->magic)) != 0
+      || head->version != OPB_VERSION || head->ops_id != BC_SUPER_ID
+      || head->str_at_off % sizeof(uint32_t)
+      || head->str_at_off + 8 * (uint64_t) head->strs_len > size
+      || head->pool_off + (uint64_t) head->pool_len > size
+      || head->code_off + (uint64_t) head->code_len > size
+      || head->code_len == 0)
+    {
+      logger(ERROR, "'%s' is not a version %d bytecode file of this build",
+             opb_fn, OPB_VERSION);
+      free_bc_image (img);
+      return EXIT_FAILURE;
+    }
+
+  img->code = (unsigned char*) map + head->code_off;
+  img->code_len = head->code_len;
+  img->pool = (unsigned char*) map + head->pool_off;
+  img->pool_len = head->pool_len;
+  img->str_at = (uint32_t*) ((unsigned char*) map + head->str_at_off);
+  img->strs_len = head->strs_len;
+  img->vars_len = head->vars_len;
+  img->stack_max = head->stack_max;
+
+  uint32_t i = 0;
+  for (i = 0; i < img->strs_len; i++)
+    if (img->str_at[2 * i] + (uint64_t) img->str_at[2 * i + 1]
+        > img->pool_len)
+      {
+        logger(ERROR, "String %u of '%s' is outside the pool", i, opb_fn);
+        free_bc_image (img);
+        return EXIT_FAILURE;
+      }
+
+  short status = bc_verify (img);
+  if (status != EXIT_SUCCESS)
+    {
+      logger(ERROR, "'%s' has invalid code", opb_fn);
+      free_bc_image (img);
+      return status;
+    }
+
+  logger(DEBUG, "=== END ===");
+  return EXIT_SUCCESS;
+}
 
 /**
- * @brief           Link object using LD
- * @param obj_fn    Source object file name
- * @param dest_fn   Destination binary file name
+ * @brief       Verify bytecode before bc_run() runs it unchecked
+ *
+ * @details     The code is walked twice from the start, one opcode and the
+ * operands of the opcodes it fuses at a time. The first walk checks the
+ * opcodes, the operands to stay within the code and the variable indexes
+ * within vars_len, and marks the opcode boundaries and the jump targets,
+ * which must be boundaries. The last opcode must halt or jump. The second
+ * walk follows the operand stack depth, which must be the same on every
+ * path to an opcode, never below what the opcode takes and never above
+ * stack_max. Prts and Input must take a string pushed right before them.
+ * Code no jump reaches after a halt or jump starts with an empty stack, as
+ * in bc_encode(). vars_len and stack_max are bound by the code length, so
+ * bc_run() never allocates more than a few times the file size.
+ *
+ * @param[in]   img         Bytecode image
+ *
+ * @return      Function exit code
+ *
+ * @retval      EXIT_SUCCESS    On valid code
+ * @retval      EXIT_FAILURE    On invalid code
+ * @retval      errno           On system call failure
  */
 short
-gen_bin (char *obj_fn, char *dest_fn)
+bc_verify (const bc_image_s *img)
 {
   logger(DEBUG, "=== START ===");
+  assert(img);
 
-  /// Assert object file name is not null
-  assert(obj_fn);
-
-  /// Assert destination file name is not null
-  assert(dest_fn);
-
-  /// Call to linker
-  logger(DEBUG, "Calling LD to link object.");
-  char LD_cmd[1024] = { 0 };
-  sprintf(LD_cmd, "ld -m elf_x86_64 -o %s -lc -I/lib64/ld-linux-x86-64.so.2 %s", dest_fn, obj_fn);
-
-  /// Confirm obj_fn can be read
-  logger(DEBUG, "access(obj_fn, R_OK)");
-  errno = EXIT_SUCCESS;
-  if (access(obj_fn, R_OK) == 0)
+  /// BC_AT_OP and BC_AT_TARGET marks, and the depth + 1 jumps bring along
+  unsigned char *mark = calloc ((size_t) img->code_len + 1, 1);
+  uint32_t *depth_at = calloc ((size_t) img->code_len + 1, sizeof(uint32_t));
+  if (!mark || !depth_at)
     {
+      perror ("calloc (bc_verify)");
+      free (mark);
+      free (depth_at);
+      return (errno);
+    }
 
-      /// Use LD to link the obj_fn contents
-      logger(DEBUG, "ld -m elf_x86_64 -o %s -lc -I/lib64/ld-linux-x86-64.so.2 %s", dest_fn, obj_fn);
-      errno = EXIT_SUCCESS;
-      int sys_call = system(LD_cmd);
+  const unsigned char *code = img->code, *ops = NULL;
+  unsigned char one[2] = { bc_Halt, bc_OpCount };
+  const char *error = NULL;
+  uint64_t at = 0;
+  uint32_t pc = 0, next = 0, arg = 0, depth = 0, take = 0, leave = 0;
+  uint32_t str = UINT32_MAX, pushed = UINT32_MAX;
+  short falls = TRUE;
+  int pass = 0, j = 0;
+
+  /// Every variable and stack entry takes at least one byte of code
+  if (img->vars_len > img->code_len || img->stack_max > img->code_len)
+    error = "More variables or stack entries than code";
+
+  for (pass = 0; pass < 2 && !error; pass++)
+    for (pc = 0, depth = 0, falls = TRUE; pc < img->code_len; pc = next)
+      {
+        if (code[pc] >= bc_OpCount + BC_SUPER_COUNT)
+          {
+            error = "Unknown opcode";
+            break;
+          }
+        one[0] = code[pc];
+        ops = code[pc] < bc_OpCount ? one
+            : bc_super_ops[code[pc] - bc_OpCount];
+
+        /// Depth at the opcode, from the code before or the jumps to it
+        if (pass == 0)
+          mark[pc] |= BC_AT_OP;
+        else if (mark[pc] & BC_AT_TARGET)
+          {
+            if (!falls)
+              depth = depth_at[pc] ? depth_at[pc] - 1 : 0;
+            else if (depth_at[pc] && depth_at[pc] != depth + 1)
+              error = "Jumps and code before disagree on the stack";
+            depth_at[pc] = depth + 1;
+            str = UINT32_MAX;
+          }
+        else if (!falls)
+          depth = 0, str = UINT32_MAX;
 
-      /// Confirm successful linking
-      if (sys_call == 0)
-        {
-          /// Confirm dest_fn can be read to and executed
-          logger(DEBUG, "access(obj_fn, R_OK) && access(obj_fn, X_OK)");
-          errno = EXIT_SUCCESS;
-          if ((access(dest_fn, R_OK) == 0) && (access(dest_fn, X_OK) == 0))
-            _PASS;
+        for (j = 0, at = pc + 1; ops[j] != bc_OpCount && !error; j++)
+          {
+            if (ops[j] == bc_Push || ops[j] == bc_Fetch || ops[j] == bc_Store
+                || ops[j] == bc_StoreKeep
+                || (ops[j] >= bc_Jmp && ops[j] <= bc_Jgeq))
+              {
+                if (at + 4 > img->code_len)
+                  {
+                    error = "Operand past the end of the code";
+                    break;
+                  }
+                arg = code[at] | code[at + 1] << 8 | code[at + 2] << 16
+                    | (uint32_t) code[at + 3] << 24;
+                at += 4;
+              }
 
-            /// Return errno if missing permissions on dest_fn
-          else
-            {
-              perror("access(obj_fn, R_OK) && access(obj_fn, X_OK)");
-              return errno;
-            }
-        }
+            if (pass == 0)
+              {
+                if ((ops[j] == bc_Fetch || ops[j] == bc_Store
+                     || ops[j] == bc_StoreKeep) && arg >= img->vars_len)
+                  error = "Variable index past vars_len";
+                else if (ops[j] >= bc_Jmp && ops[j] <= bc_Jgeq)
+                  {
+                    if (arg >= img->code_len)
+                      error = "Jump past the end of the code";
+                    else
+                      mark[arg] |= BC_AT_TARGET;
+                  }
+                continue;
+              }
 
-      /// ...or log command if unsuccessful
-      else{
-        perror(LD_cmd);
-        return sys_call;
+            /// Operand stack entries taken and left by the command
+            pushed = str;
+            str = UINT32_MAX;
+            switch (ops[j])
+              {
+              case bc_Push:
+                str = arg;
+                /* fall through */
+              case bc_Fetch:
+                take = 0, leave = 1;
+                break;
+              case bc_Prts:
+              case bc_Input:
+                if (pushed >= img->strs_len)
+                  error = "No string pushed to print";
+                take = 1, leave = ops[j] == bc_Input;
+                break;
+              case bc_StoreKeep:
+              case bc_Negate:
+              case bc_Not:
+                take = 1, leave = 1;
+                break;
+              case bc_Store:
+              case bc_Jz:
+              case bc_Jnz:
+              case bc_Prti:
+                take = 1, leave = 0;
+                break;
+              case bc_Jeq:
+              case bc_Jneq:
+              case bc_Jlss:
+              case bc_Jgtr:
+              case bc_Jleq:
+              case bc_Jgeq:
+                take = 2, leave = 0;
+                break;
+              case bc_Halt:
+              case bc_Jmp:
+                take = 0, leave = 0;
+                break;
+              default:
+                take = 2, leave = 1;
+                break;
+              }
+            if (depth < take)
+              error = "Operand stack underflow";
+            else if ((depth = depth - take + leave) > img->stack_max)
+              error = "Operand stack deeper than stack_max";
+            else if (ops[j] >= bc_Jmp && ops[j] <= bc_Jgeq)
+              {
+                if (depth_at[arg] && depth_at[arg] != depth + 1)
+                  error = "Jumps disagree on the stack";
+                depth_at[arg] = depth + 1;
+              }
+            if (ops[j] == bc_Halt || ops[j] == bc_Jmp)
+              depth = 0;
+          }
+        if (error)
+          break;
+        falls = ops[j - 1] != bc_Halt && ops[j - 1] != bc_Jmp;
+        next = at;
       }
-    }
 
-  /// ...or missing read permission on obj_fn
-  else
+  if (!error && falls)
+    error = "Code runs past its end";
+  for (at = 0; !error && at < img->code_len; at++)
+    if ((mark[at] & BC_AT_TARGET) && !(mark[at] & BC_AT_OP))
+      error = "Jump into the middle of an opcode", pc = at;
+  free (mark);
+  free (depth_at);
+  if (error)
     {
-      perror("access(obj_fn, R_OK)");
-      return errno;
+      logger(ERROR, "%s at code offset %u", error, pc);
+      return EXIT_FAILURE;
     }
 
   logger(DEBUG, "=== END ===");
-
   return EXIT_SUCCESS;
 }
+
+/**
+ * @brief       Free memory used by bytecode image
+ *
+ * @param[in]   img         Bytecode image to free, built by bc_encode() or
+ *                          mapped by map_opb()
+ *
+ * @return      None
+ */
+void
+free_bc_image (bc_image_s *img)
+{
+  if (img->map)
+    munmap (img->map, img->map_len);
+  else
+    {
+      free (img->code);
+      free (img->pool);
+      free (img->str_at);
+    }
+  memset (img, 0, sizeof(bc_image_s));
+}
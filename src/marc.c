@@ -88,7 +88,7 @@ static struct argp argp =
 
 /**
  * @brief       Main function for pre-processor marc
- * @details     Calls the function remove_comments() and proc_includes()
+ * @details     Calls the function marc_preprocess()
  * to process the user input file and writes to the destination.
  *
  * @param[in]   argc    Number of command line arguments
@@ -159,19 +159,10 @@ main (int argc, char **argv)
       return (errno);
     }
 
-  /// Open source file in read-only mode
-  sprintf (perror_msg, "source_fp = fopen('%s', 'r')", source_fn);
-  logger (DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  source_fp = fopen (source_fn, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
+  /// Read source file into memory
+  retVal = read_file (source_fn, &source_buf);
+  if (retVal != EXIT_SUCCESS)
+    return (opal_exit (retVal));
 
   /// If destination is file
   if (dest_fn)
@@ -219,140 +210,16 @@ main (int argc, char **argv)
       dest_fp = stdout;
     }
 
-  /// Create and open temp destination file for remove_comments()
-  char *rc_tmp = "tmp/marc_rc.tmp";
-  logger (DEBUG, "rc_tmp: '%s'", rc_tmp);
-
-  /// If temp file can not be written, print error and exit
-  sprintf (perror_msg, "rc_fp = fopen('%s', 'wb')", rc_tmp);
-  logger (DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  FILE *rc_fp = fopen (rc_tmp, "wb");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Remove comments from source with rem_comments(), write to rc_tmp
-  retVal = rem_comments (source_fp, rc_fp);
-  if (retVal != EXIT_SUCCESS)
-      return (opal_exit (retVal));
-
-  /// Close rem_comments temp file pointer rc_fp if not NULL
-  sprintf (perror_msg, "fclose(rc_fp)");
-  logger (DEBUG, perror_msg);
-  if (rc_fp)
-    {
-      if (fclose (rc_fp) == EXIT_SUCCESS)
-        _PASS;
-      else
-        {
-          _FAIL;
-          perror (perror_msg);
-          return (errno);
-        }
-    }
-
-  /// Open rem_comments temp file in read mode, else print error and exit
-  sprintf (perror_msg, "rc_fp = fopen('%s', 'r')", rc_tmp);
-  logger (DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  rc_fp = fopen (rc_tmp, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Create and open temp destination file for proc_includes()
-  char *pi_tmp = "tmp/marc_pi.tmp";
-  logger (DEBUG, "pi_tmp: '%s'", pi_tmp);
-
-  /// If temp file can not be written, print error and exit
-  sprintf (perror_msg, "pi_fp = fopen('%s', 'wb')", pi_tmp);
-  logger (DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  FILE *pi_fp = fopen (pi_tmp, "wb");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Process #include directives from source with proc_includes()
-  retVal = proc_includes (rc_fp, pi_fp);
-  if (retVal != EXIT_SUCCESS)
-    {
-      return (opal_exit (retVal));
-    }
-
-  /// Close rem_comments temp file pointer if not NULL
-  if (rc_fp)
-    {
-      sprintf (perror_msg, "fclose(rc_fp)");
-      logger (DEBUG, perror_msg);
-
-      if (fclose (rc_fp) == EXIT_SUCCESS)
-        _PASS;
-      else
-        {
-          _FAIL;
-          perror (perror_msg);
-          return (errno);
-        }
-    }
-
-  /// Close proc_includes temp file pointer if not NULL
-  if (pi_fp)
-    {
-      sprintf (perror_msg, "fclose(pi_fp)");
-      logger (DEBUG, perror_msg);
-
-      if (fclose (pi_fp) == EXIT_SUCCESS)
-        _PASS;
-      else
-        {
-          _FAIL;
-          perror (perror_msg);
-          return (errno);
-        }
-    }
-
-  /// Open proc_includes temp file in read mode, else print error and exit
-  sprintf (perror_msg, "pi_fp = fopen('%s', 'r')", pi_tmp);
-  logger (DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  pi_fp = fopen (pi_tmp, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      _FAIL;
-      perror (perror_msg);
-      return (errno);
-    }
-
-  /// Remove comments included file with rem_comments(), write to destination
-  retVal = rem_comments (pi_fp, dest_fp);
+  /// Remove comments and process #include directives with marc_preprocess()
+  retVal = marc_preprocess (&source_buf, &marc_buf);
   if (retVal != EXIT_SUCCESS)
-    {
-      return (opal_exit (retVal));
-    }
+    return (opal_exit (retVal));
 
-  /// Close proc_includes temp file pointer
-  sprintf (perror_msg, "fclose(pi_fp)");
+  /// Write pre-processed source to destination
+  sprintf (perror_msg, "fwrite(marc_buf, dest_fp)");
   logger (DEBUG, perror_msg);
-  if (fclose (pi_fp) == EXIT_SUCCESS)
+  if (fwrite (marc_buf.data, sizeof(char), marc_buf.len, dest_fp)
+      == marc_buf.len)
     _PASS;
   else
     {
@@ -361,7 +228,6 @@ main (int argc, char **argv)
       return (errno);
     }
 
-  /// source_fp and dest_fp closed by opal_exit()
+  /// dest_fp closed by opal_exit()
   return (opal_exit (EXIT_SUCCESS));
 }
-
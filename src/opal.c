@@ -33,6 +33,18 @@ static struct argp_option options[] =       ///< The options we understand
   {
     { "debug", 'd', 0, 0, "Log debug messages" },
     { "quiet", 'q', 0, 0, "Quiet; do not write anything to standard output."},
+    { "backend", 'b', "NAME", 0,
+        "Generate code with backend NAME, 'stack' (default), 'regs' or "
+        "'c'" },
+    { "pin-vars", 'p', 0, 0, "Keep the most used variables in registers" },
+    { "nasm", 'n', 0, 0,
+        "Assemble and link with NASM and ld instead of the built-in encoder" },
+    { "run", 'x', 0, 0,
+        "Run the program in memory instead of writing an executable" },
+    { "interpret", 'i', 0, 0,
+        "Run the program with the bytecode interpreter" },
+    { "no-super", 's', 0, 0,
+        "Interpret without superinstructions, one opcode per command" },
     { "log", 'l', "FILE", 0, "Save log to FILE instead of 'log/oc_log'" },
     { "output", 'o', "FILE", 0, "Output to FILE instead of 'a.out'" },
     { "report", 'r', "FILE", 0,
@@ -73,6 +85,35 @@ parse_opt (int key, char *arg, struct argp_state *state)
       arguments->quiet = true;
       break;
 
+    case 'b':
+      for (asm_backend = 0; asm_backend < sizeof(asm_backends)
+          / sizeof(asm_backends[0]); asm_backend++)
+        if (strcmp (arg, asm_backends[asm_backend]) == 0)
+          break;
+      if (asm_backend == sizeof(asm_backends) / sizeof(asm_backends[0]))
+        argp_error (state, "unknown backend '%s'", arg);
+      break;
+
+    case 'p':
+      pin_vars = TRUE;
+      break;
+
+    case 'n':
+      use_nasm = TRUE;
+      break;
+
+    case 'x':
+      run_jit = TRUE;
+      break;
+
+    case 'i':
+      run_bc = TRUE;
+      break;
+
+    case 's':
+      bc_super = FALSE;
+      break;
+
     case 'l':
       arguments->logfile = arg;
       break;
@@ -94,6 +135,13 @@ parse_opt (int key, char *arg, struct argp_state *state)
     case ARGP_KEY_END:
       if (state->arg_num < 1)       // Not enough arguments
         argp_usage (state);
+      if (run_jit && (use_nasm || asm_backend == backend_Regs))
+        argp_error (state, "--run needs the built-in encoder and stack backend");
+      if (run_jit && run_bc)
+        argp_error (state, "--run and --interpret can not be combined");
+      if (asm_backend == backend_C && (run_jit || run_bc || use_nasm))
+        argp_error (state, "--backend=c can not be combined with --run, "
+                    "--interpret or --nasm");
       break;
 
     default:
@@ -107,12 +155,16 @@ static struct argp argp = { options, parse_opt, args_doc, doc };
 /**
  * @brief       Main function for opal - OPaL compiler
  * @details
- * 1. Calls the remove_comments() and proc_includes() to process source file.
+ * 1. Calls marc_preprocess() to process source file in memory.
  * 2. Calls the build_symbol_table() to build symbol table.
  * 3. Calls build_syntax_tree() to build the abstract syntax tree.
  * 4. Calls gen_asm() to build the assembly code table and write to destination.
- * 5. Calls gen_obj() to assemble object file using NASM.
- * 6. Calls gen_bin() to link binary file using ld.
+ * 5. Calls x86_encode() and gen_elf() to write the executable, or with
+ *    --nasm gen_obj() to assemble object file using NASM and gen_bin() to
+ *    link binary file using ld. With --run x86_run() runs the program in
+ *    memory instead, with --interpret bc_encode() and bc_run() interpret it.
+ *    With --backend=c print_c_code() writes C source instead and gen_c_bin()
+ *    compiles it with gcc.
  *
  * @param[in]   argc    Number of command line arguments
  * @param[in]   argv    Vector of individual command line argument strings
@@ -144,6 +196,10 @@ main (int argc, char **argv)
           strdup (arguments.report) : strdup ("report/oc_report.html");
   bool quiet = arguments.quiet;
 
+  /// Programs run in memory write no files, the report only if asked for
+  bool in_memory = run_jit || run_bc;
+  bool write_report = !in_memory || arguments.report;
+
   /// Open log file in append mode, else exit program
   sprintf (perror_msg, "log_fp = fopen(%s, 'a')", log_fn);
   errno = EXIT_SUCCESS;
@@ -194,7 +250,7 @@ main (int argc, char **argv)
   /// Check if destination file exists
   sprintf (perror_msg, "access('%s', F_OK)", dest_fn);
   logger(DEBUG, perror_msg);
-  if (access (dest_fn, F_OK) == EXIT_SUCCESS)
+  if (!in_memory && access (dest_fn, F_OK) == EXIT_SUCCESS)
     {
       /// If destination file exists, delete it
       sprintf (perror_msg, "remove(%s)", dest_fn);
@@ -209,24 +265,15 @@ main (int argc, char **argv)
         }
     }
 
-  /// Open source file in read-only mode
-  sprintf (perror_msg, "source_fp = fopen('%s', 'r')", source_fn);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  source_fp = fopen (source_fn, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
+  /// Read source file into memory
+  retVal = read_file (source_fn, &source_buf);
+  if (retVal != EXIT_SUCCESS)
+    return (opal_exit (retVal));
 
   /// Check if report file exists
   sprintf (perror_msg, "access('%s', F_OK)", report_fn);
   logger(DEBUG, perror_msg);
-  if (access (report_fn, F_OK) == EXIT_SUCCESS)
+  if (write_report && access (report_fn, F_OK) == EXIT_SUCCESS)
     {
       /// Truncate report file
       sprintf (perror_msg, "ftruncate(%s, EXIT_SUCCESS)", report_fn);
@@ -242,307 +289,62 @@ main (int argc, char **argv)
     }
 
   /// If report file can not be written, print error and exit
-  sprintf (perror_msg, "report_fp = fopen('%s', 'a')", report_fn);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  report_fp = fopen (report_fn, "a");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
-
-  /// Initialize HTML report file
-  retVal = init_report (report_fp);
-  if (retVal != EXIT_SUCCESS)
-    opal_exit (retVal);
-
-  /// Call MARC functions to pre-process source file
-  banner ("MARC start.");
-
-  /// Create and open temp destination file for remove_comments()
-  char *rc_tmp = "tmp/marc_rc.tmp";
-  logger(DEBUG, "rc_tmp: '%s'", rc_tmp);
-
-  /// If temp file can not be written, print error and exit
-  sprintf (perror_msg, "rc_fp = fopen('%s', 'wb')", rc_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  FILE *rc_fp = fopen (rc_tmp, "wb");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
-
-  /// Remove comments from source with rem_comments(), write to rc_tmp
-  retVal = rem_comments (source_fp, rc_fp);
-  if (retVal != EXIT_SUCCESS)
-    return (opal_exit (retVal));
-
-  if (!quiet)
-    fprintf(stdout, "Removed comments from source file.\n");
-
-  /// Close source file pointer source_fp if not NULL
-  sprintf (perror_msg, "fclose(source_fp)");
-  logger(DEBUG, perror_msg);
-  if (source_fp)
+  if (write_report)
     {
-      if (fclose (source_fp) == EXIT_SUCCESS)
-        {
-          _PASS;
-          source_fp = NULL;
-        }
-      else
-        {
-          perror (perror_msg);
-          _FAIL;
-          return (errno);
-        }
-    }
-
-  /// Close rem_comments() temp file pointer rc_fp if not NULL
-  sprintf (perror_msg, "fclose(rc_fp)");
-  logger(DEBUG, perror_msg);
-  if (rc_fp)
-    {
-      if (fclose (rc_fp) == EXIT_SUCCESS)
-        {
-          _PASS;
-          rc_fp = NULL;
-        }
-      else
-        {
-          perror (perror_msg);
-          _FAIL;
-          return (errno);
-        }
-    }
-
-  /// Open rem_comments() temp file in read mode, else print error and exit
-  sprintf (perror_msg, "rc_fp = fopen('%s', 'r')", rc_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  rc_fp = fopen (rc_tmp, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
-
-  /// Create and open temp destination file for proc_includes()
-  char *pi_tmp = "tmp/marc_pi.tmp";
-  logger(DEBUG, "pi_tmp: '%s'", pi_tmp);
-
-  /// If temp file can not be written, print error and exit
-  sprintf (perror_msg, "pi_fp = fopen('%s', 'wb')", pi_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  FILE *pi_fp = fopen (pi_tmp, "wb");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
-
-  /// Process #include directives from source with proc_includes()
-  retVal = proc_includes (rc_fp, pi_fp);
-  if (retVal != EXIT_SUCCESS)
-    {
-      return (opal_exit (retVal));
-    }
-
-  if (!quiet)
-    fprintf(stdout, "Processed #include files.\n");
-
-  /// Close rem_comments temp file pointer if not NULL
-  if (rc_fp)
-    {
-      sprintf (perror_msg, "fclose(rc_fp)");
+      sprintf (perror_msg, "report_fp = fopen('%s', 'a')", report_fn);
       logger(DEBUG, perror_msg);
-
-      if (fclose (rc_fp) == EXIT_SUCCESS)
-        {
-          _PASS;
-          rc_fp = NULL;
-        }
+      errno = EXIT_SUCCESS;
+      report_fp = fopen (report_fn, "a");
+      if (errno == EXIT_SUCCESS)
+        _PASS;
       else
         {
           perror (perror_msg);
           _FAIL;
           return (errno);
         }
-    }
-
-  /// Close proc_includes() temp file pointer if not NULL
-  if (pi_fp)
-    {
-      sprintf (perror_msg, "fclose(pi_fp)");
-      logger(DEBUG, perror_msg);
 
-      if (fclose (pi_fp) == EXIT_SUCCESS)
-        {
-          _PASS;
-          pi_fp = NULL;
-        }
-      else
-        {
-          perror (perror_msg);
-          _FAIL;
-          return (errno);
-        }
+      /// Initialize HTML report file
+      retVal = init_report (report_fp);
+      if (retVal != EXIT_SUCCESS)
+        opal_exit (retVal);
     }
 
-  /// Open proc_includes() temp file in read mode, else print error and exit
-  sprintf (perror_msg, "pi_fp = fopen('%s', 'r')", pi_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  pi_fp = fopen (pi_tmp, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
-
-  /// Open rem_comments() temp file in write mode, else print error and exit
-  sprintf (perror_msg, "rc_fp = fopen('%s', 'wb')", rc_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  rc_fp = fopen (rc_tmp, "wb");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
-
-
-  if (!quiet)
-    fprintf(stdout, "Removed comments from included files.\n");
+  /// Call MARC functions to pre-process source file
+  banner ("MARC start.");
 
-  /// Remove comments from includes files with rem_comments(), write to rc_tmp
-  retVal = rem_comments (pi_fp, rc_fp);
+  /// Remove comments and process #include directives with marc_preprocess()
+  retVal = marc_preprocess (&source_buf, &marc_buf);
   if (retVal != EXIT_SUCCESS)
-    {
-      return (opal_exit (retVal));
-    }
-
-  /// Close proc_includes() temp file pointer, else print error and exit
-  sprintf (perror_msg, "fclose(pi_fp)");
-  logger(DEBUG, perror_msg);
-  if (fclose (pi_fp) == EXIT_SUCCESS)
-    {
-      _PASS;
-      pi_fp = NULL;
-    }
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
-
-  /// Close rem_comments() temp file pointer, else print error and exit
-  sprintf (perror_msg, "fclose(rc_fp)");
-  logger(DEBUG, perror_msg);
-  if (fclose (rc_fp) == EXIT_SUCCESS)
-    {
-      _PASS;
-      rc_fp = NULL;
-    }
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
+    return (opal_exit (retVal));
 
-  /// Open rem_comments() temp file in read mode, else print error and exit
-  sprintf (perror_msg, "rc_fp = fopen('%s', 'r')", rc_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  rc_fp = fopen (rc_tmp, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
+  if (!quiet)
+    fprintf(stdout, "Removed comments and processed #include files.\n");
 
   /// Append MARC output to HTML report
-  retVal = print_marc_html (rc_fp, report_fp);
+  retVal = report_fp ? print_marc_html (&marc_buf, report_fp) : EXIT_SUCCESS;
   if (retVal != EXIT_SUCCESS)
-    {
-      return (opal_exit (retVal));
-    }
-
-  /// Close rem_comments() temp file pointer, else print error and exit
-  sprintf (perror_msg, "fclose(rc_fp)");
-  logger(DEBUG, perror_msg);
-  if (fclose (rc_fp) == EXIT_SUCCESS)
-    {
-      _PASS;
-      rc_fp = NULL;
-    }
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
+    return (opal_exit (retVal));
 
   /// Start lexical analyzer code
   banner ("ALEX start.");
 
-  /// Open rem_comments() temp file as source_fp, else print error and exit
-  sprintf (perror_msg, "source_fp = fopen('%s', 'r')", rc_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  source_fp = fopen (rc_tmp, "r");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
-    {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
-
-  /// Create symbol table linked list
-  logger(DEBUG, "Create symbol_table linked list node.");
-  lexeme_s *symbol_table = (lexeme_s*) calloc (1, sizeof(lexeme_s));
+  /// Point lexer cursor at the MARC output buffer
+  init_lexer (&marc_buf);
 
-  int symbol_count = 0;                ///< Number of lexemes identified
+  /// Create empty symbol table
+  symbol_table_s symbol_table = { 0 };
 
   if (!quiet)
     fprintf(stdout, "Symbol table of lexemes created.\n");
 
-  /// Build symbol table using rem_comments() temp file as source
-  retVal = build_symbol_table (symbol_table, &symbol_count);
+  /// Build symbol table using MARC output buffer as source
+  retVal = build_symbol_table (&symbol_table);
   if (retVal != EXIT_SUCCESS)
     return (opal_exit (retVal));
 
-  logger(DEBUG, "assert(symbol_ct [%d] > 0)", symbol_count);
-  assert(symbol_count > 0);
+  logger(DEBUG, "assert(symbol_ct [%d] > 0)", symbol_table.count);
+  assert(symbol_table.count > 0);
   _PASS;
 
   /// Create and open temp destination file for print_symbol_table()
@@ -550,26 +352,31 @@ main (int argc, char **argv)
   logger(DEBUG, "alex_tmp: '%s'", alex_tmp);
 
   /// If alex temp file can not be written, print error and exit
-  sprintf (perror_msg, "alex_fp = fopen('%s', 'wb')", alex_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  FILE *alex_fp = fopen (alex_tmp, "wb");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
+  FILE *alex_fp = NULL;
+  if (!in_memory)
     {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
+      sprintf (perror_msg, "alex_fp = fopen('%s', 'wb')", alex_tmp);
+      logger(DEBUG, perror_msg);
+      errno = EXIT_SUCCESS;
+      alex_fp = fopen (alex_tmp, "wb");
+      if (errno == EXIT_SUCCESS)
+        _PASS;
+      else
+        {
+          perror (perror_msg);
+          _FAIL;
+          return (errno);
+        }
 
-  /// Print symbol table with print_symbol_table() to alex temp file
-  retVal = print_symbol_table (symbol_table, alex_fp);
-  if (retVal != EXIT_SUCCESS)
-    return (opal_exit (retVal));
+      /// Print symbol table with print_symbol_table() to alex temp file
+      retVal = print_symbol_table (&symbol_table, alex_fp);
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+    }
 
   /// Print symbol table HTML report with print_symbol_table_html()
-  retVal = print_symbol_table_html (symbol_table, report_fp);
+  retVal = report_fp ?
+      print_symbol_table_html (&symbol_table, report_fp) : EXIT_SUCCESS;
   if (retVal != EXIT_SUCCESS)
     return (opal_exit (retVal));
 
@@ -594,7 +401,7 @@ main (int argc, char **argv)
   banner ("ASTRO start.");
 
   /// Build abstract syntax tree using symbol table
-  node_s *syntax_tree = build_syntax_tree (symbol_table);
+  unsigned int syntax_tree = build_syntax_tree (&symbol_table);
 
   logger(DEBUG, "assert(syntax_tree)");
   assert(syntax_tree);
@@ -604,117 +411,224 @@ main (int argc, char **argv)
     fprintf(stdout, "Abstract Syntax Tree created.\n");
 
   /// Print abstract syntax tree HTML report with print_ast_html()
-  fprintf (report_fp, "<h3>Output by syntax analyzer <code>ASTRO</code></h3>\n"
-           "<hr>\n");
-  retVal = print_ast_html (syntax_tree, report_fp);
-  if (retVal != EXIT_SUCCESS)
-    return (opal_exit (retVal));
+  if (report_fp)
+    {
+      fprintf (report_fp, "<h3>Output by syntax analyzer <code>ASTRO</code>"
+               "</h3>\n<hr>\n");
+      retVal = print_ast_html (syntax_tree, report_fp);
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+    }
 
   /// Optimize the abstract syntax tree
-  node_s *syntax_tree_pass1 = optimize_syntax_tree (syntax_tree);
-  node_s *syntax_tree_pass2 = optimize_syntax_tree (syntax_tree_pass1);
+  unsigned int optimized_tree = optimize_syntax_tree (syntax_tree);
 
   if (!quiet)
     fprintf(stdout, "Abstract Syntax Tree optimization done.\n");
 
   /// Print optimized syntax tree HTML report with print_ast_html()
-  fprintf (report_fp, "<h3>Optimized abstract syntax tree: </h3>\n<hr>\n");
-  retVal = print_ast_html (syntax_tree_pass2, report_fp);
-  if (retVal != EXIT_SUCCESS)
-    return (opal_exit (retVal));
+  if (report_fp)
+    {
+      fprintf (report_fp, "<h3>Optimized abstract syntax tree: </h3>\n"
+               "<hr>\n");
+      retVal = print_ast_html (optimized_tree, report_fp);
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+
+      /// Print constants folded by the optimizer to HTML report
+      retVal = print_folds_html (report_fp);
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+    }
 
   /// Start code generator
   banner ("GENIE start.");
 
   /// Build assembly code table using
-  gen_asm_code (syntax_tree_pass2);
+  gen_asm_code (optimized_tree);
   add_asm_code (asm_HALT, 0, NULL);
 
+  /// Rewrite redundant commands with the peephole optimizer
+  optimize_asm_code ();
+
   if (!quiet)
     fprintf(stdout, "Assembly code generated.\n");
 
-  /// Create and open temp destination file for print_asm_code()
-  char *asm_tmp = "tmp/asm.tmp";
-  logger(DEBUG, "asm_tmp: '%s'", asm_tmp);
+  /// The register backend is only written as NASM source
+  if (asm_backend == backend_Regs)
+    use_nasm = TRUE;
 
-  /// If asm temp file can not be written, print error and exit
-  sprintf (perror_msg, "asm_fp = fopen('%s', 'wb')", asm_tmp);
-  logger(DEBUG, perror_msg);
-  errno = EXIT_SUCCESS;
-  FILE *asm_fp = fopen (asm_tmp, "wb");
-  if (errno == EXIT_SUCCESS)
-    _PASS;
-  else
+  char *asm_tmp = "tmp/asm.tmp";
+  if (use_nasm && !in_memory)
     {
-      perror (perror_msg);
-      _FAIL;
-      return (errno);
-    }
-
-  /// Print symbol table with print_symbol_table() to assembly file
-  retVal = print_asm_code (asm_cmd_list, asm_fp);
-  if (retVal != EXIT_SUCCESS)
-    return (opal_exit (retVal));
+      /// Create and open temp destination file for print_asm_code()
+      logger(DEBUG, "asm_tmp: '%s'", asm_tmp);
 
-  /// Close asm temp file pointer asm_fp if not NULL
-  sprintf (perror_msg, "fclose(asm_fp)");
-  logger(DEBUG, perror_msg);
-  if (asm_fp)
-    {
-      if (fclose (asm_fp) == EXIT_SUCCESS)
-        {
-          _PASS;
-          asm_fp = NULL;
-        }
+      /// If asm temp file can not be written, print error and exit
+      sprintf (perror_msg, "asm_fp = fopen('%s', 'wb')", asm_tmp);
+      logger(DEBUG, perror_msg);
+      errno = EXIT_SUCCESS;
+      FILE *asm_fp = fopen (asm_tmp, "wb");
+      if (errno == EXIT_SUCCESS)
+        _PASS;
       else
         {
           perror (perror_msg);
           _FAIL;
           return (errno);
         }
+
+      /// Print symbol table with print_symbol_table() to assembly file
+      retVal = print_asm_code (asm_cmd_list, asm_fp);
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+
+      /// Close asm temp file pointer asm_fp if not NULL
+      sprintf (perror_msg, "fclose(asm_fp)");
+      logger(DEBUG, perror_msg);
+      if (asm_fp)
+        {
+          if (fclose (asm_fp) == EXIT_SUCCESS)
+            {
+              _PASS;
+              asm_fp = NULL;
+            }
+          else
+            {
+              perror (perror_msg);
+              _FAIL;
+              return (errno);
+            }
+        }
     }
 
-  /// Print assembly code with print_asm_code_html()
-  retVal = print_asm_code_html (asm_cmd_list, report_fp);
-  if (retVal != EXIT_SUCCESS)
-    return (opal_exit (retVal));
+  if (report_fp)
+    {
+      /// Print peephole optimizer hit counts to HTML report
+      retVal = print_peephole_html (report_fp);
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+
+      /// Print assembly code with print_asm_code_html()
+      retVal = print_asm_code_html (asm_cmd_list, report_fp);
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+    }
 
   /// Start orchestrator
   banner ("ORCHESTRATOR start.");
 
-  /// If object object file exists, delete it
-  char *obj_fn = "tmp/nasm.o";
-  sprintf (perror_msg, "access('%s', F_OK)", obj_fn);
-  logger(DEBUG, perror_msg);
-  if (access (obj_fn, F_OK) == EXIT_SUCCESS)
+  if (run_bc)
+    {
+      /// Close HTML report before the program writes to stdout
+      retVal = report_fp ? close_report (report_fp) : EXIT_SUCCESS;
+      report_fp = NULL;
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+
+      /// Interpret bytecode, exit with the program's exit code
+      bc_image_s bytecode;
+      retVal = bc_encode (&bytecode);
+      if (retVal == EXIT_SUCCESS)
+        retVal = bc_run (&bytecode);
+      free_bc_image (&bytecode);
+      free_symbol_table (&symbol_table);
+      free_syntax_tree ();
+      syntax_tree = 0;
+      free_asm_arrays ();
+      return (opal_exit (retVal));
+    }
+  else if (run_jit)
+    {
+      /// Close HTML report, the program ends the process when it halts
+      retVal = report_fp ? close_report (report_fp) : EXIT_SUCCESS;
+      report_fp = NULL;
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+
+      /// Run machine code in memory, only returns on error
+      retVal = x86_run ();
+      return (opal_exit (retVal));
+    }
+  else if (asm_backend == backend_C)
     {
-      sprintf (perror_msg, "remove(%s)", obj_fn);
+      /// Write the syntax tree as C source
+      char *c_tmp = "tmp/c.tmp";
+      sprintf (perror_msg, "c_fp = fopen('%s', 'wb')", c_tmp);
       logger(DEBUG, perror_msg);
-      if (remove (obj_fn) == EXIT_SUCCESS)
-        _PASS;
-      else
+      FILE *c_fp = fopen (c_tmp, "wb");
+      if (!c_fp)
         {
           perror (perror_msg);
           _FAIL;
-          return (errno);
+          return (opal_exit (errno));
         }
+      _PASS;
+
+      retVal = print_c_code (optimized_tree, c_fp);
+      if (fclose (c_fp) != EXIT_SUCCESS && retVal == EXIT_SUCCESS)
+        retVal = errno;
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+
+      /// Compile it with gcc
+      retVal = gen_c_bin (c_tmp, dest_fn);
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+
+      if (!quiet)
+        fprintf(stdout, "Compile C source using 'gcc'.\n");
     }
+  else if (!use_nasm)
+    {
+      /// Encode machine code and write the executable directly
+      x86_image_s image;
+      retVal = x86_encode (&image, X86_DATA_ADDR);
+      if (retVal == EXIT_SUCCESS)
+        retVal = gen_elf (&image, dest_fn);
+      free_x86_image (&image);
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
 
-  /// Assemble object using NASM
-  retVal = gen_obj (asm_tmp, obj_fn);
-  if (retVal != EXIT_SUCCESS)
-    return (opal_exit (retVal));
+      if (!quiet)
+        fprintf(stdout, "Write executable using built-in x86-64 encoder.\n");
+    }
+  else
+    {
+      /// If object object file exists, delete it
+      char *obj_fn = "tmp/nasm.o";
+      sprintf (perror_msg, "access('%s', F_OK)", obj_fn);
+      logger(DEBUG, perror_msg);
+      if (access (obj_fn, F_OK) == EXIT_SUCCESS)
+        {
+          sprintf (perror_msg, "remove(%s)", obj_fn);
+          logger(DEBUG, perror_msg);
+          if (remove (obj_fn) == EXIT_SUCCESS)
+            _PASS;
+          else
+            {
+              perror (perror_msg);
+              _FAIL;
+              return (errno);
+            }
+        }
 
-  if (!quiet)
-    fprintf(stdout, "Assemble object file using 'NASM'.\n");
+      /// Assemble object using NASM
+      retVal = gen_obj (asm_tmp, obj_fn);
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
 
-  /// Link object using LD
-  retVal = gen_bin (obj_fn, dest_fn);
-  if (retVal != EXIT_SUCCESS)
-    return (opal_exit (retVal));
+      if (!quiet)
+        fprintf(stdout, "Assemble object file using 'NASM'.\n");
 
-  if (!quiet)
-    fprintf(stdout, "Link object file using 'ld'.\n");
+      /// Link object using LD
+      retVal = gen_bin (obj_fn, dest_fn);
+      if (retVal != EXIT_SUCCESS)
+        return (opal_exit (retVal));
+
+      if (!quiet)
+        fprintf(stdout, "Link object file using 'ld'.\n");
+    }
 
   /// Close HTML report file
   retVal = close_report (report_fp);
@@ -726,18 +640,17 @@ main (int argc, char **argv)
             dest_fn, report_fn);
 
   /// Free memory used by symbol_table
-  free_symbol_table (symbol_table);
-  symbol_table = NULL;
+  free_symbol_table (&symbol_table);
 
   /// Free memory used by syntax_tree
-  free_syntax_tree (syntax_tree);
-  syntax_tree = NULL;
+  free_syntax_tree ();
+  syntax_tree = 0;
 
   /// Free memory used by ASM array
   retVal = free_asm_arrays();
   if (retVal != EXIT_SUCCESS)
     return (opal_exit (retVal));
 
-  /// source_fp, dest_fp, log_fp & report_fp closed by opal_exit()
+  /// dest_fp, log_fp & report_fp closed by opal_exit()
   return (opal_exit (EXIT_SUCCESS));
 }
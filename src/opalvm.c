@@ -0,0 +1,138 @@
+/// @file opalvm.c
+
+#include <argp.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libopal.h"
+
+/// Get build number from compiler
+static void
+argp_print_version (FILE *stream, struct argp_state *state)
+{
+  fprintf (stream, "OPaL VM version: %.2f\n", __VERSION_NUM);
+}
+
+/// Hook for printing build version
+void
+(*argp_program_version_hook) (FILE *stream, struct argp_state *state) =
+argp_print_version;
+
+/// Link for reporting bugs
+const char *argp_program_bug_address =
+    "https://github.com/mckerracher/OPaL/issues";
+
+/// Program documentation
+static char doc[] = "opalvm - OPaL bytecode runner";
+static char args_doc[] = "FILE";            ///< Arguments we accept
+static struct argp_option options[] =       ///< The options we understand
+  {
+    { "debug", 'd', 0, 0, "Log debug messages" },
+    { "log", 'l', "FILE", 0, "Save log to FILE instead of standard error" },
+    { 0 }
+  };
+
+/// Struct to hold Command Line arguments
+struct arguments
+{
+  char *args[1];     ///< Bytecode file
+  char *logfile;     ///< filename for logger
+};
+
+/**
+ * @brief Get the input argument from argp_parse, which we know is a pointer to
+ * our arguments structure.
+ * @param [in] key An integer specifying which option this is
+ * @param [in] arg For an option KEY, the string value of its argument, or NULL
+ * @param [in] state A pointer to a struct argp_state
+ * @return
+ */
+static error_t
+parse_opt (int key, char *arg, struct argp_state *state)
+{
+  struct arguments *arguments = state->input;
+
+  switch (key)
+    {
+    case 'd':
+      LOG_LEVEL = DEBUG;
+      break;
+
+    case 'l':
+      arguments->logfile = arg;
+      break;
+
+    case ARGP_KEY_ARG:
+      if (state->arg_num >= 1)      // Too many arguments
+        argp_usage (state);
+      arguments->args[state->arg_num] = arg;
+      break;
+
+    case ARGP_KEY_END:
+      if (state->arg_num < 1)       // Not enough arguments
+        argp_usage (state);
+      break;
+
+    default:
+      return ARGP_ERR_UNKNOWN;
+    }
+  return EXIT_SUCCESS;
+}
+
+static struct argp argp = { options, parse_opt, args_doc, doc };
+
+/**
+ * @brief       Main function for opalvm - OPaL bytecode runner
+ * @details     Calls map_opb() to map a bytecode file written by
+ * 'genie --bytecode' and bc_run() to run it. Errors are logged to standard
+ * error unless a log file is given.
+ *
+ * @param[in]   argc    Number of command line arguments
+ * @param[in]   argv    Vector of individual command line argument strings
+ * @return      The exit code of the program run.
+ *
+ * @retval      EXIT_FAILURE    On invalid bytecode file
+ * @retval      errno           On system call failure
+ */
+int
+main (int argc, char **argv)
+{
+  /// Create structure to process command line arguments
+  struct arguments arguments = { .logfile = NULL };
+
+  /// Parse arguments
+  argp_parse (&argp, argc, argv, 0, 0, &arguments);
+  log_fp = stderr;
+
+  /// Open log file in append mode, else exit program
+  if (arguments.logfile)
+    {
+      log_fn = strdup (arguments.logfile);
+      sprintf (perror_msg, "log_fp = fopen(%s, 'a')", log_fn);
+      errno = EXIT_SUCCESS;
+      log_fp = fopen (log_fn, "a");
+      if (errno != EXIT_SUCCESS)
+        {
+          perror (perror_msg);
+          log_fp = stderr;
+          return (opal_exit (EXIT_FAILURE));
+        }
+    }
+
+  banner ("OPALVM start.");
+  logger(DEBUG, "Bytecode file: '%s'", arguments.args[0]);
+
+  /// Map bytecode file, then run it
+  bc_image_s bytecode;
+  retVal = map_opb (arguments.args[0], &bytecode);
+  if (retVal != EXIT_SUCCESS)
+    return (opal_exit (retVal));
+
+  retVal = bc_run (&bytecode);
+  free_bc_image (&bytecode);
+
+  /// log_fp closed by opal_exit()
+  return (opal_exit (retVal));
+}
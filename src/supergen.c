@@ -0,0 +1,355 @@
+/// @file supergen.c
+/// @brief Mines opcode sequences from GENIE assembly and generates the
+/// bytecode superinstructions
+///
+/// Every run of commands between labels in the user code of the given
+/// assembly files is split into n-grams of two to BC_SUPER_MAX opcodes,
+/// counted LOOP_WEIGHT times more often for every while loop around them.
+/// The n-grams saving the most dispatches become superinstructions, written
+/// as a C header with their opcodes, bc_run() handlers and dispatch entries.
+/// Run by 'make superinstructions' over the assembly of input/*.opl:
+///
+///     build/supergen src/bc_super.h tmp/corpus/*.asm
+///
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libopal.h"
+
+#define BC_SUPER_MAX 4          ///< Most opcodes fused by a superinstruction
+#define SUPER_LIMIT 32          ///< Number of superinstructions generated
+#define MAX_NGRAMS 65536        ///< Upper bound of distinct n-grams counted
+#define LOOP_WEIGHT 8           ///< Weight of code in a loop per nesting level
+#define MAX_LOOP_DEPTH 4        ///< Deepest nesting level weighted
+
+/// Opcode names as in bc_op_e, handlers are BC_DO_ and the upper case suffix
+const char *bc_names[bc_OpCount] =
+  {
+    [bc_Halt] = "bc_Halt", [bc_Push] = "bc_Push", [bc_Fetch] = "bc_Fetch",
+    [bc_Store] = "bc_Store", [bc_StoreKeep] = "bc_StoreKeep",
+    [bc_Add] = "bc_Add", [bc_Sub] = "bc_Sub", [bc_Mul] = "bc_Mul",
+    [bc_Div] = "bc_Div", [bc_Mod] = "bc_Mod", [bc_Negate] = "bc_Negate",
+    [bc_Eq] = "bc_Eq", [bc_Neq] = "bc_Neq", [bc_Lss] = "bc_Lss",
+    [bc_Gtr] = "bc_Gtr", [bc_Leq] = "bc_Leq", [bc_Geq] = "bc_Geq",
+    [bc_And] = "bc_And", [bc_Or] = "bc_Or", [bc_Not] = "bc_Not",
+    [bc_Jmp] = "bc_Jmp", [bc_Jz] = "bc_Jz", [bc_Jnz] = "bc_Jnz",
+    [bc_Jeq] = "bc_Jeq", [bc_Jneq] = "bc_Jneq", [bc_Jlss] = "bc_Jlss",
+    [bc_Jgtr] = "bc_Jgtr", [bc_Jleq] = "bc_Jleq", [bc_Jgeq] = "bc_Jgeq",
+    [bc_Prts] = "bc_Prts", [bc_Prti] = "bc_Prti", [bc_Input] = "bc_Input",
+  };
+
+/// Opcode sequence with the number of times it was seen
+typedef struct ngram
+{
+  unsigned char ops[BC_SUPER_MAX];  ///< opcodes, bc_OpCount past the end
+  int len;                          ///< number of opcodes
+  long count;                       ///< weighted occurrences in the corpus
+} ngram_s;
+
+ngram_s ngrams[MAX_NGRAMS] = { { { 0 } } };     ///< n-grams counted
+int ngram_count = 0;                            ///< Number of n-grams
+long cmd_count = 0;                             ///< Commands mined
+
+/**
+ * @brief       Check whether an opcode jumps
+ *
+ * @param[in]   op            Bytecode opcode
+ *
+ * @return      TRUE for jumps, else FALSE
+ */
+short
+op_is_jump (int op)
+{
+  return op >= bc_Jmp && op <= bc_Jgeq;
+}
+
+/**
+ * @brief       Check whether an opcode may be fused. Printing, input and
+ *              HALT cost a system call, a dispatch more does not matter.
+ *
+ * @param[in]   op            Bytecode opcode
+ *
+ * @return      TRUE if the opcode may be part of a superinstruction
+ */
+short
+op_is_fusable (int op)
+{
+  return op != bc_Halt && op != bc_Prts && op != bc_Prti && op != bc_Input;
+}
+
+/**
+ * @brief       Check whether an opcode has a 32 bit operand
+ *
+ * @param[in]   op            Bytecode opcode
+ *
+ * @return      TRUE if the opcode takes an operand
+ */
+short
+op_has_operand (int op)
+{
+  return op == bc_Push || op == bc_Fetch || op == bc_Store
+      || op == bc_StoreKeep || op_is_jump (op);
+}
+
+/**
+ * @brief       Count an n-gram
+ *
+ * @param[in]   ops           Opcodes of the n-gram
+ * @param[in]   len           Number of opcodes
+ * @param[in]   weight        Occurrences counted
+ *
+ * @return      None
+ */
+void
+count_ngram (const unsigned char *ops, int len, long weight)
+{
+  int i = 0;
+
+  for (i = 0; i < ngram_count; i++)
+    if (ngrams[i].len == len && memcmp (ngrams[i].ops, ops, len) == 0)
+      {
+        ngrams[i].count += weight;
+        return;
+      }
+
+  if (ngram_count == MAX_NGRAMS)
+    {
+      fprintf (stderr, "supergen: too many distinct n-grams\n");
+      exit (EXIT_FAILURE);
+    }
+  memset (ngrams[ngram_count].ops, bc_OpCount, BC_SUPER_MAX);
+  memcpy (ngrams[ngram_count].ops, ops, len);
+  ngrams[ngram_count].len = len;
+  ngrams[ngram_count].count = weight;
+  ngram_count++;
+}
+
+/**
+ * @brief       Count the n-grams ending at every opcode of a run
+ *
+ * @param[in]   run           Opcodes between two labels
+ * @param[in]   len           Number of opcodes
+ * @param[in]   weight        Occurrences counted for every n-gram
+ *
+ * @return      None
+ */
+void
+count_run (const unsigned char *run, int len, long weight)
+{
+  int end = 0, n = 0, i = 0;
+
+  for (end = 1; end <= len; end++)
+    for (n = 2; n <= BC_SUPER_MAX && n <= end; n++)
+      {
+        /// Only the last opcode may jump, none may make a system call
+        const unsigned char *ops = run + end - n;
+        for (i = 0; i < n; i++)
+          if (!op_is_fusable (ops[i]) || (i < n - 1 && op_is_jump (ops[i])))
+            break;
+        if (i == n)
+          count_ngram (ops, n, weight);
+      }
+}
+
+/**
+ * @brief       Mine the user code of a GENIE assembly file
+ *
+ * @param[in]   fn            Assembly file name
+ *
+ * @return      EXIT_SUCCESS on success, else errno
+ */
+short
+mine_file (const char *fn)
+{
+  FILE *fp = fopen (fn, "r");
+  if (!fp)
+    {
+      perror (fn);
+      return errno;
+    }
+
+  char line[1024] = { 0 }, word[64] = { 0 };
+  unsigned char run[1 << 16] = { 0 };
+  int run_len = 0, in_code = FALSE, depth = 0;
+  long weight = 1;
+  unsigned int i = 0;
+
+  while (fgets (line, sizeof(line), fp))
+    {
+      if (strstr (line, ";=== User code start ===;"))
+        {
+          in_code = TRUE;
+          continue;
+        }
+      if (strstr (line, ";=== User code end ===;"))
+        break;
+      if (!in_code || sscanf (line, "%63s", word) != 1)
+        continue;
+
+      /// Labels and unknown commands end a run
+      int op = bc_OpCount;
+      for (i = 0; isspace ((unsigned char) line[0])
+          && i < sizeof(asm_cmds) / sizeof(asm_cmds[0]); i++)
+        if (strcmp (word, asm_cmds[i]) == 0)
+          {
+            op = bc_ops[i];
+            break;
+          }
+      if (op == bc_OpCount || run_len == sizeof(run))
+        {
+          count_run (run, run_len, weight);
+          run_len = 0;
+        }
+
+      /// GENIE labels the start and the end of every while loop
+      if (strncmp (word, "_while_loop_", 12) == 0)
+        depth++;
+      else if (strncmp (word, "_while_end_", 11) == 0 && depth > 0)
+        depth--;
+      for (weight = 1, i = 0; i < depth && i < MAX_LOOP_DEPTH; i++)
+        weight *= LOOP_WEIGHT;
+      if (op != bc_OpCount)
+        {
+          run[run_len++] = op;
+          cmd_count++;
+        }
+    }
+  count_run (run, run_len, weight);
+
+  fclose (fp);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief       Order n-grams by dispatches saved, then longer first
+ */
+int
+cmp_saved (const void *a, const void *b)
+{
+  const ngram_s *x = a, *y = b;
+  long sx = x->count * (x->len - 1), sy = y->count * (y->len - 1);
+
+  if (sx != sy)
+    return sx < sy ? 1 : -1;
+  if (x->len != y->len)
+    return y->len - x->len;
+  return memcmp (x->ops, y->ops, BC_SUPER_MAX);
+}
+
+/**
+ * @brief       Order superinstructions longest first for the rewrite pass
+ */
+int
+cmp_longest (const void *a, const void *b)
+{
+  const ngram_s *x = a, *y = b;
+
+  if (x->len != y->len)
+    return y->len - x->len;
+  return cmp_saved (a, b);
+}
+
+/**
+ * @brief       Mine the assembly files and write the superinstruction header
+ *
+ * @param[in]   argc          Argument count
+ * @param[in]   argv          Argument vector, argv[1] is the header file
+ *                            name, the assembly files follow
+ *
+ * @return      The error return code of the program.
+ *
+ * @retval      EXIT_SUCCESS    On success
+ * @retval      EXIT_FAILURE    On error
+ * @retval      errno           On system call failure
+ */
+int
+main (int argc, char **argv)
+{
+  int i = 0, j = 0;
+
+  if (argc < 3)
+    {
+      fprintf (stderr, "Usage: supergen HEADER ASM...\n");
+      return EXIT_FAILURE;
+    }
+
+  for (i = 2; i < argc; i++)
+    if (mine_file (argv[i]) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+  /// Keep the n-grams saving the most dispatches, longest first
+  qsort (ngrams, ngram_count, sizeof(ngram_s), cmp_saved);
+  int count = ngram_count < SUPER_LIMIT ? ngram_count : SUPER_LIMIT;
+  qsort (ngrams, count, sizeof(ngram_s), cmp_longest);
+
+  /// FNV-1a of the opcodes tells bytecode files of other tables apart
+  unsigned int id = 2166136261u;
+  for (i = 0; i < count; i++)
+    for (j = 0; j < BC_SUPER_MAX; j++)
+      id = (id ^ ngrams[i].ops[j]) * 16777619u;
+
+  FILE *fp = fopen (argv[1], "w");
+  if (!fp)
+    {
+      perror (argv[1]);
+      return errno;
+    }
+
+  fprintf (fp, "/// @file bc_super.h\n"
+           "/// @brief Bytecode superinstructions generated by supergen from "
+           "%ld commands\n/// of %d files, do not edit\n\n"
+           "#define BC_SUPER_COUNT %-10d///< Number of superinstructions\n"
+           "#define BC_SUPER_MAX %-12d///< Most opcodes fused by one\n"
+           "#define BC_SUPER_ID 0x%08x  ///< Checksum of the opcode table\n\n",
+           cmd_count, argc - 2, count, BC_SUPER_MAX, id);
+
+  fprintf (fp, "/// Opcodes fused by each superinstruction, longest first, "
+           "bc_OpCount ends\nconst unsigned char "
+           "bc_super_ops[BC_SUPER_COUNT + 1][BC_SUPER_MAX + 1] =\n  {\n");
+  for (i = 0; i < count; i++)
+    {
+      fprintf (fp, "    {");
+      for (j = 0; j < ngrams[i].len; j++)
+        fprintf (fp, " %s,", bc_names[ngrams[i].ops[j]]);
+      fprintf (fp, " bc_OpCount }, /* weight %ld */\n", ngrams[i].count);
+    }
+  fprintf (fp, "    { bc_OpCount },\n  };\n\n");
+
+  fprintf (fp, "/// Handlers of the superinstructions in bc_run()\n"
+           "#define BC_SUPER_HANDLERS \\\n");
+  for (i = 0; i < count; i++)
+    {
+      int at = 0;
+      fprintf (fp, "  do_super_%d: \\\n   ", i);
+      for (j = 0; j < ngrams[i].len; j++)
+        {
+          const char *name = bc_names[ngrams[i].ops[j]] + 3;
+          fprintf (fp, " BC_DO_");
+          for (; *name; name++)
+            fputc (toupper ((unsigned char) *name), fp);
+          fprintf (fp, " (%d)", at);
+          if (op_has_operand (ngrams[i].ops[j]))
+            at += 4;
+        }
+      fprintf (fp, " \\\n    pc += %d; \\\n    BC_NEXT;%s\n", at,
+               i < count - 1 ? " \\" : "");
+    }
+  fprintf (fp, "\n/// Dispatch table entries of the superinstructions\n"
+           "#define BC_SUPER_DISPATCH \\\n");
+  for (i = 0; i < count; i++)
+    fprintf (fp, "  [bc_OpCount + %d] = &&do_super_%d,%s\n", i, i,
+             i < count - 1 ? " \\" : "");
+  fprintf (fp, "\n");
+
+  if (fclose (fp) != EXIT_SUCCESS)
+    {
+      perror (argv[1]);
+      return errno;
+    }
+
+  return EXIT_SUCCESS;
+}
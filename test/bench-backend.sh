@@ -0,0 +1,26 @@
+# Benchmark of the native backends against the C backend compiled by gcc -O2
+# on a loop of $ITERATIONS iterations, the baseline for the native code. The
+# register backend is assembled by NASM and only run where it is installed.
+
+ITERATIONS=100000000
+BENCH=bench-backend
+
+export LD_LIBRARY_PATH=build/
+source test/bench-lib.sh
+
+cat > output/$BENCH.opl << EOF2
+count = 0;
+total = 0;
+while (count < $ITERATIONS)
+{
+  total = total + count % 7;
+  count = count + 1;
+}
+print(total, "\n");
+EOF2
+
+backends="stack c"
+if command -v nasm > /dev/null ; then
+  backends="stack regs c"
+fi
+bench_backends iterations $ITERATIONS /dev/null $backends
@@ -0,0 +1,63 @@
+# Benchmark of the ASTRO expression parser, the GENIE code generators and
+# the interpreter on expressions with 10^5 terms. The native stack is
+# limited to 1 MB to show that its use does not grow with the length or
+# nesting depth of an expression.
+
+TERMS=100000
+
+export LD_LIBRARY_PATH=build/
+ulimit -s 1024
+
+# Print expression with $TERMS terms of the given kind
+gen_expr ()
+{
+  case $1 in
+    flat)    # a + 2 * b - 3 / c ...
+      awk -v n=$TERMS 'BEGIN { split("+ - * / % < == && ||", op, " ");
+        printf "a"; for (i = 1; i < n; i++) printf " %s %d", op[i % 9 + 1], i }' ;;
+    nested)  # (1 + (2 + (3 + ...)))
+      awk -v n=$TERMS 'BEGIN { for (i = 1; i < n; i++) printf "(%d + ", i;
+        printf "a"; for (i = 1; i < n; i++) printf ")" }' ;;
+    unary)   # - ! - ! ... a
+      awk -v n=$TERMS 'BEGIN { for (i = 1; i < n; i++) printf "%s", i % 2 ? "-" : "!";
+        printf "a" }' ;;
+  esac
+}
+
+# Time a command on $TERMS terms of expression kind $1
+#   $1    expression kind
+#   $2    name printed for the command
+#   $@    command after the first two arguments
+bench_cmd ()
+{
+  local kind=$1 name=$2 start end ms rc
+  shift 2
+
+  start=$(date +%s%N)
+  "$@" > /dev/null
+  rc=$?
+  end=$(date +%s%N)
+
+  ms=$(( (end - start) / 1000000 ))
+  [[ $ms -eq 0 ]] && ms=1
+  printf "%-8s %-10s %d terms  %6d ms  %8d terms/s  exit %d\n" \
+      $kind $name $TERMS $ms $(( TERMS * 1000 / ms )) $rc
+  return $rc
+}
+
+status=0
+for kind in flat nested unary ; do
+  { printf "a = 1;\nb = "; gen_expr $kind; printf ";\nprint(b);\n"; } \
+      > output/bench-$kind.opl
+
+  bench_cmd $kind astro build/astro --output=output/bench-$kind.ast \
+      output/bench-$kind.opl || status=1
+  bench_cmd $kind genie build/genie --output=output/bench-$kind.asm \
+      output/bench-$kind.opl || status=1
+  bench_cmd $kind genie-c build/genie --backend=c \
+      --output=output/bench-$kind.c output/bench-$kind.opl || status=1
+  bench_cmd $kind interpret build/opal --quiet --interpret \
+      output/bench-$kind.opl || status=1
+done
+
+exit $status
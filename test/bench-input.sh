@@ -0,0 +1,27 @@
+# Benchmark of reading $NUMBERS numbers from stdin, one line each, by the
+# native backend and the C backend compiled by gcc -O2, both with buffered
+# input. The native input read one byte at a time is timed by the commit
+# before the buffering:
+#   BASELINE=$(git log -1 --format=%h --grep='Read input in chunks')^ \
+#       bash test/bench-input.sh
+
+NUMBERS=500000
+BENCH=bench-input
+
+export LD_LIBRARY_PATH=build/
+source test/bench-lib.sh
+
+cat > output/$BENCH.opl << EOF2
+count = 0;
+total = 0;
+while (count < $NUMBERS)
+{
+  total = total + input("");
+  count = count + 1;
+}
+print(total, "\n");
+EOF2
+
+seq -$NUMBERS 2 $NUMBERS > output/$BENCH.txt
+
+bench_backends numbers $NUMBERS output/$BENCH.txt stack c
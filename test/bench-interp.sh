@@ -0,0 +1,39 @@
+# Benchmark of the bytecode interpreter with and without the superinstructions
+# of src/bc_super.h on a loop of $ITERATIONS iterations, the kind of code the
+# superinstructions are chosen for.
+
+ITERATIONS=5000000
+
+export LD_LIBRARY_PATH=build/
+
+cat > output/bench-interp.opl << EOF
+count = 0;
+total = 0;
+while (count < $ITERATIONS)
+{
+  total = total + count % 7;
+  count = count + 1;
+}
+print(total, "\n");
+EOF
+
+status=0
+for mode in super no-super ; do
+  flag=""
+  [[ $mode == no-super ]] && flag="--no-super"
+
+  start=$(date +%s%N)
+  build/opal --quiet --interpret $flag output/bench-interp.opl \
+      > output/bench-interp-$mode.out
+  rc=$?
+  end=$(date +%s%N)
+
+  ms=$(( (end - start) / 1000000 ))
+  [[ $ms -eq 0 ]] && ms=1
+  printf "%-8s %d iterations  %6d ms  %8d iterations/s  exit %d\n" \
+      $mode $ITERATIONS $ms $(( ITERATIONS * 1000 / ms )) $rc
+  [[ $rc -ne 0 ]] && status=1
+done
+
+cmp output/bench-interp-super.out output/bench-interp-no-super.out || status=1
+exit $status
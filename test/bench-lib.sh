@@ -0,0 +1,61 @@
+# Timing loop of the backend benchmarks, sourced by them after they write
+# their program to output/$BENCH.opl.
+#
+# With BASELINE set to a git revision, the program is also compiled by the
+# opal of that revision, built in the worktree output/baseline, and timed
+# as the backend 'baseline'. This measures a change against the code before
+# it, for example the unbuffered runtime with
+#   BASELINE=$(git log -1 --format=%h --grep='Buffer the output')^
+
+# Build opal of a git revision in output/baseline
+#   $1  git revision
+build_baseline ()
+{
+  git worktree prune
+  if [[ ! -d output/baseline ]] ; then
+    git worktree add --detach output/baseline $1 > /dev/null 2>&1 \
+        || return 1
+  fi
+  git -C output/baseline checkout --quiet --detach $1 || return 1
+  make -C output/baseline all > /dev/null 2>&1
+}
+
+# Compile output/$BENCH.opl with every backend and time its run, each run
+# must exit with zero and print what the first backend printed
+#   $1  name of what is counted
+#   $2  number counted
+#   $3  input file
+#   $@  backends after the first three arguments
+bench_backends ()
+{
+  local unit=$1 count=$2 input=$3 backend bin start end ms rc status=0
+  shift 3
+  if [[ -n $BASELINE ]] ; then
+    build_baseline $BASELINE || return 1
+    set -- "$@" baseline
+  fi
+
+  for backend in "$@" ; do
+    bin=output/$BENCH-$backend
+    if [[ $backend == baseline ]] ; then
+      (cd output/baseline && LD_LIBRARY_PATH=build/ build/opal --quiet \
+          --output=../../$bin ../../output/$BENCH.opl) || status=1
+    else
+      build/opal --quiet --backend=$backend --output=$bin \
+          output/$BENCH.opl || status=1
+    fi
+
+    start=$(date +%s%N)
+    $bin < $input > $bin.out
+    rc=$?
+    end=$(date +%s%N)
+
+    ms=$(( (end - start) / 1000000 ))
+    [[ $ms -eq 0 ]] && ms=1
+    printf "%-8s %d %s  %6d ms  %10d %s/s  exit %d\n" \
+        $backend $count $unit $ms $(( count * 1000 / ms )) $unit $rc
+    [[ $rc -ne 0 ]] && status=1
+    cmp output/$BENCH-$1.out $bin.out || status=1
+  done
+  return $status
+}
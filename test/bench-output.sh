@@ -0,0 +1,22 @@
+# Benchmark of printing $LINES numbers, one line each, by the native backend
+# and the C backend compiled by gcc -O2, both with buffered output. The
+# unbuffered native output is timed by the commit before the buffering:
+#   BASELINE=$(git log -1 --format=%h --grep='Buffer the output')^ \
+#       bash test/bench-output.sh
+
+LINES=1000000
+BENCH=bench-output
+
+export LD_LIBRARY_PATH=build/
+source test/bench-lib.sh
+
+cat > output/$BENCH.opl << EOF2
+count = 0;
+while (count < $LINES)
+{
+  print(count, "\n");
+  count = count + 1;
+}
+EOF2
+
+bench_backends lines $LINES /dev/null stack c
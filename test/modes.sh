@@ -0,0 +1,59 @@
+# Modes a program is run in by run_modes, one per line: a name, the command
+# building $BIN from $OPL, if any, and the command running the program.
+# Lines are expanded with eval, so a new mode only adds a line here.
+MODES='
+native|build/opal --quiet --output=$BIN $OPL|$BIN
+pin-vars|build/opal --quiet --pin-vars --output=$BIN $OPL|$BIN
+run||build/opal --quiet --run $OPL
+interpret||build/opal --quiet --interpret $OPL
+no-super||build/opal --quiet --interpret --no-super $OPL
+opalvm|build/genie --bytecode --output=$BIN $OPL|build/opalvm $BIN
+c|build/opal --quiet --backend=c --output=$BIN $OPL|$BIN
+'
+
+# Modes assembled by NASM, only run where it is installed
+if command -v nasm > /dev/null ; then
+  MODES+='
+nasm|build/opal --quiet --nasm --output=$BIN $OPL|$BIN
+regs|build/opal --quiet --backend=regs --output=$BIN $OPL|$BIN
+regs-pin|build/opal --quiet --backend=regs --pin-vars --output=$BIN $OPL|$BIN
+'
+fi
+
+# Run a program in every mode with the given input, each run must exit with
+# the expected status and print the expected output
+#   $1  program source
+#   $2  input file, or else a command writing the input to a pipe
+#   $3  expected output file, or /dev/full to write the output there
+#   $4  expected exit status, 0 if not given
+run_modes ()
+{
+  local OPL=$1 OUT=$3 NAME BUILD RUN BIN
+  while IFS='|' read -r NAME BUILD RUN; do
+    if [[ -z $NAME ]] ; then
+      continue
+    fi
+    BIN=output/$(basename $OPL .opl)-$NAME
+    eval "$BUILD" < /dev/null
+    if [[ $? -ne 0 ]] ; then
+      printf "%s: build failed\n" $NAME
+      return 1
+    fi
+    if [[ $3 != /dev/full ]] ; then
+      OUT=$BIN.out
+    fi
+    if [[ -e $2 ]] ; then
+      eval "$RUN" < $2 > $OUT 2> /dev/null
+    else
+      eval "$2 | $RUN" > $OUT 2> /dev/null
+    fi
+    if [[ $? -ne ${4:-0} ]] ; then
+      printf "%s: run failed\n" $NAME
+      return 1
+    fi
+    if [[ $3 != /dev/full ]] ; then
+      cmp $3 $OUT || return 1
+    fi
+  done <<< "$MODES"
+  return 0
+}
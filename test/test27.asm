@@ -2,6 +2,8 @@
 %define SYS_READ  0
 %define SYS_WRITE 1
 %define SYS_OPEN  2
+%define SYS_RT_SIGACTION  13
+%define SYS_RT_SIGRETURN  15
 %define SYS_EXIT 60
 
 ; pubs.opengroup.org/onlinepubs/9699919799/basedefs/unistd.h.html
@@ -13,10 +15,17 @@
 %define EXIT_SUCCESS 0
 %define EXIT_FAILURE 1
 
+; man7.org/linux/man-pages/man2/sigaction.2.html
+%define SIGFPE       8
+%define SA_RESTORER  0x04000000
+%define SA_RESETHAND 0x80000000
+
 ; Constants for better code readability
 %define NULL    0
 %define isTrue  1
 %define isFalse 0
+%define OUT_SIZE 65536   ; Bytes of output buffered before a write
+%define IN_SIZE  65536   ; Bytes of input read at a time
 
 ; =============================================================================
 ; Arithematic instructions
@@ -294,76 +303,7 @@
 ; -----------------------------------------------------------------------------
 %macro _INPUT_ 0
   O_PRTS                 ; Print prompt string with macro
-
-; Read digits from STDIN and store in buffer 'bss0' in a loop until newline
-  XOR R9, R9             ; R9 will hold number of characters read
-%%readi_start:
-  MOV RDX, 1             ; Read 1 character ..
-  MOV RDI, STDIN         ; .. of user input from STDIN ..
-  MOV RAX, SYS_READ      ; .. with SYS_READ system call ..
-  MOV RSI, char          ; .. and save character to memory location 'char'
-  SYSCALL                ; Call kernel
-
-  MOV AL, [char]         ; Move character read into RAX
-  CMP AL, 0ah            ; If character is newline ..
-  JE  %%readi_end        ; .. end reading user input
-
-  MOV RAX, bss0          ; RAX points to buffer used for storage
-  ADD RAX, R9            ; Increment address past current characters
-  XOR RBX, RBX
-  MOV BL, [char]         ; Copy the character to the BL register
-  MOV [EAX], BL          ; Append character to the buffer 'bss0'
-  INC R9                 ; Increment number of characters
-  JMP %%readi_start      ; Read next character from screen
-%%readi_end:
-
-; Convert digits in buffer 'bss0' to integer
-%%atoi:
-  MOV RSI, bss0          ; RSI points to string to convert
-  XOR RCX, RCX           ; RCX will hold number of digits processed so far
-  XOR RAX, RAX           ; RAX will hold converted integer, starts off as 0
-  XOR RBX, RBX           ; RBX will be used to convert ASCII to decimal
-  XOR R8, R8             ; R8 will be the flag for negative value
-
-  MOV BL, [RSI+RCX]      ; Read in the first character &'bss0+0'
-  CMP BL, 45             ; If char is not -ve sign ..
-  JNE %%isPositive       ; .. jump to label isPositive
-  MOV R8, 1d             ; .. else set negative integer flag
-  INC RCX                ; Move to second char in buffer
-  DEC R9                 ; Decrement number of digits to be processed ..
-  JMP %%atoi_loop        ; .. and convert string to integer
-
-%%isPositive:
-  XOR R8, R8             ; Clear negative integer flag
-
-%%atoi_loop:
-  XOR RBX, RBX
-  MOV BL, [ESI+ECX]      ; Read in ASCII character to convert
-
-  CMP BL, 48             ; If char ASCII value less than 0 ..
-  JL  %%atoi_end         ; .. jump to end
-  CMP BL, 57             ; If char ASCII value greater than 9 ..
-  JG  %%atoi_end         ; .. jump to end
-
-  SUB BL, 48             ; Get decimal value from ASCII
-  ADD RAX, RBX           ; Add value to RAX
-
-  DEC R9                 ; Decrement number of digits to be processed
-  CMP R9, 0              ; If no more digits to process ..
-  JE  %%atoi_end         ; .. jump to end
-
-  MOV RBX, 10            ; Multiply current value in RAX by 10
-  MUL RBX                ;
-  INC RCX                ; Increment counter used for character address
-  JMP %%atoi_loop        ; Process next digit
-
-%%atoi_end:
-  CMP R8, 1d             ; If negative integer flag is not set ..
-  JNE %%push_val         ; .. jump to label push_val ..
-  NEG RAX                ; .. else negate value
-
-; Push integer value on top of stack
-%%push_val:
+  CALL o_input           ; Read integer from the next line of input
   PUSH RAX               ; Push result integer value to top of stack
 %endmacro
 
@@ -391,6 +331,19 @@
   MOV  [data+(8*%1)],RAX ; Store in [destination] + (size) * index
 %endmacro
 
+; -----------------------------------------------------------------------------
+; Macro - _STORE_KEEP_
+; Args  - Array index
+; Pre   - Integer to store on top of stack
+; Post  - data[index] = integer at top of stack, integer stays on stack
+; Desc  - Stores integer from top of stack into array 'data' at given index
+;         without popping it, as _STORE_ followed by _FETCH_ would
+; -----------------------------------------------------------------------------
+%macro _STORE_KEEP_ 1
+  MOV  RAX,[RSP]         ; Get integer to store
+  MOV  [data+(8*%1)],RAX ; Store in [destination] + (size) * index
+%endmacro
+
 ; =============================================================================
 ; Logical instructions
 ; =============================================================================
@@ -421,6 +374,90 @@
   JNE  %1                ; If value is non-zero, jump to given label
 %endmacro
 
+; -----------------------------------------------------------------------------
+; Macro - O_JEQ
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] == stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JEQ 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JE   %1                ; If a == b, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JNEQ
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] != stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JNEQ 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JNE  %1                ; If a != b, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JLSS
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] < stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JLSS 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JL   %1                ; If a < b, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JGTR
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] > stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JGTR 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JG   %1                ; If a > b, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JLEQ
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] <= stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JLEQ 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JLE  %1                ; If a <= b, jump to given label
+%endmacro
+
+; -----------------------------------------------------------------------------
+; Macro - O_JGEQ
+; Args  - Label to jump to
+; Pre   - Operand integers on top of stack
+; Post  - None
+; Desc  - If stack[-2] >= stack[-1], jump to given label
+; -----------------------------------------------------------------------------
+%macro O_JGEQ 1
+  POP  RBX               ; Get 'b' from stack
+  POP  RAX               ; Get 'a' from stack
+  CMP  RAX, RBX          ; a ?? b
+  JGE  %1                ; If a >= b, jump to given label
+%endmacro
+
 ; =============================================================================
 ; Print instructions
 ; =============================================================================
@@ -430,7 +467,7 @@
 ; Args  - None
 ; Pre   - strs[index] to print on top of stack
 ; Post  - None
-; Desc  - Prints string at 'strs[index]' to STDOUT
+; Desc  - Prints string at 'strs[index]' to output buffer
 ; -----------------------------------------------------------------------------
 %macro O_PRTS 0
   POP  RAX               ; Get index of string to print from stack
@@ -440,13 +477,7 @@
 
   MOV  RSI, [strs+RAX]   ; Get address of string to print
   MOV  RDX, [lens+RAX]   ; Get length of string to print
-  MOV  RAX, SYS_WRITE    ; Use sys_write system call
-  MOV  RDI, STDOUT       ; Output to stdout
-  SYSCALL                ; Call kernel
-  CMP  RDX, RAX          ; If sys_write wrote expected number of bytes ..
-  JE   %%end             ; .. return from macro
-  HALT RAX               ; .. else, exit with difference as code ..
-%%end:
+  CALL o_write           ; Append string to output buffer
 %endmacro
 
 ; -----------------------------------------------------------------------------
@@ -454,20 +485,14 @@
 ; Args  - Char to print
 ; Pre   - None
 ; Post  - None
-; Desc  - Print given character to STDOUT
+; Desc  - Print given character to output buffer
 ; -----------------------------------------------------------------------------
 %macro O_PRTS 1
   PUSH %1                ; Push char on stack
-  MOV  RAX, SYS_WRITE    ; Use sys_write system call to print
-  MOV  RDI, STDOUT       ; Output to stdout
   MOV  RSI, RSP          ; Print char on stack
   MOV  RDX, 1            ; Length
-  SYSCALL                ; Call kernel
-  CMP  RAX, RDX          ; If sys_write wrote expected number of bytes ..
-  JE   %%end             ; .. return from macro
-  HALT RAX               ; .. else, exit with difference as code ..
-%%end:
-  ADD RSP, 8             ; Remove char from stack
+  CALL o_write           ; Append char to output buffer
+  ADD  RSP, 8            ; Remove char from stack
 %endmacro
 
 ; -----------------------------------------------------------------------------
@@ -475,46 +500,36 @@
 ; Args  - None
 ; Pre   - Integer to print on top of stack
 ; Post  - None
-; Desc  - Prints integer on top of stack to STDOUT
+; Desc  - Prints integer on top of stack to output buffer
 ; -----------------------------------------------------------------------------
 %macro O_PRTI 0
   POP  RAX               ; Get integer from stack
+  MOV  R8, RAX           ; Keep integer to check its sign at the end
+  SUB  RSP, 32           ; Reserve stack for the sign and up to 20 digits
+  LEA  RSI, [RSP+32]     ; Digits are stored backwards from the end
 
   CMP  RAX, 0            ; Check if number is negative
-  JGE  %%start           ; If number is positive, print number
-  PUSH RAX               ; Backup number before printing -ve sign
-  O_PRTS "-"             ; Print '-' sign using macro
-  POP  RAX               ; Restore number after printing -ve sign
+  JGE  %%loop            ; If number is positive, convert number
   NEG  RAX               ; If number is negative, get positive value
-%%start:
-  XOR  RSI, RSI          ; Zero out source index register
 %%loop:
-  XOR  RDX, RDX          ; Zero out quotient register
+  XOR  RDX, RDX          ; Zero out remainder register
   MOV  RBX, 10d          ; Keep dividing number by 10
   DIV  RBX               ; to get remainder (digit) in RDX
-  ADD  RDX, 48d          ; Add 48 to convert decimal to ASCII
-  PUSH RDX               ; Push digits on stack
-  INC  RSI               ; Increment source index register
-  MOV  RBX, RSI          ; Move number of digits to RBX, for printing
-  CMP  RAX, 0            ; If quotient is zero, all digits on stack
-  JZ   %%next            ; If all digits on stack, print them
-  JMP  %%loop            ; If quotient not zero, get next digit
-%%next:
-  CMP  RBX, 0            ; If source index (RBX) is zero, no more digits ..
-  JZ   %%exit            ; .. to add to buffer
-  MOV  RAX, SYS_WRITE    ; Use sys_write system call to print
-  MOV  RDI, STDOUT       ; Output to stdout
-  MOV  RSI, RSP          ; Print digit on stack
-  MOV  RDX, 1            ; Length 1 byte per digit
-  SYSCALL                ; Call kernel
-  CMP  RAX, 1            ; If sys_write wrote more/less bytes ..
-  JNE  %%error           ; .. exit with difference as code
-  DEC  RBX               ; Decrement source index after every digit
-  ADD  RSP, 8            ; Move to next digit
-  JMP  %%next            ; Get next char to print
-%%error:
-  HALT RAX
-%%exit:
+  ADD  DL, 48d           ; Add 48 to convert decimal to ASCII
+  DEC  RSI               ; Store digit before the previous one
+  MOV  [RSI], DL
+  CMP  RAX, 0            ; If quotient is not zero ..
+  JNZ  %%loop            ; .. get next digit
+
+  CMP  R8, 0             ; If number is negative ..
+  JGE  %%print
+  DEC  RSI               ; .. store '-' sign before the digits
+  MOV  BYTE [RSI], '-'
+%%print:
+  LEA  RDX, [RSP+32]     ; Length is from first char to end of digits
+  SUB  RDX, RSI
+  CALL o_write           ; Append sign and digits to output buffer
+  ADD  RSP, 32           ; Remove digits from stack
 %endmacro
 
 ; =============================================================================
@@ -526,9 +541,10 @@
 ; Args  - None
 ; Pre   - None
 ; Post  - None
-; Desc  - Runs SYS_EXIT system call with code - 0
+; Desc  - Writes buffered output and runs SYS_EXIT system call with code - 0
 ; -----------------------------------------------------------------------------
 %macro HALT 0
+  CALL o_flush           ; Write buffered output
   MOV  RAX, SYS_EXIT     ; Use SYS_EXIT system call to exit ..
   MOV  RDI, 0            ; .. with exit code 0
   SYSCALL
@@ -542,8 +558,8 @@
 ; Desc  - Runs SYS_EXIT system call with given code
 ; -----------------------------------------------------------------------------
 %macro HALT 1
-  MOV  RAX, SYS_EXIT     ; Use SYS_EXIT system call to exit ..
-  MOV  RDI, %1           ; .. with given argument as exit code
+  MOV  RDI, %1           ; Set given argument as exit code, before RAX is ..
+  MOV  RAX, SYS_EXIT     ; .. set to use SYS_EXIT system call to exit
   SYSCALL
 %endmacro
 
@@ -552,43 +568,194 @@
 ; =============================================================================
 
 SECTION .text
+
+; -----------------------------------------------------------------------------
+; Routine - o_flush
+; Args  - None
+; Pre   - None
+; Post  - Output buffer is empty
+; Desc  - Writes buffered output to STDOUT with one system call. Also the
+;         SIGFPE handler, so output printed before a division fault is not
+;         lost: the handler is reset when the division is retried.
+; -----------------------------------------------------------------------------
+o_flush:
+  MOV  RDX, [olen]       ; Get number of bytes buffered
+  CMP  RDX, 0            ; If buffer is empty ..
+  JE   .end              ; .. there is nothing to write
+  MOV  RAX, SYS_WRITE    ; Use sys_write system call
+  MOV  RDI, STDOUT       ; Output to stdout
+  MOV  RSI, obuf         ; Write buffered output
+  SYSCALL                ; Call kernel
+  CMP  RDX, RAX          ; If sys_write wrote expected number of bytes ..
+  JE   .empty            ; .. empty buffer
+  HALT RAX               ; .. else, exit with difference as code ..
+.empty:
+  MOV  QWORD [olen], 0   ; No bytes buffered
+.end:
+  RET
+
+; -----------------------------------------------------------------------------
+; Routine - o_write
+; Args  - RSI address and RDX length of bytes to print
+; Pre   - None
+; Post  - Bytes are buffered or written
+; Desc  - Appends bytes to output buffer, writes buffered output first if
+;         they do not fit. Bytes longer than the buffer are written directly.
+; -----------------------------------------------------------------------------
+o_write:
+  MOV  RAX, [olen]       ; If bytes fit after those buffered ..
+  ADD  RAX, RDX
+  CMP  RAX, OUT_SIZE
+  JBE  .copy             ; .. append them
+  PUSH RSI               ; .. else, write buffered output
+  PUSH RDX
+  CALL o_flush
+  POP  RDX
+  POP  RSI
+  CMP  RDX, OUT_SIZE     ; If bytes fit in the empty buffer ..
+  JBE  .copy             ; .. append them
+  MOV  RAX, SYS_WRITE    ; .. else, use sys_write system call
+  MOV  RDI, STDOUT       ; Output to stdout
+  SYSCALL                ; Call kernel
+  CMP  RDX, RAX          ; If sys_write wrote expected number of bytes ..
+  JE   .end              ; .. return
+  HALT RAX               ; .. else, exit with difference as code ..
+.copy:
+  MOV  RDI, obuf         ; Copy after bytes buffered ..
+  ADD  RDI, [olen]
+  ADD  [olen], RDX       ; .. and count bytes appended
+  MOV  RCX, RDX
+  REP  MOVSB
+.end:
+  RET
+
+; -----------------------------------------------------------------------------
+; Routine - o_getc
+; Args  - None
+; Pre   - None
+; Post  - Next input character in RAX
+; Desc  - Gets next character from the input buffer. Once the characters read
+;         are used up, writes buffered output and reads the next chunk from
+;         STDIN. A newline is returned at the end of input.
+; -----------------------------------------------------------------------------
+o_getc:
+  MOV  RSI, [ipos]       ; If characters read are left ..
+  CMP  RSI, [ilen]
+  JAE  .read
+  MOVZX EAX, BYTE [ibuf+RSI] ; .. return the next one
+  INC  RSI
+  MOV  [ipos], RSI
+  RET
+.read:
+  CALL o_flush           ; Write prompt and output so far before reading
+  MOV  RAX, SYS_READ     ; Use sys_read system call ..
+  MOV  RDI, STDIN        ; .. to read from STDIN ..
+  MOV  RSI, ibuf         ; .. into input buffer ..
+  MOV  RDX, IN_SIZE      ; .. as many characters as fit
+  SYSCALL                ; Call kernel
+  CMP  RAX, 0            ; If nothing was read, input has ended ..
+  JLE  .end
+  MOV  [ilen], RAX       ; .. else, parse characters read from the start
+  MOV  QWORD [ipos], 0
+  JMP  o_getc
+.end:
+  MOV  RAX, 0ah          ; End of input ends the line
+  RET
+
+; -----------------------------------------------------------------------------
+; Routine - o_input
+; Args  - None
+; Pre   - None
+; Post  - Integer read in RAX
+; Desc  - Converts the next line of input to integer: an optional '-' sign,
+;         then the digits up to the first other character. The rest of the
+;         line is skipped.
+; -----------------------------------------------------------------------------
+o_input:
+  XOR  RBX, RBX          ; RBX will hold converted integer, starts off as 0
+  XOR  R8, R8            ; R8 will be the flag for negative value
+  CALL o_getc            ; Read in the first character
+  CMP  RAX, 45           ; If char is not -ve sign ..
+  JNE  .digit            ; .. convert it
+  MOV  R8, 1d            ; .. else set negative integer flag
+.next:
+  CALL o_getc            ; Read in next character
+.digit:
+  SUB  EAX, 48           ; Get decimal value from ASCII
+  CMP  EAX, 9            ; If it is not a digit (unsigned) ..
+  JA   .skip             ; .. conversion ends
+  LEA  RBX, [RBX+RBX*4]  ; integer = integer * 10 + digit
+  LEA  RBX, [RAX+RBX*2]
+  JMP  .next
+.skip:
+  ADD  EAX, 48           ; Skip rest of the line
+.line:
+  CMP  EAX, 0ah
+  JE   .sign
+  CALL o_getc
+  JMP  .line
+.sign:
+  MOV  RAX, RBX          ; Return integer ..
+  CMP  R8, 1d            ; .. negated if negative integer flag is set
+  JNE  .end
+  NEG  RAX
+.end:
+  RET
+
+; -----------------------------------------------------------------------------
+; Routine - o_restore
+; Args  - None
+; Pre   - Signal handler returned
+; Post  - Registers of the interrupted code are restored
+; Desc  - Runs SYS_RT_SIGRETURN system call, restorer of the SIGFPE handler
+; -----------------------------------------------------------------------------
+o_restore:
+  MOV  RAX, SYS_RT_SIGRETURN
+  SYSCALL
+
 global _start
   _start:
 
+  MOV  RAX, SYS_RT_SIGACTION ; Use rt_sigaction system call ..
+  MOV  RDI, SIGFPE       ; .. to write buffered output on division fault
+  MOV  RSI, fpe_act
+  XOR  RDX, RDX          ; Old action is not needed
+  MOV  R10, 8            ; Size of signal mask
+  SYSCALL
+
   NOP
   ;=== User code start ===;
   PUSH	1
-  _STORE_	0
-_if_2:
-  _FETCH_	0
+  _STORE_KEEP_	0
   PUSH	5
-  O_LSS
-  O_JZ		_else_2
+  O_JGEQ		_else_2
   PUSH	0
   O_PRTS
   JMP		_fi_2
 _else_2:
-_if_11:
   _FETCH_	0
   PUSH	5
-  O_EQ
-  O_JZ		_else_11
+  O_JNEQ		_else_10
   PUSH	1
   O_PRTS
-  JMP		_fi_11
-_else_11:
+  JMP		_fi_10
+_else_10:
   PUSH	2
   O_PRTS
-_fi_11:
+_fi_10:
 _fi_2:
   HALT
   ;=== User code end ===;
 
 SECTION .bss
-  bss0 RESB 255          ; reserve 255 bytes for user input
+  olen RESQ 1            ; Number of bytes in output buffer
+  obuf RESB OUT_SIZE     ; Output buffer
+  ipos RESQ 1            ; Next character of input buffer to parse
+  ilen RESQ 1            ; Number of characters in input buffer
+  ibuf RESB IN_SIZE      ; Input buffer
 
 SECTION .data
-  char  DB 0             ; Used for user input
+  fpe_act DQ o_flush, SA_RESTORER | SA_RESETHAND, o_restore, 0 ; SIGFPE action
 
   ;=== User variables ===;
   ; === Strings ===;
@@ -0,0 +1,18 @@
+printf "build/astro --output=output/test34.ast output/test34.opl\n";
+
+# Program of 200000 statements, a left-deep statement chain used to overflow
+# the stack
+{
+  printf "a = 0;\n"
+  for ((i = 0; i < 200000; i++)) ; do
+    printf "a = a + 1;\n"
+  done
+  printf "print(a, \"\\\\n\");\n"
+} > output/test34.opl
+
+export LD_LIBRARY_PATH=build/
+build/astro --output=output/test34.ast output/test34.opl
+if [[ $? -ne 0 ]] ; then
+  exit 1
+fi
+exit 0
@@ -0,0 +1,23 @@
+printf "build/genie --output=output/test35.asm output/test35.opl\n";
+
+# Program of 350000 statements emitting more than 2000000 instructions, far
+# beyond the old fixed size GENIE tables
+{
+  printf "a = 0;\n"
+  for ((i = 0; i < 350000; i++)) ; do
+    printf "a = a + 1 + 2;\n"
+  done
+  printf "print(a, \"\\\\n\");\n"
+} > output/test35.opl
+
+export LD_LIBRARY_PATH=build/
+build/genie --output=output/test35.asm output/test35.opl
+if [[ $? -ne 0 ]] ; then
+  exit 1
+fi
+
+# Every statement adds twice
+if [[ $(grep -c "^  O_ADD$" output/test35.asm) -ne 700000 ]] ; then
+  exit 1
+fi
+exit 0
@@ -0,0 +1,9 @@
+printf "run_modes input/calc.opl test/test42.in test/test42.out\n";
+
+# Calculator session through every operation, run in every mode of
+# test/modes.sh: native binaries written by the built-in encoder, in memory,
+# interpreted, from a bytecode file and compiled from C
+export LD_LIBRARY_PATH=build/
+source test/modes.sh
+run_modes input/calc.opl test/test42.in test/test42.out || exit 1
+exit 0
@@ -0,0 +1,26 @@
+printf "build/opal --run input/calc.opl\n";
+
+# Same calculator session as Test 42, run in memory and interpreted without
+# writing an executable
+export LD_LIBRARY_PATH=build/
+for MODE in --run --interpret; do
+  rm -f output/test43.bin
+  ls -l --full-time tmp/ > output/test43.tmp
+  touch output/test43.stamp
+  build/opal --quiet $MODE --output=output/test43.bin input/calc.opl \
+      < test/test42.in > output/test43.out
+  if [[ $? -ne 0 ]] ; then
+    exit 1
+  fi
+  cmp test/test42.out output/test43.out || exit 1
+
+  # Nothing is written besides the log: no executable, temp files or report
+  if [[ -e output/test43.bin ]] ; then
+    exit 1
+  fi
+  ls -l --full-time tmp/ | cmp output/test43.tmp - || exit 1
+  if [[ -n $(find tmp/ report/ -newer output/test43.stamp) ]] ; then
+    exit 1
+  fi
+done
+exit 0
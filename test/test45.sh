@@ -0,0 +1,30 @@
+printf "build/opalvm output/test45.bad.opb\n";
+
+# opalvm refuses files that are not bytecode, running them is tested in the
+# modes of Test 42
+export LD_LIBRARY_PATH=build/
+build/genie --bytecode --output=output/test45.opb input/calc.opl
+if [[ $? -ne 0 ]] ; then
+  exit 1
+fi
+
+# Files that are not bytecode are refused
+build/opalvm input/calc.opl 2> /dev/null
+if [[ $? -eq 0 ]] ; then
+  exit 1
+fi
+
+# Corrupted code is refused before it runs: an unknown last opcode, a last
+# opcode without its operand, and no variables or stack in the header
+SIZE=$(stat -c %s output/test45.opb)
+for PATCH in "\xff@$((SIZE - 1))" "\x01@$((SIZE - 1))" "\0\0\0\0@32" \
+             "\0\0\0\0@36"; do
+  cp output/test45.opb output/test45.bad.opb
+  printf "${PATCH%@*}" | dd of=output/test45.bad.opb bs=1 seek=${PATCH#*@} \
+      conv=notrunc 2> /dev/null
+  build/opalvm output/test45.bad.opb < /dev/null 2> /dev/null
+  if [[ $? -ne 1 ]] ; then
+    exit 1
+  fi
+done
+exit 0
@@ -0,0 +1,28 @@
+printf "run_modes input/test48.opl output/test48.txt test/test48.out\n";
+
+# Lines the input buffer must convert alike in every mode: signs, text
+# after the digits, empty lines, a line longer than the buffer and numbers
+# not ending in a newline, read from a file in one chunk
+export LD_LIBRARY_PATH=build/
+{
+  printf -- "12\n-34\n56abc\n\n-\n 7\n18446744073709551617\n"
+  head -c 70000 /dev/zero | tr '\0' '9'
+  printf "\n-9"
+} > output/test48.txt
+
+source test/modes.sh
+run_modes input/test48.opl output/test48.txt test/test48.out || exit 1
+
+# The same lines from a pipe, the short lines in pieces of 5 bytes read one
+# at a time, so signs and numbers are split between reads
+feed ()
+{
+  local AT
+  for AT in $(seq 0 5 60); do
+    tail -c +$((AT + 1)) output/test48.txt | head -c 5
+    sleep 0.01
+  done
+  tail -c +66 output/test48.txt
+}
+run_modes input/test48.opl feed test/test48.out || exit 1
+exit 0
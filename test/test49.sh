@@ -0,0 +1,10 @@
+printf "run_modes input/test49.opl /dev/null test/test49.out 136\n";
+
+# Programs end alike in every mode when they fail: a division fault raises
+# SIGFPE after the buffered output is written, and a failed write exits with
+# the negated errno, ENOSPC for /dev/full
+export LD_LIBRARY_PATH=build/
+source test/modes.sh
+run_modes input/test49.opl /dev/null test/test49.out 136 || exit 1
+run_modes input/calc.opl test/test42.in /dev/full 228 || exit 1
+exit 0